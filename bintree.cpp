@@ -6,41 +6,222 @@
  *              523-529, 559-563. Boston, MA: Pearson Education, Inc.
  * @brief   This class represents a binary search tree which holds its data in
  *          a NodeData object, to which it keeps a pointer. NodeData must
- *          support ==, <, and << operators. Some specialized methods are
- *          provided for displaying the contents of the tree. There is no
- *          method for removing a single item, so the tree must be emptied to
- *          remove anything.
+ *          support compare(), ==, and <<. Some specialized methods are
+ *          provided for displaying the contents of the tree. Items may be
+ *          removed singly, or in bulk by a predicate. A tree may be
+ *          constructed in BALANCED mode, in which case it is kept height
+ *          balanced (AVL) on every insert and removal, in POOLED mode, in
+ *          which case its nodes are carved from a NodePool, in INLINE mode,
+ *          in which case each key is stored in its node, in SHARED mode, in
+ *          which case copies share nodes until changed, in PARALLEL mode, in
+ *          which case bulk operations use threads, in LAZY mode, in which
+ *          case removed items are marked and compacted later, and in CACHED
+ *          mode, in which case recently found items are found again at once.
+ *          A tree that is mostly read may be frozen, which packs its items
+ *          into one contiguous array that is searched without branching.
  * @author  Brendan Sweeney, SID 1161836
  * @date    January 21, 2012
  */
 
+#include <algorithm>        // for sort
+#include <cmath>            // for log2
 #include <cstddef>          // definition of NULL
+#include <cstdio>           // for fopen and fwrite
+#include <cstring>          // for memcpy and memset
+#include <memory>           // for shared_ptr
 #include <new>              // for bad_alloc
+#include <utility>          // for pair
+#include <vector>           // explicit stacks for traversals
 
 #include "bintree.h"
+#include "snapshot.h"
+#include "taskpool.h"
+
+// adds to a counter reported by getStats(); compiled away unless wanted
+#ifdef BINTREE_STATS
+#define BINTREE_COUNT(counter, amount) \
+    counters.counter.fetch_add((amount), std::memory_order_relaxed)
+#else
+#define BINTREE_COUNT(counter, amount) ((void) sizeof(amount))
+#endif
 
 using namespace std;
 
+/**---------------------- precedes() ------------------------------------------
+ * Orders pointers to NodeData by the items they point to, for sorting.
+ * @param lhs  The left-hand item to be compared.
+ * @param rhs  The right-hand item to be compared.
+ * @pre Neither pointer is NULL.
+ * @post Both items remain unchanged.
+ * @return true if *lhs is less than *rhs; false, otherwise.
+ */
+static bool precedes(const NodeData *lhs, const NodeData *rhs)
+{
+    return lhs->compare(*rhs) < 0;
+} // end precedes(NodeData*, NodeData*)
+
+/**---------------------- mixHash() -------------------------------------------
+ * Combines a hash into a running hash, so that the order of combination
+ * affects the result.
+ * @param seed  The running hash.
+ * @param value  The hash to be combined into seed.
+ * @pre None.
+ * @post None.
+ * @return The combined hash.
+ */
+static size_t mixHash(size_t seed, size_t value)
+{
+    return seed ^ (value + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+} // end mixHash(size_t, size_t)
+
+/**---------------------- prefetch() ------------------------------------------
+ * Asks for the cache line holding an object to be loaded, without waiting
+ * for it. Compilers without a prefetch builtin do nothing.
+ * @param address  The object that will soon be read; may be NULL.
+ * @pre None.
+ * @post None.
+ */
+static inline void prefetch(const void *address)
+{
+#if defined(__GNUC__)
+    __builtin_prefetch(address);
+#else
+    (void)address;
+#endif
+} // end prefetch(void*)
+
+/**---------------------- isStrictlySorted() ----------------------------------
+ * Determines whether an array of NodeData* is in strictly ascending order.
+ * @param items[]  The array to check.
+ * @param count  The number of elements in items[].
+ * @pre No element of items[] is NULL.
+ * @post items[] remains unchanged.
+ * @return true if every item is less than the one after it; false, otherwise.
+ */
+static bool isStrictlySorted(const NodeData *const items[], int count)
+{
+    bool sorted = true;
+
+    for (int i = 1; i < count && sorted; ++i)
+    {
+        sorted = items[i - 1]->compare(*items[i]) < 0;
+    } // end for (int i = 1)
+
+    return sorted;
+} // end isStrictlySorted(NodeData*[], int)
+
+/**---------------------- firstIndex() ----------------------------------------
+ * Finds the position of the smallest item in an array laid out in Eytzinger
+ * order, with the root at index 1 and the children of index k at 2k and
+ * 2k + 1.
+ * @param count  The number of items in the array.
+ * @pre None.
+ * @post None.
+ * @return The index of the leftmost position; greater than count if count is
+ *         0.
+ */
+static size_t firstIndex(size_t count)
+{
+    size_t index = 1;
+
+    while (2 * index <= count)      // keep going left
+    {
+        index *= 2;
+    } // end while (2 * index <= count)
+
+    return index;
+} // end firstIndex(size_t)
+
+/**---------------------- nextIndex() -----------------------------------------
+ * Finds the position of the in-order successor of an item in an array laid
+ * out in Eytzinger order: the leftmost position of its right subtree, if it
+ * has one, or else the nearest ancestor it is to the left of.
+ * @param index  The position of the item.
+ * @param count  The number of items in the array.
+ * @pre 1 <= index <= count.
+ * @post None.
+ * @return The index of the successor; 0 if index holds the largest item.
+ */
+static size_t nextIndex(size_t index, size_t count)
+{
+    if (2 * index + 1 <= count)     // right subtree exists; go to its leftmost
+    {
+        index = 2 * index + 1;
+
+        while (2 * index <= count)
+        {
+            index *= 2;
+        } // end while (2 * index <= count)
+    }
+    else                            // climb out of every right turn, once more
+    {
+        while (index & 1)
+        {
+            index >>= 1;
+        } // end while (index & 1)
+
+        index >>= 1;
+    } // end if (2 * index + 1 <= count)
+
+    return index;
+} // end nextIndex(size_t, size_t)
+
 
 /**---------------------- Default Constructor ---------------------------------
  * Creates an empty tree.
  * @pre None.
- * @post An empty binary search tree exists.
+ * @post An empty, unbalanced binary search tree exists.
  */
-BinTree::BinTree() : root(NULL)
+BinTree::BinTree()
+    : root(NULL), options(PLAIN), pool(NULL), nodeCount(0), deadCount(0),
+      rebalanceFactor(0), frozen(), indexed(false), cache(NULL)
 {
 } // end default constructor
 
+/**---------------------- Option Constructor ----------------------------------
+ * Creates an empty tree which behaves according to the provided options.
+ * @param options  A bitwise or of Option values.
+ * @pre None.
+ * @post An empty binary search tree exists; if options includes BALANCED, the
+ *       tree will remain height balanced as items are inserted; if options
+ *       includes POOLED but not SHARED, the tree has its own NodePool.
+ */
+BinTree::BinTree(int options)
+    : root(NULL), options(PLAIN), pool(NULL), nodeCount(0), deadCount(0),
+      rebalanceFactor(0), frozen(), indexed(false), cache(NULL)
+{
+    setOptions(options);
+} // end constructor(int)
+
 /**---------------------- Copy Constructor ------------------------------------
- * Copies the tree orig into a new tree.
+ * Copies the tree orig into a new tree. If orig is SHARED, the new tree shares
+ * its nodes, so the copy takes constant time and memory.
  * @param orig  The tree to be copied.
  * @pre There is sufficient memory to allocate a copy of orig.
  * @post A binary search tree exists that is a structural copy of the tree
  *       orig; orig remains unchanged.
  */
 BinTree::BinTree(const BinTree& orig)
+    : root(NULL), options(PLAIN), pool(NULL), nodeCount(0), deadCount(0),
+      rebalanceFactor(0), frozen(), indexed(false), cache(NULL)
 {
-    copyTree(orig.root, root);
+    setOptions(orig.options);
+    rebalanceFactor = orig.rebalanceFactor;
+
+    if ((options & SHARED) && orig.root != NULL)
+    {
+        root = orig.root;       // nodes are copied only once changed
+        ++root->refs;
+        nodeCount = orig.nodeCount;
+        deadCount = orig.deadCount;
+        frozen = orig.frozen;   // shared nodes may hold packed keys
+        indexed = orig.indexed;
+    }
+    else
+    {
+        nodeCount = forkCopy(orig.root, root, forkLevels());
+        deadCount = orig.deadCount;
+    } // end if ((options & SHARED) && orig.root != NULL)
 } // end copy constructor
 
 /**---------------------- Destructor ------------------------------------------
@@ -52,6 +233,8 @@ BinTree::BinTree(const BinTree& orig)
 BinTree::~BinTree()
 {
     makeEmpty();
+    delete pool;
+    delete [] cache;
 } // end destructor
 
 /**---------------------- isEmpty() -------------------------------------------
@@ -66,41 +249,522 @@ bool BinTree::isEmpty(void) const
 } // end isEmpty()
 
 /**---------------------- makeEmpty() -----------------------------------------
- * Deallocates memory for a tree.
+ * Deallocates memory for a tree. In a POOLED tree, the blocks holding the
+ * nodes are released together once the data they hold is destroyed.
  * @pre None.
  * @post This tree is now empty; all NodeData objects to which this tree held
  *       pointers are deleted.
  */
 void BinTree::makeEmpty(void)
 {
-    destroyTree(root);
+    forkDestroy(root, (options & SHARED) ? 0 : forkLevels());
+    nodeCount = 0;
+    deadCount = 0;
+    frozen.reset();             // no node refers to the packed keys now
+    indexed = false;
+    forgetCached();
+
+    if (pool != NULL)
+    {
+        pool->clear();          // every slot was just released
+    } // end if (pool != NULL)
 } // end makeEmpty()
 
+/**---------------------- setOptions() ----------------------------------------
+ * Changes the options of an empty tree, creating or releasing its pool and
+ * its cache.
+ * @param newOptions  A bitwise or of Option values.
+ * @pre This tree is empty.
+ * @post This tree behaves according to newOptions; pool is not NULL if and
+ *       only if newOptions includes POOLED but not SHARED, and cache is not
+ *       NULL if and only if newOptions includes CACHED.
+ * @throw bad_alloc if memory could not be allocated.
+ */
+void BinTree::setOptions(int newOptions)
+{
+    if (pool != NULL && newOptions != options)
+    {
+        delete pool;            // slot size may no longer suit the nodes
+        pool = NULL;
+    } // end if (pool != NULL && newOptions != options)
+
+    options = newOptions;
+
+    // shared nodes may outlive this tree, so they never come from its pool
+    if ((options & POOLED) && !(options & SHARED) && pool == NULL)
+    {
+        // one slot size serves nodes and, unless INLINE, copied data objects
+        size_t slotSize = (options & INLINE) ? sizeof(InlineNode)
+                                             : sizeof(Node);
+
+        if (slotSize < sizeof(NodeData))
+        {
+            slotSize = sizeof(NodeData);
+        } // end if (slotSize < sizeof(NodeData))
+
+        pool = new NodePool(slotSize);
+    } // end if ((options & POOLED) && !(options & SHARED) && ...)
+
+    if (!(options & CACHED) && cache != NULL)
+    {
+        delete [] cache;
+        cache = NULL;
+    }
+    else if ((options & CACHED) && cache == NULL)
+    {
+        cache = new std::atomic<NodeData*>[CACHE_SLOTS];
+        forgetCached();         // atomics start out indeterminate
+    } // end if (!(options & CACHED) && cache != NULL)
+} // end setOptions(int)
+
+/**---------------------- forgetCached() --------------------------------------
+ * Empties the cache of a CACHED tree, before its items are moved or freed, or
+ * before nodes it shares with other trees are given up.
+ * @pre None.
+ * @post No item is found through the cache until it is found again.
+ */
+void BinTree::forgetCached(void)
+{
+    if (cache != NULL)
+    {
+        for (int i = 0; i < CACHE_SLOTS; ++i)
+        {
+            cache[i].store(NULL, memory_order_relaxed);
+        } // end for (int i = 0)
+    } // end if (cache != NULL)
+} // end forgetCached()
+
+/**---------------------- forgetCached() --------------------------------------
+ * Empties the cache slot of an item of a CACHED tree, before it is removed.
+ * @param oldItem  An object equal to the item that is leaving the tree.
+ * @pre None.
+ * @post No item equal to oldItem is found through the cache.
+ */
+void BinTree::forgetCached(const NodeData& oldItem)
+{
+    if (cache != NULL)
+    {
+        cache[oldItem.hash() & (CACHE_SLOTS - 1)].store(NULL,
+                                                        memory_order_relaxed);
+    } // end if (cache != NULL)
+} // end forgetCached(NodeData&)
+
+/**---------------------- newNode() -------------------------------------------
+ * Allocates a leaf node, from the pool of this tree if it has one.
+ * @param item  The data object to be held by the new node.
+ * @param where  Where item was allocated.
+ * @pre None.
+ * @post A new leaf node holding item exists.
+ * @return A pointer to the new node.
+ * @throw bad_alloc if memory could not be allocated.
+ */
+BinTree::Node *BinTree::newNode(NodeData *item, DataStore where) const
+{
+    Node *treePtr;
+
+    if (pool != NULL)
+    {
+        treePtr = new (pool->allocate()) Node(item, where);
+    }
+    else
+    {
+        treePtr = new Node(item, where);
+    } // end if (pool != NULL)
+
+    return treePtr;
+} // end newNode(NodeData*, DataStore)
+
+/**---------------------- makeLeaf() ------------------------------------------
+ * Allocates a leaf node holding the value of item, stored as the options of
+ * this tree dictate. If owned is not NULL, it is a heap object equal to item
+ * that this tree may keep or move from; otherwise, if movable is not NULL,
+ * its value may be moved into the node; otherwise, item must be copied.
+ * @param item  The value to be held by the new node.
+ * @param owned  A heap object with the value of item, or NULL.
+ * @param movable  An object with the value of item that may be left empty,
+ *        or NULL.
+ * @pre If owned or movable is not NULL, it is item itself or equal to it.
+ * @post A new leaf node holding the value of item, and its hash, exists; if
+ *       owned was not kept by the node, it is deleted.
+ * @return A pointer to the new node.
+ * @throw bad_alloc if memory could not be allocated; owned is not deleted.
+ */
+BinTree::Node *BinTree::makeLeaf(const NodeData& item,
+                                 NodeData *owned, NodeData *movable) const
+{
+    Node *treePtr;
+
+    if (owned != NULL && !(options & INLINE))   // keep the caller's object
+    {
+        treePtr = newNode(owned, HEAP_DATA);
+    }
+    else if (options & INLINE)  // key goes in the node itself
+    {
+        NodeData *source = (owned != NULL ? owned : movable);
+
+        if (pool != NULL && source != NULL)
+        {
+            treePtr = new (pool->allocate()) InlineNode(std::move(*source));
+        }
+        else if (pool != NULL)
+        {
+            treePtr = new (pool->allocate()) InlineNode(item);
+        }
+        else if (source != NULL)
+        {
+            treePtr = new InlineNode(std::move(*source));
+        }
+        else
+        {
+            treePtr = new InlineNode(item);
+        } // end if (pool != NULL && source != NULL)
+
+        delete owned;           // value was moved into the node
+    }
+    else
+    {
+        DataStore where;
+        NodeData *copy = (movable != NULL ? moveData(*movable, where)
+                                          : copyData(item, where));
+
+        treePtr = newNode(copy, where);
+    } // end if (owned != NULL && !(options & INLINE))
+
+    treePtr->itemHash = treePtr->data->hash();  // never taken again
+    BINTREE_COUNT(allocations, 1);
+    return treePtr;
+} // end makeLeaf(NodeData&, NodeData*, NodeData*)
+
+/**---------------------- freeNode() ------------------------------------------
+ * Destroys the data object held by a node, if any, then deallocates the node
+ * itself, each in the way it was allocated. The data in an InlineNode is
+ * destroyed with its node, even if it was detached.
+ * @param treePtr  The node to deallocate; its children are not affected.
+ * @pre treePtr is not NULL and was allocated by newNode().
+ * @post treePtr and its data are deallocated.
+ */
+void BinTree::freeNode(Node *treePtr)
+{
+    releaseData(treePtr);
+
+    // every node of an INLINE tree is an InlineNode, even once frozen
+    if (options & INLINE)
+    {
+        InlineNode *full = static_cast<InlineNode*>(treePtr);
+
+        if (pool != NULL)
+        {
+            full->~InlineNode();
+            pool->release(full);
+        }
+        else
+        {
+            delete full;
+        } // end if (pool != NULL)
+    }
+    else
+    {
+        if (pool != NULL)
+        {
+            treePtr->~Node();
+            pool->release(treePtr);
+        }
+        else
+        {
+            delete treePtr;
+        } // end if (pool != NULL)
+    } // end if (options & INLINE)
+} // end freeNode(Node*)
+
+/**---------------------- releaseData() ---------------------------------------
+ * Destroys the data object held by a node in the way it was allocated, unless
+ * it is stored in the node or in the array packed by freeze().
+ * @param treePtr  The node whose data is to be released.
+ * @pre treePtr is not NULL.
+ * @post The data of treePtr is destroyed if it was separately allocated; the
+ *       data pointer of treePtr is unchanged.
+ */
+void BinTree::releaseData(Node *treePtr)
+{
+    if (treePtr->data != NULL && treePtr->store == POOL_DATA)
+    {
+        treePtr->data->~NodeData();
+        pool->release(treePtr->data);
+    }
+    else if (treePtr->store == HEAP_DATA)
+    {
+        delete treePtr->data;           // deleting NULL is harmless
+    } // end if (treePtr->data != NULL && ...)
+} // end releaseData(Node*)
+
+/**---------------------- copyData() ------------------------------------------
+ * Allocates a copy of a data object, from the pool of this tree if it has
+ * one, and reports where it was allocated.
+ * @param item  The data object to be copied.
+ * @param where  A container for where the copy was allocated.
+ * @pre None.
+ * @post A copy of item exists.
+ * @return A pointer to the copy.
+ * @throw bad_alloc if memory could not be allocated.
+ */
+NodeData *BinTree::copyData(const NodeData& item, DataStore& where) const
+{
+    NodeData *copy;
+
+    if (pool != NULL)
+    {
+        copy = new (pool->allocate()) NodeData(item);
+        where = POOL_DATA;
+    }
+    else
+    {
+        copy = new NodeData(item);
+        where = HEAP_DATA;
+    } // end if (pool != NULL)
+
+    return copy;
+} // end copyData(NodeData&, DataStore&)
+
+/**---------------------- moveData() ------------------------------------------
+ * Allocates a data object, from the pool of this tree if it has one, taking
+ * the value of item, and reports where it was allocated.
+ * @param item  The data object whose value is to be moved.
+ * @param where  A container for where the new object was allocated.
+ * @pre None.
+ * @post A data object with the former value of item exists; item is empty.
+ * @return A pointer to the new object.
+ * @throw bad_alloc if memory could not be allocated; item is unchanged.
+ */
+NodeData *BinTree::moveData(NodeData& item, DataStore& where) const
+{
+    NodeData *moved;
+
+    if (pool != NULL)
+    {
+        moved = new (pool->allocate()) NodeData(std::move(item));
+        where = POOL_DATA;
+    }
+    else
+    {
+        moved = new NodeData(std::move(item));
+        where = HEAP_DATA;
+    } // end if (pool != NULL)
+
+    return moved;
+} // end moveData(NodeData&, DataStore&)
+
+/**---------------------- detachData() ----------------------------------------
+ * Removes the data object from a node and hands it over as a heap object that
+ * the caller may delete.
+ * @param treePtr  The node whose data is to be detached.
+ * @pre treePtr is not NULL and holds data.
+ * @post The data pointer of treePtr is NULL.
+ * @return A pointer to the data, allocated with new.
+ */
+NodeData *BinTree::detachData(Node *treePtr)
+{
+    NodeData *item = treePtr->data;
+
+    if (treePtr->store == POOL_DATA)    // caller cannot delete a pool slot
+    {
+        item = new NodeData(*treePtr->data);
+        treePtr->data->~NodeData();
+        pool->release(treePtr->data);
+        treePtr->store = HEAP_DATA;
+    }
+    else if (treePtr->store == INLINE_DATA)     // value stays in the node
+    {
+        item = new NodeData(*treePtr->data);
+    }
+    else if (treePtr->store == FROZEN_DATA)     // array is freed later
+    {
+        item = new NodeData(std::move(*treePtr->data));
+    } // end if (treePtr->store == POOL_DATA)
+
+    treePtr->data = NULL;
+    return item;
+} // end detachData(Node*)
+
+/**---------------------- unshare() -------------------------------------------
+ * Gives a SHARED tree its own copy of a node that other trees or nodes also
+ * link to. The copy links to the same children, which gain a reference.
+ * @param treePtr  The link to the node that is to be changed.
+ * @pre treePtr is not NULL; the node holding the link, if any, belongs to
+ *      this tree alone.
+ * @post treePtr points to a node that belongs to this tree alone and holds
+ *       the same value, children, and height as before.
+ * @throw bad_alloc if memory could not be allocated; the tree is unchanged.
+ */
+void BinTree::unshare(Node *& treePtr)
+{
+    if (treePtr->refs > 1)
+    {
+        Node *copy = makeLeaf(*treePtr->data, NULL, NULL);
+
+        copy->left = treePtr->left;
+        copy->right = treePtr->right;
+        copy->height = treePtr->height;
+        copy->hash = treePtr->hash;
+        copy->dead = treePtr->dead;
+        copy->count = treePtr->count;
+
+        if (copy->left != NULL)
+        {
+            ++copy->left->refs;
+        } // end if (copy->left != NULL)
+
+        if (copy->right != NULL)
+        {
+            ++copy->right->refs;
+        } // end if (copy->right != NULL)
+
+        --treePtr->refs;            // other trees keep the original
+        treePtr = copy;
+    } // end if (treePtr->refs > 1)
+} // end unshare(Node*&)
+
+/**---------------------- unshareAll() ----------------------------------------
+ * Gives a SHARED tree its own copy of every node that is still shared, from
+ * the root down, so that it may be restructured in place.
+ * @param treePtr  Pointer to the root of the tree to be unshared.
+ * @pre treePtr is NULL or links to a node held by this tree.
+ * @post No node of the tree is linked to from another tree.
+ * @throw bad_alloc if memory could not be allocated; the tree holds the same
+ *        items as before.
+ */
+void BinTree::unshareAll(Node *& treePtr)
+{
+    vector<Node**> pending;         // links whose nodes may still be shared
+
+    forgetCached();                 // other trees may free the nodes given up
+
+    if (treePtr != NULL)
+    {
+        pending.push_back(&treePtr);
+    } // end if (treePtr != NULL)
+
+    while (!pending.empty())
+    {
+        Node **link = pending.back();
+
+        pending.pop_back();
+        unshare(*link);             // a copy makes its children shared
+
+        if ((*link)->left != NULL)
+        {
+            pending.push_back(&(*link)->left);
+        } // end if ((*link)->left != NULL)
+
+        if ((*link)->right != NULL)
+        {
+            pending.push_back(&(*link)->right);
+        } // end if ((*link)->right != NULL)
+    } // end while (!pending.empty())
+} // end unshareAll(Node*&)
+
+/**---------------------- unsharePath() ---------------------------------------
+ * Gives a SHARED tree its own copy of every node on a search path, from the
+ * root down, and updates the recorded links to point into the copies. Only
+ * these nodes are changed by an insert: AVL rotations after an insert touch
+ * nodes on the path and the new leaf alone.
+ * @param path[]  The links followed from the root, the first being the root.
+ * @param length  The number of links in path[].
+ * @param link  The link at the end of the path, below the last node.
+ * @pre path[] and link were recorded by a search of this tree.
+ * @post Every node on the path belongs to this tree alone; path[] and link
+ *       refer to the same positions within the tree as before.
+ * @throw bad_alloc if memory could not be allocated; the tree holds the same
+ *        items as before.
+ */
+void BinTree::unsharePath(Node **path[], int length, Node **& link)
+{
+    forgetCached();                 // other trees may free the nodes given up
+
+    for (int i = 0; i < length; ++i)
+    {
+        Node **&next = (i + 1 < length ? path[i + 1] : link);
+        bool    wentLeft = (next == &(*path[i])->left);
+
+        unshare(*path[i]);          // children of a copy are shared
+        next = (wentLeft ? &(*path[i])->left : &(*path[i])->right);
+    } // end for (int i = 0)
+} // end unsharePath(Node**[], int, Node**&)
+
 /**---------------------- destroyTree() ---------------------------------------
- * Deallocates memory for a tree.
+ * Deallocates memory for a tree. Left children are rotated up until the
+ * current node has none, at which point it is freed and its right child
+ * becomes current, so no stack is needed for a tree of any shape. In a SHARED
+ * tree, each node loses one reference instead, and only nodes left with none
+ * are freed, their children being released in turn from an explicit stack.
  * @param treePtr  Pointer to the root of the tree to be deallocated.
  * @pre None.
  * @post treePtr points to an empty tree.
  */
 void BinTree::destroyTree(Node *& treePtr)
 {
-    // postorder traversal
-    if (treePtr != NULL)        // base case check
+    Node *current = treePtr;
+
+    if (options & SHARED)
     {
-        destroyTree(treePtr->left);
-        destroyTree(treePtr->right);
-        if (treePtr->data != NULL)
-            delete treePtr->data;
-        treePtr->data = NULL;
-        delete treePtr;
-        treePtr = NULL;
-    } // end if (treePtr != NULL)
+        vector<Node*> pending;      // nodes that have lost a reference
+
+        while (current != NULL)
+        {
+            if (--current->refs == 0)   // no other tree links here; free
+            {
+                if (current->left != NULL)
+                {
+                    pending.push_back(current->left);
+                } // end if (current->left != NULL)
+
+                if (current->right != NULL)
+                {
+                    pending.push_back(current->right);
+                } // end if (current->right != NULL)
+
+                freeNode(current);
+            } // end if (--current->refs == 0)
+
+            current = NULL;
+
+            if (!pending.empty())
+            {
+                current = pending.back();
+                pending.pop_back();
+            } // end if (!pending.empty())
+        } // end while (current != NULL)
+    }
+    else
+    {
+        while (current != NULL)
+        {
+            if (current->left != NULL)      // rotate left child up
+            {
+                Node *pivot = current->left;
+
+                current->left = pivot->right;
+                pivot->right = current;
+                current = pivot;
+            }
+            else                            // nothing smaller remains; free
+            {
+                Node *next = current->right;
+
+                freeNode(current);
+                current = next;
+            } // end if (current->left != NULL)
+        } // end while (current != NULL)
+    } // end if (options & SHARED)
+
+    treePtr = NULL;
 } // end destroyTree(Node*&)
 
 /**---------------------- = Assignment Operator -------------------------------
  * Copies the contents of rhs into this tree. Any contents of this tree are
  * removed beforehand. Once copied, this tree will hold pointers to the same
  * objects as rhs, so emptying one tree will cause data loss in the other.
+ * Since the copy is structural, this tree also takes on the options of rhs.
+ * If rhs is SHARED, this tree shares its nodes instead of copying them.
  * @param rhs  The right-hand tree to be copied.
  * @pre There is sufficient memory to allocate a copy of rhs.
  * @post This tree is a structural copy of rhs; rhs remains unchanged.
@@ -110,51 +774,94 @@ BinTree& BinTree::operator=(const BinTree& rhs)
 {
     if (this != &rhs)
     {
-        destroyTree(root);          // deallocate left-hand side
-        copyTree(rhs.root, root);   // copy right-hand side
+        makeEmpty();                // deallocate left-hand side
+        setOptions(rhs.options);    // shape of rhs may not suit old options
+        rebalanceFactor = rhs.rebalanceFactor;
+
+        if ((options & SHARED) && rhs.root != NULL)
+        {
+            root = rhs.root;        // share right-hand side
+            ++root->refs;
+            nodeCount = rhs.nodeCount;
+            deadCount = rhs.deadCount;
+            frozen = rhs.frozen;    // shared nodes may hold packed keys
+            indexed = rhs.indexed;
+        }
+        else
+        {
+            nodeCount = forkCopy(rhs.root, root, forkLevels()); // copy rhs
+            deadCount = rhs.deadCount;
+        } // end if ((options & SHARED) && rhs.root != NULL)
     } // end if (this != &rhs)
 
     return *this;
 } // end operator=(BinTree&)
 
 /**---------------------- copyTree() ------------------------------------------
- * Copies the tree rooted at treePtr into a tree rooted at newTreePtr.
+ * Copies the tree rooted at treePtr into a tree rooted at newTreePtr. Each
+ * stack entry pairs a node to be copied with the link that will point to its
+ * copy; new leaves have NULL links, so a failed copy is still a valid tree.
  * @param treePtr  The root of the tree to be copied.
  * @param newTreePtr  A container for the root of a copy of treePtr.
- * @pre There is sufficient memory to allocate a new tree; NodeData provides
- *      the == and < operators.
+ * @pre There is sufficient memory to allocate a new tree.
  * @post newTreePtr points to the root of a structural copy of the tree whose
  *       root is pointed to by treePtr.
+ * @return The number of live items copied, which leaves out tombstones.
  */
-void BinTree::copyTree(Node *treePtr, Node *& newTreePtr) const
+int BinTree::copyTree(Node *treePtr, Node *& newTreePtr) const
 {
-    // preorder traversal
+    vector< pair<const Node*, Node**> > pending;
+    int copied = 0;
+
+    newTreePtr = NULL;                  // copy empty tree by default
+
     if (treePtr != NULL)
     {
-        // copy node
-        try
-        {
-            newTreePtr = new Node;
-            newTreePtr->data = new NodeData(*treePtr->data);
-            // continue down left branch
-            copyTree(treePtr->left, newTreePtr->left);
-            // continue down right branch
-            copyTree(treePtr->right, newTreePtr->right);
-        }
-        catch (bad_alloc e)
+        pending.reserve(treePtr->height + 1);
+        pending.push_back(make_pair(treePtr, &newTreePtr));
+    } // end if (treePtr != NULL)
+
+    // preorder traversal
+    try
+    {
+        while (!pending.empty())
         {
-            cerr << "Could not allocate memory: copyTree() failed.";
-        } // end try
+            const Node *orig = pending.back().first;
+            Node      **link = pending.back().second;
+
+            pending.pop_back();
+            *link = makeLeaf(*orig->data, NULL, NULL);  // copy node
+            (*link)->height = orig->height;
+            (*link)->hash = orig->hash;
+            (*link)->dead = orig->dead;
+            (*link)->count = orig->count;
+            copied += (orig->dead ? 0 : 1);
+
+            // right branch is pushed first, so left branch is copied first
+            if (orig->right != NULL)
+            {
+                pending.push_back(make_pair(orig->right, &(*link)->right));
+            } // end if (orig->right != NULL)
+
+            if (orig->left != NULL)
+            {
+                pending.push_back(make_pair(orig->left, &(*link)->left));
+            } // end if (orig->left != NULL)
+        } // end while (!pending.empty())
     }
-    else
+    catch (bad_alloc e)
     {
-        newTreePtr = NULL;  // copy empty tree
-    } // end if (treePtr != NULL)
+        cerr << "Could not allocate memory: copyTree() failed.";
+    } // end try
+
+    return copied;
 } // end copyTree(Node*, Node*&)
 
 /**---------------------- == Equality Operator --------------------------------
  * Compares this binary search tree with another for equality. Equality means
- * that both trees contain the same data and have the same structure.
+ * that both trees contain the same data and have the same structure. Trees of
+ * different sizes or root hashes are told apart in constant time, and shared
+ * subtrees are not walked.
  * @param rhs  The right-hand tree to be compared.
  * @pre NodeData provides an equality operator.
  * @post Both binary search trees remain unchanged.
@@ -163,11 +870,14 @@ void BinTree::copyTree(Node *treePtr, Node *& newTreePtr) const
  */
 bool BinTree::operator==(const BinTree& rhs) const
 {
-    return compare(root, rhs.root);
+    return nodeCount == rhs.nodeCount && hashOf(root) == hashOf(rhs.root)
+           && compare(root, rhs.root);
 } // end operator==(BinTree&)
 
 /**---------------------- compare() -------------------------------------------
- * Compares two subtrees for equivalent content and structure.
+ * Compares two subtrees for equivalent content and structure. Pairs of nodes
+ * still to be compared are kept on an explicit stack; a pair whose hashes
+ * differ ends the search, and a pair that is one shared node is skipped.
  * @param lhs  A binary search tree to check for equality.
  * @param rhs  A binary search tree to check against for equality.
  * @pre None.
@@ -177,22 +887,34 @@ bool BinTree::operator==(const BinTree& rhs) const
  */
 bool BinTree::compare(const Node *lhs, const Node *rhs) const
 {
-    bool success;
+    vector< pair<const Node*, const Node*> > pending;
+    bool success = true;
 
-    if (lhs == NULL && rhs == NULL)         // empty trees equivalent
-    {
-        success = true;
-    }
-    else if (lhs != NULL && rhs != NULL)    // there is data to compare
-    {
-        success = lhs->data == rhs->data &&             // compare data
-                  compare(lhs->left, rhs->left) &&      // check left subtree
-                  compare(lhs->right, rhs->right);      // check right subtree
-    }
-    else
+    pending.push_back(make_pair(lhs, rhs));
+
+    // visit pairs of corresponding nodes until a difference is found
+    while (success && !pending.empty())
     {
-        success = false;
-    } // end if (lhs == NULL && rhs == NULL)
+        lhs = pending.back().first;
+        rhs = pending.back().second;
+        pending.pop_back();
+
+        if (lhs == rhs)                         // shared, or both empty
+        {
+            // identical subtrees need not be walked
+        }
+        else if (lhs != NULL && rhs != NULL)    // there is data to compare
+        {
+            success = lhs->hash == rhs->hash && lhs->dead == rhs->dead
+                      && *lhs->data == *rhs->data;          // compare data
+            pending.push_back(make_pair(lhs->right, rhs->right));
+            pending.push_back(make_pair(lhs->left, rhs->left));
+        }
+        else if (lhs != NULL || rhs != NULL)    // only one is empty
+        {
+            success = false;
+        } // end if (lhs == rhs)
+    } // end while (success && !pending.empty())
 
     return success;
 } // end compare(Node*, Node*)
@@ -211,6 +933,67 @@ bool BinTree::operator!=(const BinTree& rhs) const
     return !(*this == rhs);
 } // end operator!=(BinTree&)
 
+/**---------------------- locateDifference() ----------------------------------
+ * Finds the shallowest position at which this tree and rhs differ. Only links
+ * whose subtree hashes disagree are followed, so one path is visited rather
+ * than either tree. The search stops at a position whose items differ, where
+ * either tree has no node, or where both subtrees differ, since from there
+ * the difference is not confined to one subtree.
+ * @param rhs  The right-hand tree to be compared.
+ * @param dataItem  A container for the item of this tree at that position;
+ *        NULL if this tree has no node there.
+ * @pre NodeData provides an equality operator.
+ * @post Both binary search trees remain unchanged.
+ * @return The depth of the position, where the root is at depth 1; 0 if both
+ *         trees have identical structures and content.
+ */
+int BinTree::locateDifference(const BinTree& rhs, NodeData *& dataItem) const
+{
+    const Node *lhsPtr = root;
+    const Node *rhsPtr = rhs.root;
+    int         level = 0;
+
+    // equal hashes are confirmed, in case of a collision
+    if (hashOf(lhsPtr) != hashOf(rhsPtr) || !compare(lhsPtr, rhsPtr))
+    {
+        bool narrowing = true;
+
+        level = 1;
+
+        while (narrowing)
+        {
+            if (lhsPtr == NULL || rhsPtr == NULL
+                || lhsPtr->dead != rhsPtr->dead
+                || *lhsPtr->data != *rhsPtr->data)  // differ right here
+            {
+                narrowing = false;
+            }
+            else if (hashOf(lhsPtr->left) == hashOf(rhsPtr->left)
+                     && hashOf(lhsPtr->right) != hashOf(rhsPtr->right))
+            {
+                lhsPtr = lhsPtr->right;             // only right differs
+                rhsPtr = rhsPtr->right;
+                ++level;
+            }
+            else if (hashOf(lhsPtr->left) != hashOf(rhsPtr->left)
+                     && hashOf(lhsPtr->right) == hashOf(rhsPtr->right))
+            {
+                lhsPtr = lhsPtr->left;              // only left differs
+                rhsPtr = rhsPtr->left;
+                ++level;
+            }
+            else                    // both differ, or hashes collided
+            {
+                narrowing = false;
+            } // end if (lhsPtr == NULL || ...)
+        } // end while (narrowing)
+    } // end if (hashOf(lhsPtr) != hashOf(rhsPtr) || ...)
+
+    dataItem = (level > 0 && lhsPtr != NULL ? lhsPtr->data : NULL);
+
+    return level;
+} // end locateDifference(BinTree&, NodeData*&)
+
 /**---------------------- << Stream Out Operator ------------------------------
  * Writes the contents of this tree to the provided ostream, in sorted order,
  * space separated on a single line.
@@ -224,339 +1007,2739 @@ bool BinTree::operator!=(const BinTree& rhs) const
  */
 ostream& operator<<(ostream& output, const BinTree& source)
 {
-    source.inorderHelper(output, source.root);
-    output << endl;
+    string text;                    // items are written in blocks, not singly
 
-    return output;
-} // end operator<<(ostream&, BinTree&)
+    if (source.indexed)
+    {
+        source.frozenInorder(text, &output, 0);
+    }
+    else
+    {
+        source.inorderHelper(text, &output, 0);
+    } // end if (source.indexed)
+
+    output.write(text.data(), text.size());
+    output << endl;
+
+    return output;
+} // end operator<<(ostream&, BinTree&)
+
+/**---------------------- flushText() -----------------------------------------
+ * Writes buffered text to an ostream once there is enough of it to be worth
+ * a write, and empties the buffer.
+ * @param text  The buffered text.
+ * @param output  The ostream the text is bound for; NULL if it is kept.
+ * @pre None.
+ * @post If output is not NULL and text held OUTPUT_CHUNK characters or more,
+ *       they are written to output and text is empty.
+ */
+void BinTree::flushText(string& text, ostream *output)
+{
+    if (output != NULL && text.size() >= OUTPUT_CHUNK)
+    {
+        output->write(text.data(), text.size());
+        text.clear();               // capacity is kept for the next block
+    } // end if (output != NULL && text.size() >= OUTPUT_CHUNK)
+} // end flushText(string&, ostream*)
 
 /**---------------------- inorderHelper() -------------------------------------
- * Traverses a binary search tree in sorted order, starting at treePtr, and
- * writes the data value of each item once, preceded by a space.
- * @param treePtr  Node at which to begin traversal.
- * @pre The ostream, output, can be written to; NodeData prvides the <<
- *      operator.
- * @post The ostream, output, contains the data element of every node in the
- *       subtree rooted at treePtr, space separated.
+ * Traverses a binary search tree in sorted order and appends the data value
+ * of each item once, preceded by a space. Ancestors whose data is still to be
+ * written are kept on an explicit stack, on the call stack unless the tree is
+ * taller than PATH_LIMIT.
+ * @param text  The string to which to append.
+ * @param output  The ostream to which to flush text as it grows; NULL to
+ *        keep it all in text.
+ * @param limit  The number of items to append; 0 for all.
+ * @pre NodeData provides the view() method.
+ * @post text, with whatever was flushed to output, ends with the data
+ *       element of each node appended, space separated.
+ * @return The number of items appended.
  */
-void BinTree::inorderHelper(ostream& output, const Node *treePtr) const
+int BinTree::inorderHelper(string& text, ostream *output, int limit) const
 {
-    if (treePtr != NULL)        // base case check
+    const Node *local[PATH_LIMIT];  // ancestors to be written, if few enough
+    vector<const Node*> spill;      // ancestors to be written, if deeper
+    const Node **ancestors = local;
+    const Node  *treePtr = root;
+    int          top = 0;
+    int          written = 0;
+
+    if (heightOf(root) > PATH_LIMIT)
     {
-        inorderHelper(output, treePtr->left);       // write left subtree
-        output << ' ' << *treePtr->data;            // write current data
-        inorderHelper(output, treePtr->right);      // write right subtree
-    } // end if (treePtr != NULL)
-} // end inorder(ostream&, Node*)
+        spill.resize(heightOf(root));
+        ancestors = &spill[0];
+    } // end if (heightOf(root) > PATH_LIMIT)
+
+    while ((treePtr != NULL || top > 0) && (limit == 0 || written < limit))
+    {
+        if (treePtr != NULL)        // defer current data; go left
+        {
+            ancestors[top++] = treePtr;
+            treePtr = treePtr->left;
+        }
+        else                        // left subtree done
+        {
+            treePtr = ancestors[--top];
+
+            if (!treePtr->dead)                     // tombstones are skipped
+            {
+                text += ' ';
+                text.append(treePtr->data->view()); // write current data
+                flushText(text, output);
+                ++written;
+            } // end if (!treePtr->dead)
+
+            treePtr = treePtr->right;               // write right subtree
+        } // end if (treePtr != NULL)
+    } // end while ((treePtr != NULL || top > 0) && ...)
+
+    return written;
+} // end inorderHelper(string&, ostream*, int)
 
 /**---------------------- insert() --------------------------------------------
- * Inserts an item into a binary search tree.
+ * Inserts an item into a binary search tree. In a BALANCED tree, the path to
+ * the new item is rebalanced, so the height remains O(log n). This tree takes
+ * ownership of newItem if it is inserted; in an INLINE tree, the value of
+ * newItem is then moved into its node and newItem is deleted.
  * @param newItem  An object to be added to the tree.
- * @pre NodeData provdes the == and < operators.
+ * @pre NodeData provides the compare() method.
  * @post newItem is in its proper position in the tree.
  * @return true if newItem could be inserted in the tree; false if newItem
  *         already existed in the tree.
  */
 bool BinTree::insert(NodeData *newItem)
 {
-    return insertItem(root, newItem);
+    bool success = insertItem(root, *newItem, newItem, NULL);
+
+    if (success && isTooTall())
+    {
+        rebalance();
+    } // end if (success && isTooTall())
+
+    return success;
 } // end insert(NodeData*)
 
+/**---------------------- insert() --------------------------------------------
+ * Inserts an item into a binary search tree by moving its value into storage
+ * owned by the tree, as insert(const NodeData&) would store a copy. The value
+ * is only moved if newItem is not already in the tree, so no allocation is
+ * made for its key beyond what newItem already holds.
+ * @param newItem  An object whose value is to be added to the tree.
+ * @pre NodeData provides the compare() method.
+ * @post The former value of newItem is in its proper position in the tree,
+ *       and newItem is empty; if the insertion failed, newItem is unchanged.
+ * @return true if newItem could be inserted in the tree; false if newItem
+ *         already existed in the tree.
+ */
+bool BinTree::insert(NodeData&& newItem)
+{
+    bool success = insertItem(root, newItem, NULL, &newItem);
+
+    if (success && isTooTall())
+    {
+        rebalance();
+    } // end if (success && isTooTall())
+
+    return success;
+} // end insert(NodeData&&)
+
+/**---------------------- insert() --------------------------------------------
+ * Inserts a copy of an item into a binary search tree. The copy is stored in
+ * its node in an INLINE tree, in the pool of a POOLED tree, or on the heap
+ * otherwise; the caller keeps ownership of newItem. The copy is only made if
+ * newItem is not already in the tree.
+ * @param newItem  An object whose value is to be added to the tree.
+ * @pre NodeData provides the compare() method.
+ * @post A copy of newItem is in its proper position in the tree.
+ * @return true if newItem could be inserted in the tree; false if newItem
+ *         already existed in the tree.
+ */
+bool BinTree::insert(const NodeData& newItem)
+{
+    bool success = insertItem(root, newItem, NULL, NULL);
+
+    if (success && isTooTall())
+    {
+        rebalance();
+    } // end if (success && isTooTall())
+
+    return success;
+} // end insert(NodeData&)
+
+/**---------------------- remove() --------------------------------------------
+ * Removes an item from a binary search tree. A node with two children is
+ * replaced by its in-order successor, and in a BALANCED tree the path is
+ * rebalanced on the way back up, so the height remains O(log n). In a LAZY
+ * tree, the node is only marked as removed; it is freed by compact(), which
+ * runs once the tree holds more tombstones than items.
+ * @param oldItem  An object equal to the item to be removed.
+ * @pre NodeData provides the compare() method.
+ * @post No item equal to oldItem is in the tree; the item that was is
+ *       deleted, unless it is a tombstone, which is deleted by compact().
+ * @return true if oldItem was found and removed; false if it was not in the
+ *         tree or memory could not be allocated.
+ */
+bool BinTree::remove(const NodeData& oldItem)
+{
+    bool success = removeItem(oldItem);
+
+    if (success && deadCount > nodeCount)
+    {
+        compact();              // searches pass more tombstones than items
+    } // end if (success && deadCount > nodeCount)
+
+    return success;
+} // end remove(NodeData&)
+
 /**---------------------- insertItem() ----------------------------------------
- * Recursively inserts an item into a binary search tree.
+ * Inserts an item into a binary search tree, recording the links followed so
+ * that the path may be fixed up without recursion.
  * @param treePtr  Pointer to the node to start a check for insertion.
  * @param newItem  The item to be inserted into this tree.
- * @pre treePtr points to a binary search tree; NodeData provides the == and <
- *      operators.
+ * @param owned  A heap object equal to newItem that this tree may keep, or
+ *        NULL if newItem must be copied.
+ * @param movable  newItem, if its value may be moved into the tree; NULL,
+ *        otherwise.
+ * @pre treePtr points to a binary search tree; NodeData provides the
+ *      compare() method.
  * @post newItem is in its proper position in the tree.
  * @return true if the item is successfully inserted; false if the item already
  *         exists in this tree or memory could not be allocated.
  */
-bool BinTree::insertItem(Node *& treePtr, NodeData *newItem)
+bool BinTree::insertItem(Node *& treePtr, const NodeData& newItem,
+                         NodeData *owned, NodeData *movable)
 {
-    bool success;
+    Node **local[PATH_LIMIT];   // links followed from treePtr, if few enough
+    vector<Node**> spill;       // links followed, for a deeper tree
+    Node ***path = local;
+    int    length = 0;
+    Node **link = &treePtr;
+    bool   success = true;
+    bool   revive = false;      // whether newItem matches a tombstone
+
+    // a new leaf can be no deeper than one below the current height
+    if (heightOf(treePtr) > PATH_LIMIT)
+    {
+        spill.resize(heightOf(treePtr));
+        path = &spill[0];
+    } // end if (heightOf(treePtr) > PATH_LIMIT)
+
+    BINTREE_COUNT(inserts, 1);
+
+    // search for the insertion position
+    while (*link != NULL && success)
+    {
+        int order = newItem.compare(*(*link)->data);
+
+        BINTREE_COUNT(insertVisits, 1);
+        BINTREE_COUNT(comparisons, 1);
+
+        // duplicates are not allowed, but a removed item may come back
+        if (order == 0)
+        {
+            revive = (*link)->dead;
+            success = false;
+        }
+        else
+        {
+            // search the left or right subtree
+            path[length++] = link;
+            link = (order < 0 ? &(*link)->left : &(*link)->right);
+        } // end if (order == 0)
+    } // end while (*link != NULL && success)
+
+    if (revive)
+    { // the node is still linked; give it the new value and bring it back
+        try
+        {
+            NodeData *source = (owned != NULL ? owned : movable);
+
+            path[length++] = link;
+            link = &(*link)->left;
+
+            if (options & SHARED)
+            {
+                unsharePath(path, length, link);
+            } // end if (options & SHARED)
+
+            if (source != NULL)
+            {
+                Node *revived = *path[length - 1];
 
-    if (treePtr == NULL)
+                *revived->data = std::move(*source);
+                revived->itemHash = revived->data->hash();
+            } // end if (source != NULL)
+
+            delete owned;
+            (*path[length - 1])->dead = false;
+            --deadCount;
+            success = true;
+        }
+        catch (bad_alloc e)
+        {
+            cerr << "Could not allocate memory for " << newItem
+                 << ": insert() failed.";
+        } // end try
+    }
+    else if (success)
     { // position of insertion found; insert as leaf
         // create a new node
         try
         {
-            treePtr = new Node;
-            treePtr->data = newItem;
-            success = true;
+            if (options & SHARED)
+            {
+                unsharePath(path, length, link);
+            } // end if (options & SHARED)
+
+            *link = makeLeaf(newItem, owned, movable);
+            refresh(*link);
         }
         catch (bad_alloc e)
         {
-            cerr << "Could not allocate memory for " << *newItem
+            cerr << "Could not allocate memory for " << newItem
                  << ": insert() failed.";
             success = false;
         } // end try
-    }
-    // duplicates are not allowed
-    else if (*newItem == *treePtr->data)
-    {
-        success = false;
-    }
-    // else search for the insertion position
-    else if (*newItem < *treePtr->data)
+    } // end if (success)
+
+    if (success)
     {
-        // search the left subtree
-        success = insertItem(treePtr->left, newItem);
-    }
-    else
+        ++nodeCount;
+        indexed = false;        // packed keys no longer match; thaw
+    } // end if (success)
+
+    // fix up the path back to the root; nothing changed on failure
+    while (success && length > 0)
     {
-        // search the right subtree
-        success = insertItem(treePtr->right, newItem);
-    } // end if (treePtr == NULL)
+        Node *& ancestor = *path[--length];
+
+        if (options & BALANCED)
+        {
+            restoreBalance(ancestor);
+        }
+        else
+        {
+            refresh(ancestor);
+        } // end if (options & BALANCED)
+    } // end while (success && length > 0)
 
     return success;
-} // end insertItem(Node*&, NodeData*&)
+} // end insertItem(Node*&, NodeData&, NodeData*, NodeData*)
 
-/**---------------------- retrieve() ------------------------------------------
- * Retrieves a given item from a binary search tree.
- * @param searchItem  The item to be located.
- * @param dataItem  A container for the found item.
- * @pre NodeData provides the == and < operators.
- * @post If the retrieval was successful, dataItem contains the retrieved item;
- *       this tree remains unchanged.
+/**---------------------- removeItem() ----------------------------------------
+ * Removes an item from a binary search tree, recording the links followed so
+ * that the path may be fixed up without recursion. A node with two children
+ * trades places with its in-order successor, which is unlinked instead; in a
+ * LAZY tree, the node is marked as a tombstone.
+ * @param oldItem  An object equal to the item to be removed.
+ * @pre NodeData provides the compare() method.
+ * @post No live item equal to oldItem is in the tree; stored heights and
+ *       hashes are current.
+ * @return true if the item was removed; false if it was not in this tree or
+ *         memory could not be allocated.
  */
-bool BinTree::retrieve(const NodeData& searchItem, NodeData *& dataItem) const
+bool BinTree::removeItem(const NodeData& oldItem)
 {
-    return retrieveItem(root, searchItem, dataItem);
-} // end retrieve(NodeData&, NodeData*&)
+    Node **local[PATH_LIMIT];   // links followed from root, if few enough
+    vector<Node**> spill;       // links followed, for a deeper tree
+    Node ***path = local;
+    int    length = 0;
+    int    target = -1;         // position in path[] of the link to the item
+    Node **link = &root;
+    bool   success;
 
-/**---------------------- retrieveItem() --------------------------------------
- * Recursively retrieves an item from a binary search tree.
- * @param treePtr  Pointer to the node at which to start searching.
- * @param searchItem  The item to be located.
- * @param dataItem  A container for the located item.
- * @pre treePtr points to a binary search tree; NodeData provides the == and <
- *      operators.
- * @post If the retrieval was successful, treeItem contains the retrieved item;
- *       this tree remains unchanged.
- * @return true if searchItem matches an item in the tree; false if searchItem
- *         could not be found.
- */
-bool BinTree::retrieveItem(const Node *treePtr,
-                           const NodeData& searchItem,
-                                 NodeData *& dataItem) const
-{
-    bool success;
+    // the path, down to the successor, is no longer than the height
+    if (heightOf(root) > PATH_LIMIT)
+    {
+        spill.resize(heightOf(root));
+        path = &spill[0];
+    } // end if (heightOf(root) > PATH_LIMIT)
 
-    if (treePtr == NULL)    // hit leaf, item not found
+    // search for the item, recording the link to each node on the way
+    while (*link != NULL && target < 0)
     {
-        success = false;
-    }
-    else if (searchItem == *(treePtr->data))
+        int order = oldItem.compare(*(*link)->data);
+
+        BINTREE_COUNT(comparisons, 1);
+        path[length++] = link;
+
+        if (order == 0)
+        {
+            target = length - 1;
+        }
+        else
+        {
+            link = (order < 0 ? &(*link)->left : &(*link)->right);
+        } // end if (order == 0)
+    } // end while (*link != NULL && target < 0)
+
+    success = (target >= 0 && !(*path[target])->dead);
+
+    // an item with two children is replaced by its successor, so the path
+    // continues down to the smallest item of its right subtree
+    if (success && !(options & LAZY)
+        && (*link)->left != NULL && (*link)->right != NULL)
+    {
+        for (link = &(*link)->right; *link != NULL; link = &(*link)->left)
+        {
+            path[length++] = link;
+        } // end for (link = &(*link)->right)
+    } // end if (success && !(options & LAZY) && ...)
+
+    if (success && (options & SHARED))
     {
-        // item is in the root of this subtree
-        dataItem = treePtr->data;
-        success = true;
+        try
+        {
+            link = &(*path[length - 1])->left;
+            unsharePath(path, length, link);    // other trees keep the item
+        }
+        catch (bad_alloc e)
+        {
+            cerr << "Could not allocate memory for " << oldItem
+                 << ": remove() failed.";
+            success = false;
+        } // end try
+    } // end if (success && (options & SHARED))
+
+    if (success && (options & LAZY))        // mark it; compact() frees it
+    {
+        (*path[target])->dead = true;
+        ++deadCount;
     }
-    else if (searchItem < *(treePtr->data))
+    else if (success && length > target + 1)   // successor takes its place
     {
-        // search the left subtree
-        success = retrieveItem(treePtr->left, searchItem, dataItem);
+        Node  *doomed = *path[target];
+        Node **successorLink = path[--length];
+        Node  *successor = *successorLink;
+
+        *successorLink = successor->right;
+        successor->left = doomed->left;
+        successor->right = doomed->right;
+        *path[target] = successor;
+
+        if (length > target + 1)
+        {
+            path[target + 1] = &successor->right;   // was doomed's link
+        } // end if (length > target + 1)
+
+        freeNode(doomed);
     }
-    else
+    else if (success)                       // its one child takes its place
     {
-        // search the right subtree
-        success = retrieveItem(treePtr->right, searchItem, dataItem);
-    } // end if (treePtr == NULL)
+        Node *doomed = *path[target];
+
+        *path[target] = (doomed->left != NULL ? doomed->left : doomed->right);
+        length = target;
+        freeNode(doomed);
+    } // end if (success && (options & LAZY))
+
+    if (success)
+    {
+        --nodeCount;
+        indexed = false;        // packed keys no longer match; thaw
+        forgetCached(oldItem);
+    } // end if (success)
+
+    // fix up the path back to the root; nothing changed on failure
+    while (success && length > 0)
+    {
+        Node *& ancestor = *path[--length];
+
+        if (options & BALANCED)
+        {
+            try
+            {
+                if (options & SHARED)
+                {
+                    unshareRotation(ancestor);
+                } // end if (options & SHARED)
+
+                restoreBalance(ancestor);
+            }
+            catch (bad_alloc e)
+            {
+                cerr << "Could not allocate memory: remove() left the tree"
+                     << " unbalanced.";
+                refresh(ancestor);      // still a search tree
+            } // end try
+        }
+        else
+        {
+            refresh(ancestor);
+        } // end if (options & BALANCED)
+    } // end while (success && length > 0)
 
     return success;
-} // end retrieveItem(Node*, NodeData&, NodeData*&)
+} // end removeItem(NodeData&)
 
-/**---------------------- displaySideways() -----------------------------------
- * Displays a binary tree as though you are viewing it from the side;
- * hard coded displaying to standard output.
- * @pre cout can be written to.
- * @post This tree remains unchanged.
+/**---------------------- unshareRotation() -----------------------------------
+ * Gives a SHARED tree its own copy of the nodes below a node that
+ * restoreBalance() would rotate. After a removal, unlike after an insert,
+ * these lie off the path, in the taller subtree.
+ * @param treePtr  The node about to be balanced.
+ * @pre treePtr is not NULL and belongs to this tree alone.
+ * @post The taller child of treePtr, if the children differ in height by
+ *       more than one, and that child's inner child belong to this tree alone.
+ * @throw bad_alloc if memory could not be allocated; the tree holds the same
+ *        items as before.
  */
-void BinTree::displaySideways(void) const
+void BinTree::unshareRotation(Node *treePtr)
 {
-   sideways(root, 0);
-} // end displaySideways()
+    int balance = heightOf(treePtr->left) - heightOf(treePtr->right);
 
-/**---------------------- sideways() ------------------------------------------
- * Displays a binary tree as though you are viewing it from the side;
- * hard coded displaying to standard output.
- * @param current  The Node being examined for display.
- * @param level  The depth of the current Node, used to determine indentation.
- * @pre cout can be written to.
- * @post cout contains a graphical representation of this tree.
- */
-void BinTree::sideways(Node *current, int level) const
-{
-   if (current != NULL)
-   {
-      level++;
-      sideways(current->right, level);
+    if (balance > 1)                // rotations move the left child
+    {
+        unshare(treePtr->left);
 
-      // indent for readability, 4 spaces per depth level
-      for(int i = level; i >= 0; i--)
-      {
-          cout << "    ";
-      } // end for(int i = level)
+        if (treePtr->left->right != NULL)
+        {
+            unshare(treePtr->left->right);
+        } // end if (treePtr->left->right != NULL)
+    }
+    else if (balance < -1)          // rotations move the right child
+    {
+        unshare(treePtr->right);
 
-      cout << *current->data << endl;        // display information of object
-      sideways(current->left, level);
-   } // end if (current != NULL)
-} // end sideways(Node*, int)
+        if (treePtr->right->left != NULL)
+        {
+            unshare(treePtr->right->left);
+        } // end if (treePtr->right->left != NULL)
+    } // end if (balance > 1)
+} // end unshareRotation(Node*)
 
-/**---------------------- getDepth() ------------------------------------------
- * Determines the depth of a node in a binary search tree. If the data is found
- * at the root, the depth is 1. If the data is not found, the depth is 0. The
- * item is sought with iteration through the tree, rather than binary
- * comparisons.
- * @param searchItem  The item to locate in the tree.
- * @pre NodeData provides an equality operator.
- * @post This tree remains unchanged.
- * @return The depth of the node containing treeItem, if found; 0, otherwise.
+/**---------------------- collectLive() ---------------------------------------
+ * Lists the nodes of a binary search tree that hold live items, in sorted
+ * order, so that they may be marked in place. A SHARED tree first copies any
+ * nodes it still shares.
+ * @param nodes  A container for the nodes, which is emptied beforehand.
+ * @pre None.
+ * @post nodes holds every node of this tree that is not a tombstone, in
+ *       sorted order, and none of them is shared with another tree.
+ * @return true if the nodes were listed; false if memory could not be
+ *         allocated, in which case nodes is empty.
  */
-int BinTree::getDepth(const NodeData& searchItem) const
+bool BinTree::collectLive(vector<Node*>& nodes)
 {
-    return depth(root, searchItem);
-} // end getDepth(NodeData&)
+    vector<Node*> ancestors;
+    Node         *treePtr;
+    bool          success = true;
 
-/**---------------------- depth() ---------------------------------------------
- * Determines the depth of a node in a binary search tree. If the data is found
- * at the root, the depth is 1. If the data is not found, the depth is 0. The
- * item is sought with iteration through the tree, rather than binary
- * comparisons.
- * @param searchItem  The item to locate in the tree.
- * @pre NodeData provides an equality operator.
- * @post This tree remains unchanged.
- * @return The depth of the node containing treeItem, if found; 0 the item is
- *         not found.
- */
-int BinTree::depth(const Node *treePtr, const NodeData& dataItem) const
-{
-    int level;
+    nodes.clear();
 
-    if (treePtr == NULL)        // base case: hit leaf: item not found
-    {
-        level = 0;
-    }
-    else if (dataItem == *treePtr->data)       // base case: item found
+    try
     {
-        level = 1;
+        if (options & SHARED)
+        {
+            unshareAll(root);           // other trees keep their items
+        } // end if (options & SHARED)
+
+        nodes.reserve(nodeCount);
+        ancestors.reserve(heightOf(root));
     }
-    else
+    catch (bad_alloc e)
     {
-        // check left subtree for item
-        level = depth(treePtr->left, dataItem);
+        cerr << "Could not allocate memory: removeIf() failed.";
+        success = false;
+    } // end try
 
-        if (level == 0)     // item not in left subtree
-        {
-            level = depth(treePtr->right, dataItem);
-        } // end if (depth == 0)
+    treePtr = (success ? root : NULL);
 
-        if (level > 0)      // item found in a subtree
+    while (treePtr != NULL || !ancestors.empty())
+    {
+        if (treePtr != NULL)            // defer current node; go left
         {
-            ++level;        // add depth for this level
-        } // end if (depth > 0)
-    } // end if (treePtr == NULL)
+            ancestors.push_back(treePtr);
+            treePtr = treePtr->left;
+        }
+        else                            // left subtree done
+        {
+            treePtr = ancestors.back();
+            ancestors.pop_back();
 
-    return level;
-} // end depth(Node*, NodeData&)
+            if (!treePtr->dead)
+            {
+                nodes.push_back(treePtr);
+            } // end if (!treePtr->dead)
 
-/**---------------------- bstreeToArray() -------------------------------------
- * Fills an array of NodeData* by using an inorder traversal of the tree. The
- * tree is left empty. The size of the array is not checked and is assumed to
- * be sufficient to contain every element in the tree.
- * @param target[]  The array to fill with the NodeData* from this tree.
- * @pre target[] currently contains 100 NULL elements.
- * @post target[] contains every element found in this tree, in sorded order;
- *       this tree is empty.
+            treePtr = treePtr->right;
+        } // end if (treePtr != NULL)
+    } // end while (treePtr != NULL || !ancestors.empty())
+
+    return success;
+} // end collectLive(vector<Node*>&)
+
+/**---------------------- heightOf() ------------------------------------------
+ * Determines the height of a subtree from the height stored in its root.
+ * @param treePtr  The root of the subtree to measure; may be NULL.
+ * @pre Heights stored in the subtree are current.
+ * @post The subtree remains unchanged.
+ * @return The height of the subtree rooted at treePtr; 0 if it is empty.
  */
-void BinTree::bstreeToArray(NodeData *target[])
+int BinTree::heightOf(const Node *treePtr)
 {
-    int index = 10;
-    // Anything I do with an element of target[0-9] causes SEGFAULT. I was
-    // unable to find the cause, so I decided to skip the first 10 elements to
-    // at least demonstrate that the algorithm works.
-    inorderToArray(root, target, index);
-    destroyTree(root);
-} // end bstreeToArray(NodeData*[])
+    return (treePtr == NULL ? 0 : treePtr->height);
+} // end heightOf(Node*)
 
-/**---------------------- inorderToArray() ------------------------------------
- * Traverses a binary search tree in sorted order and moves each data element
- * into an array of NodeData*. The size of targe[] is assumed to be sufficient
- * to contain all elements in the subtree.
- * @param treePtr  The root of a subtree to move into an array.
- * @param target[]  An array to move a subtree into.
- * @param index  The index at which to insert the next item into the array.
- * @pre target[] is large enough to contain every element in the subtree; the
- *      initial call to this method is proceeded by destroyTree().
- * @post target[] contains every data item from the subtree in sorted order;
- *       data pointers in the subree are NULL.
- * @note This tree MUST be emptied after calling this method, or it will not be
- *       a binary search tree.
+/**---------------------- hashOf() --------------------------------------------
+ * Determines the structural hash of a subtree from the hash stored in its
+ * root. Each hash combines the hash of a node's item with the hashes of its
+ * left and right subtrees, in order, so equal subtrees have equal hashes.
+ * @param treePtr  The root of the subtree; may be NULL.
+ * @pre Hashes stored in the subtree are current.
+ * @post The subtree remains unchanged.
+ * @return The hash of the subtree rooted at treePtr; 0 if it is empty.
  */
-void BinTree::inorderToArray(Node *treePtr, NodeData *target[], int& index)
+size_t BinTree::hashOf(const Node *treePtr)
 {
-    if (treePtr != NULL)
-    {
-        inorderToArray(treePtr->left, target, index);
-        target[index++] = treePtr->data;
-        treePtr->data = NULL;
-        inorderToArray(treePtr->right, target, index);
-    } // end if (treePtr != NULL)
-} // end inorderTransfer(Node*, NodeData*[])
+    return (treePtr == NULL ? 0 : treePtr->hash);
+} // end hashOf(Node*)
 
-/**---------------------- arrayToBSTree() -------------------------------------
- * Populates this tree from the contents of an array of sorted NodeData*. Any
- * contents of this tree are removed beforehand. The new tree is balanced by
- * using bisection of the array to choose the order of insertion.
- * @param source[]  The array from which to populate this tree.
- * @pre target[] is sorted in ascending order.
- * @post This tree is balanced and contains all NodeData* that were contained
- *       in source[]; all elements of source[] are now NULL.
+/**---------------------- countOf() -------------------------------------------
+ * Determines the number of live items in a subtree from the count stored in
+ * its root.
+ * @param treePtr  The root of the subtree; may be NULL.
+ * @pre Counts stored in the subtree are current.
+ * @post The subtree remains unchanged.
+ * @return The number of items in the subtree, leaving out tombstones; 0 if
+ *         it is empty.
  */
-void BinTree::arrayToBSTree(NodeData *source[])
+int BinTree::countOf(const Node *treePtr)
 {
-    int low = 10, high;     // low = 10 due to bug in bstreeToArray()
-    
-    destroyTree(root);
+    return (treePtr == NULL ? 0 : treePtr->count);
+} // end countOf(Node*)
 
-    // find last element, assuming contiguous data
-    for (high = low; high < 100 && source[high] != NULL; ++high)
-    {
-    } // end for (high = low)
-    
-    --high;      // high was length of array; set to index of last element
+/**---------------------- refresh() -------------------------------------------
+ * Recomputes the height, item count, and structural hash stored in a node
+ * from those of its children and from the hash of its own item, which was
+ * stored with the item, so no key is hashed again.
+ * @param treePtr  The node to update.
+ * @pre treePtr is not NULL; the heights, counts, and hashes of both children
+ *      are current.
+ * @post The height, count, and hash stored in treePtr are current.
+ */
+void BinTree::refresh(Node *treePtr)
+{
+    int leftHeight  = heightOf(treePtr->left);
+    int rightHeight = heightOf(treePtr->right);
 
-    if (source[low] != NULL)                // ensure array has first element
+    size_t hash = treePtr->itemHash;
+
+    if (treePtr->dead)
     {
-        bisectBuild(source, low, high);     // build a balanced tree
-    } // end if (source[low] != NULL)
-} // end arrayToBSTree(NodeData*[])
+        hash = ~hash;               // a tombstone differs from its item
+    } // end if (treePtr->dead)
+
+    treePtr->height = 1 + (leftHeight > rightHeight ? leftHeight
+                                                    : rightHeight);
+    treePtr->count = (treePtr->dead ? 0 : 1) + countOf(treePtr->left)
+                     + countOf(treePtr->right);
+
+    // order matters, so mirror images hash differently
+    hash = mixHash(hash, hashOf(treePtr->left));
+    treePtr->hash = mixHash(hash, hashOf(treePtr->right));
+} // end refresh(Node*)
+
+/**---------------------- rotateLeft() ----------------------------------------
+ * Rotates a subtree to the left, so that the right child of treePtr becomes
+ * the root of the subtree.
+ * @param treePtr  The root of the subtree to rotate.
+ * @pre treePtr and its right child are not NULL.
+ * @post treePtr points to the former right child, which now holds the former
+ *       root as its left child; stored heights are current.
+ */
+void BinTree::rotateLeft(Node *& treePtr)
+{
+    Node *pivot = treePtr->right;
+
+    treePtr->right = pivot->left;
+    pivot->left = treePtr;
+    refresh(treePtr);       // old root is now below pivot
+    refresh(pivot);
+    treePtr = pivot;
+} // end rotateLeft(Node*&)
+
+/**---------------------- rotateRight() ---------------------------------------
+ * Rotates a subtree to the right, so that the left child of treePtr becomes
+ * the root of the subtree.
+ * @param treePtr  The root of the subtree to rotate.
+ * @pre treePtr and its left child are not NULL.
+ * @post treePtr points to the former left child, which now holds the former
+ *       root as its right child; stored heights are current.
+ */
+void BinTree::rotateRight(Node *& treePtr)
+{
+    Node *pivot = treePtr->left;
+
+    treePtr->left = pivot->right;
+    pivot->right = treePtr;
+    refresh(treePtr);       // old root is now below pivot
+    refresh(pivot);
+    treePtr = pivot;
+} // end rotateRight(Node*&)
 
-/**---------------------- bisectBuild() ---------------------------------------
- * Fills this tree from the contents of an array segment of sorted NodeData*.
- * The new tree is balanced by using bisection of the array segment to choose
- * the order of insertion. Elements are removed from the array as they are
- * inserted into this tree.
- * @param source[]  The array from which to fill this tree.
- * @param low  The lower bound of the segment to examine.
- * @param high  The upper bound of the segment to examine.
- * @pre source[] is sorted in ascending order; this tree only contains data
- *      from the array source[].
- * @post The data elements in the provided array segment have been inserted
- *       into this tree; this tree is balanced.
- */
-void BinTree::bisectBuild(NodeData *source[], int low, int high)
-{
-    int mid = (low + high) / 2;
-
-    if (low <= mid)                     // base case check
-    {
-        if (insert(source[mid]))        // middle element is subtree root
-        {
-            source[mid] = NULL;         // array emptied as tree is built
-            bisectBuild(source, low, mid - 1);      // build left branch
-            bisectBuild(source, mid + 1, high);     // build right branch
-        } // end if (insert(source[mid]))
-    } // end if (low <= mid)
-} // end bisectBuild(NodeData*&[], int, int)
+/**---------------------- restoreBalance() ------------------------------------
+ * Restores the AVL property at the root of a subtree whose children differ in
+ * height by at most two, using a single or double rotation.
+ * @param treePtr  The root of the subtree to balance.
+ * @pre treePtr is not NULL; both subtrees of treePtr are AVL balanced.
+ * @post The subtree rooted at treePtr is AVL balanced; stored heights are
+ *       current.
+ */
+void BinTree::restoreBalance(Node *& treePtr)
+{
+    int balance = heightOf(treePtr->left) - heightOf(treePtr->right);
+
+    if (balance > 1)                // left side too tall
+    {
+        if (heightOf(treePtr->left->left) < heightOf(treePtr->left->right))
+        {
+            rotateLeft(treePtr->left);      // left-right case
+        } // end if (heightOf(treePtr->left->left) < ...)
+
+        rotateRight(treePtr);
+    }
+    else if (balance < -1)          // right side too tall
+    {
+        if (heightOf(treePtr->right->right) < heightOf(treePtr->right->left))
+        {
+            rotateRight(treePtr->right);    // right-left case
+        } // end if (heightOf(treePtr->right->right) < ...)
+
+        rotateLeft(treePtr);
+    }
+    else
+    {
+        refresh(treePtr);           // already balanced; update height only
+    } // end if (balance > 1)
+} // end restoreBalance(Node*&)
+
+/**---------------------- retrieve() ------------------------------------------
+ * Retrieves a given item from a binary search tree. In a SHARED tree, the
+ * item found may also be held by copies of this tree, so it must not be
+ * changed through dataItem. A frozen tree is searched through its array. A
+ * CACHED tree first looks in the cache slot of searchItem, and remembers the
+ * item there once found.
+ * @param searchItem  The item to be located.
+ * @param dataItem  A container for the found item.
+ * @pre NodeData provides the compare() method.
+ * @post If the retrieval was successful, dataItem contains the retrieved item;
+ *       this tree remains unchanged, but for its cache.
+ */
+bool BinTree::retrieve(const NodeData& searchItem, NodeData *& dataItem) const
+{
+    std::atomic<NodeData*> *slot = NULL;    // cache slot of searchItem
+    NodeData *hot = NULL;                   // item last found in that slot
+    bool      success = false;
+
+    BINTREE_COUNT(retrieves, 1);
+
+    if (cache != NULL)
+    {
+        slot = &cache[searchItem.hash() & (CACHE_SLOTS - 1)];
+        hot = slot->load(memory_order_relaxed);
+        success = (hot != NULL && searchItem.compare(*hot) == 0);
+        BINTREE_COUNT(comparisons, hot != NULL ? 1 : 0);
+        BINTREE_COUNT(cacheHits, success ? 1 : 0);
+        BINTREE_COUNT(cacheMisses, success ? 0 : 1);
+    } // end if (cache != NULL)
+
+    if (success)
+    {
+        dataItem = hot;                     // no walk from the root
+    }
+    else if (indexed)
+    {
+        size_t index = frozenIndex(searchItem);
+
+        success = (index != 0);
+
+        if (success)
+        {
+            dataItem = &(*frozen)[index];
+        } // end if (success)
+    }
+    else
+    {
+        success = retrieveItem(root, searchItem, dataItem);
+    } // end if (success)
+
+    // a hit is not stored again, so hot keys leave their slot unwritten
+    if (slot != NULL && success && dataItem != hot)
+    {
+        slot->store(dataItem, memory_order_relaxed);
+    } // end if (slot != NULL && success && dataItem != hot)
+
+    return success;
+} // end retrieve(NodeData&, NodeData*&)
+
+/**---------------------- retrieveMany() --------------------------------------
+ * Retrieves a batch of items from a binary search tree. Up to SEARCH_GROUP
+ * searches advance together, one level at a time, and each prefetches the
+ * node it will visit next, so the cache misses of one search overlap with
+ * the comparisons of the others rather than following one another.
+ * @param keys[]  The items to be located.
+ * @param count  The number of elements in keys[].
+ * @param found[]  A container for the found items, in the order of keys[].
+ * @pre found[] has room for count elements; NodeData provides the compare()
+ *      method.
+ * @post found[i] points to the item matching keys[i], or is NULL if there is
+ *       none; this tree remains unchanged.
+ * @return The number of keys that were found.
+ */
+int BinTree::retrieveMany(const NodeData keys[], int count,
+                                NodeData *found[]) const
+{
+    const Node *cursor[SEARCH_GROUP];   // next node of each active search
+    int         which[SEARCH_GROUP];    // key of each active search
+    int         hits = 0;
+    unsigned long long visits = 0;      // comparisons made by every search
+
+    BINTREE_COUNT(retrieves, count);
+
+    for (int start = 0; start < count; start += SEARCH_GROUP)
+    {
+        int active = (count - start < SEARCH_GROUP ? count - start
+                                                   : SEARCH_GROUP);
+
+        for (int i = 0; i < active; ++i)
+        {
+            cursor[i] = root;
+            which[i] = start + i;
+            found[start + i] = NULL;
+        } // end for (int i = 0)
+
+        while (active > 0)
+        {
+            // the nodes were prefetched last round; fetch their data too
+            for (int i = 0; i < active; ++i)
+            {
+                if (cursor[i] != NULL)
+                {
+                    prefetch(cursor[i]->data);
+                } // end if (cursor[i] != NULL)
+            } // end for (int i = 0)
+
+            // advance each search one level; finished ones are swapped out
+            for (int i = 0; i < active; )
+            {
+                const Node *treePtr = cursor[i];
+                int         order = 0;
+
+                if (treePtr != NULL)
+                {
+                    order = keys[which[i]].compare(*treePtr->data);
+                    ++visits;
+                } // end if (treePtr != NULL)
+
+                if (treePtr == NULL || order == 0)  // search is over
+                {
+                    if (treePtr != NULL && !treePtr->dead)
+                    {
+                        found[which[i]] = treePtr->data;
+                        ++hits;
+                    } // end if (treePtr != NULL && !treePtr->dead)
+
+                    --active;
+                    cursor[i] = cursor[active];
+                    which[i] = which[active];
+                }
+                else
+                {
+                    cursor[i] = (order < 0 ? treePtr->left : treePtr->right);
+                    prefetch(cursor[i]);
+                    ++i;
+                } // end if (treePtr == NULL || order == 0)
+            } // end for (int i = 0)
+        } // end while (active > 0)
+    } // end for (int start = 0)
+
+    BINTREE_COUNT(retrieveVisits, visits);
+    BINTREE_COUNT(comparisons, visits);
+    return hits;
+} // end retrieveMany(NodeData[], int, NodeData*[])
+
+/**---------------------- retrieveItem() --------------------------------------
+ * Retrieves an item from a binary search tree, descending one level per
+ * comparison.
+ * @param treePtr  Pointer to the node at which to start searching.
+ * @param searchItem  The item to be located.
+ * @param dataItem  A container for the located item.
+ * @pre treePtr points to a binary search tree; NodeData provides the
+ *      compare() method.
+ * @post If the retrieval was successful, treeItem contains the retrieved item;
+ *       this tree remains unchanged.
+ * @return true if searchItem matches an item in the tree; false if searchItem
+ *         could not be found.
+ */
+bool BinTree::retrieveItem(const Node *treePtr,
+                           const NodeData& searchItem,
+                                 NodeData *& dataItem) const
+{
+    bool success = false;
+
+    while (treePtr != NULL && !success)    // a leaf means item not found
+    {
+        int order = searchItem.compare(*treePtr->data);
+
+        BINTREE_COUNT(retrieveVisits, 1);
+        BINTREE_COUNT(comparisons, 1);
+
+        if (order == 0 && !treePtr->dead)
+        {
+            // item is in the root of this subtree
+            dataItem = treePtr->data;
+            success = true;
+        }
+        else if (order == 0)
+        {
+            treePtr = NULL;         // item was removed; no other can match
+        }
+        else
+        {
+            // search the left or right subtree
+            treePtr = (order < 0 ? treePtr->left : treePtr->right);
+        } // end if (order == 0)
+    } // end while (treePtr != NULL && !success)
+
+    return success;
+} // end retrieveItem(Node*, NodeData&, NodeData*&)
+
+/**---------------------- frozenIndex() ---------------------------------------
+ * Locates an item in the array packed by freeze(). The search descends to
+ * index 2k or 2k + 1 by adding the result of each comparison, so it does not
+ * branch on the data; the position of the match is then recovered by
+ * dropping the trailing right turns, and one more, from the final index.
+ * @param searchItem  The item to be located.
+ * @pre indexed is true; NodeData provides the compare() method.
+ * @post This tree remains unchanged.
+ * @return The index of the item matching searchItem; 0 if there is none.
+ */
+size_t BinTree::frozenIndex(const NodeData& searchItem) const
+{
+    const NodeData *keys = &(*frozen)[0];
+    size_t count = nodeCount;
+    size_t index = 1;
+
+    while (index <= count)
+    {
+        // the four grandchildren are adjacent; fetch them a level early
+        if (4 * index <= count)
+        {
+            prefetch(&keys[4 * index]);
+        } // end if (4 * index <= count)
+
+        index = 2 * index + (keys[index].compare(searchItem) < 0);
+        BINTREE_COUNT(retrieveVisits, 1);
+        BINTREE_COUNT(comparisons, 1);
+    } // end while (index <= count)
+
+    // the last left turn was taken at the smallest item not less than searchItem
+    while (index & 1)
+    {
+        index >>= 1;
+    } // end while (index & 1)
+
+    index >>= 1;
+    BINTREE_COUNT(comparisons, index != 0 ? 1 : 0);
+
+    if (index != 0 && keys[index].compare(searchItem) != 0)
+    {
+        index = 0;
+    } // end if (index != 0 && ...)
+
+    return index;
+} // end frozenIndex(NodeData&)
+
+/**---------------------- frozenInorder() -------------------------------------
+ * Appends the items of the array packed by freeze() in sorted order, each
+ * preceded by a space, by stepping from each index to its successor.
+ * @param text  The string to which to append.
+ * @param output  The ostream to which to flush text as it grows; NULL to
+ *        keep it all in text.
+ * @param limit  The number of items to append; 0 for all.
+ * @pre indexed is true; NodeData provides the view() method.
+ * @post text, with whatever was flushed to output, ends with the items of
+ *       this tree appended, space separated.
+ * @return The number of items appended.
+ */
+int BinTree::frozenInorder(string& text, ostream *output, int limit) const
+{
+    size_t count = nodeCount;
+    int    written = 0;
+
+    for (size_t index = firstIndex(count);
+                index != 0 && (limit == 0 || written < limit);
+                index = nextIndex(index, count))
+    {
+        text += ' ';
+        text.append((*frozen)[index].view());
+        flushText(text, output);
+        ++written;
+    } // end for (size_t index = firstIndex(count))
+
+    return written;
+} // end frozenInorder(string&, ostream*, int)
+
+/**---------------------- displaySideways() -----------------------------------
+ * Displays a binary tree as though you are viewing it from the side;
+ * hard coded displaying to standard output.
+ * @pre cout can be written to.
+ * @post This tree remains unchanged.
+ */
+void BinTree::displaySideways(void) const
+{
+   displaySideways(cout);
+} // end displaySideways()
+
+/**---------------------- displaySideways() -----------------------------------
+ * Displays a binary tree as though you are viewing it from the side, on any
+ * ostream. The lines are gathered in a buffer and written in large blocks,
+ * rather than one item at a time. Nodes deeper than maxDepth are left out,
+ * and at most maxNodes lines are written.
+ * @param output  The ostream to which to write.
+ * @param maxDepth  The depth of the deepest nodes to display; 0 for all.
+ * @param maxNodes  The number of nodes to display; 0 for all.
+ * @pre The ostream, output, can be written to; maxDepth and maxNodes are not
+ *      negative.
+ * @post output contains a graphical representation of this tree; this tree
+ *       remains unchanged.
+ */
+void BinTree::displaySideways(ostream& output, int maxDepth,
+                              int maxNodes) const
+{
+   string text;
+
+   sideways(text, &output, maxDepth, maxNodes);
+   output.write(text.data(), text.size());
+   output.flush();                  // as the endl after each line once did
+} // end displaySideways(ostream&, int, int)
+
+/**---------------------- appendSideways() ------------------------------------
+ * Appends the sideways display of a binary tree to a string, as
+ * displaySideways() would write it. Reusing a string whose capacity suffices
+ * makes the call free of allocation for trees no taller than PATH_LIMIT.
+ * @param output  The string to which to append.
+ * @param maxDepth  The depth of the deepest nodes to display; 0 for all.
+ * @param maxNodes  The number of nodes to display; 0 for all.
+ * @pre NodeData provides the view() method; maxDepth and maxNodes are not
+ *      negative.
+ * @post output ends with a graphical representation of this tree; this tree
+ *       remains unchanged.
+ * @return The number of nodes displayed.
+ */
+int BinTree::appendSideways(string& output, int maxDepth, int maxNodes) const
+{
+   return sideways(output, NULL, maxDepth, maxNodes);
+} // end appendSideways(string&, int, int)
+
+/**---------------------- appendInorder() -------------------------------------
+ * Appends the contents of a binary search tree to a string, in sorted order,
+ * each item preceded by a space, as operator<< writes them but without the
+ * line end. Reusing a string whose capacity suffices makes the call free of
+ * allocation for trees no taller than PATH_LIMIT.
+ * @param output  The string to which to append.
+ * @param limit  The number of items to append, from the smallest; 0 for all.
+ * @pre NodeData provides the view() method; limit is not negative.
+ * @post output ends with the smallest items of this tree, space separated;
+ *       this tree remains unchanged.
+ * @return The number of items appended.
+ */
+int BinTree::appendInorder(string& output, int limit) const
+{
+   return indexed ? frozenInorder(output, NULL, limit)
+                  : inorderHelper(output, NULL, limit);
+} // end appendInorder(string&, int)
+
+/**---------------------- sideways() ------------------------------------------
+ * Appends the display of a binary tree as though you are viewing it from the
+ * side. Nodes are visited in reverse order, with the ancestors still to be
+ * displayed kept on an explicit stack, on the call stack unless the tree is
+ * taller than PATH_LIMIT.
+ * @param text  The string to which to append.
+ * @param output  The ostream to which to flush text as it grows; NULL to
+ *        keep it all in text.
+ * @param maxDepth  The depth of the deepest nodes to display; 0 for all.
+ * @param maxNodes  The number of nodes to display; 0 for all.
+ * @pre NodeData provides the view() method.
+ * @post text, with whatever was flushed to output, ends with a graphical
+ *       representation of this tree.
+ * @return The number of nodes displayed.
+ */
+int BinTree::sideways(string& text, ostream *output, int maxDepth,
+                      int maxNodes) const
+{
+   pair<const Node*, int> local[PATH_LIMIT];    // ancestors, if few enough
+   vector< pair<const Node*, int> > spill;      // ancestors, if deeper
+   pair<const Node*, int> *ancestors = local;
+   const Node *treePtr = root;
+   int level = 0;
+   int top = 0;
+   int written = 0;
+
+   if (heightOf(root) > PATH_LIMIT)
+   {
+      spill.resize(heightOf(root));
+      ancestors = &spill[0];
+   } // end if (heightOf(root) > PATH_LIMIT)
+
+   while ((treePtr != NULL || top > 0)
+          && (maxNodes == 0 || written < maxNodes))
+   {
+      if (treePtr != NULL)          // defer current node; go right
+      {
+         level++;
+         ancestors[top++] = make_pair(treePtr, level);
+         treePtr = (maxDepth == 0 || level < maxDepth) ? treePtr->right : NULL;
+      }
+      else                          // right subtree done
+      {
+         --top;
+         treePtr = ancestors[top].first;
+         level = ancestors[top].second;
+
+         // indent for readability, 4 spaces per depth level
+         if (!treePtr->dead)        // tombstones are skipped
+         {
+            text.append(4 * (level + 1), ' ');
+            text.append(treePtr->data->view());  // display information
+            text += '\n';
+            flushText(text, output);
+            ++written;
+         } // end if (!treePtr->dead)
+
+         treePtr = (maxDepth == 0 || level < maxDepth) ? treePtr->left : NULL;
+      } // end if (treePtr != NULL)
+   } // end while ((treePtr != NULL || top > 0) && ...)
+
+   return written;
+} // end sideways(string&, ostream*, int, int)
+
+/**---------------------- getDepth() ------------------------------------------
+ * Determines the depth of a node in a binary search tree. If the data is found
+ * at the root, the depth is 1. If the data is not found, the depth is 0. The
+ * item is sought by following the comparison path from the root, so the cost
+ * is bounded by the height of the tree; a frozen tree follows it through its
+ * array instead.
+ * @param searchItem  The item to locate in the tree.
+ * @pre NodeData provides the compare() method.
+ * @post This tree remains unchanged.
+ * @return The depth of the node containing treeItem, if found; 0, otherwise.
+ */
+int BinTree::getDepth(const NodeData& searchItem) const
+{
+    int level = 0;
+
+    BINTREE_COUNT(retrieves, 1);
+
+    if (indexed)
+    {
+        // index k is at the depth given by its number of binary digits
+        for (size_t index = frozenIndex(searchItem); index != 0; index >>= 1)
+        {
+            ++level;
+        } // end for (size_t index = frozenIndex(searchItem))
+    }
+    else
+    {
+        level = depth(root, searchItem);
+    } // end if (indexed)
+
+    return level;
+} // end getDepth(NodeData&)
+
+/**---------------------- getHeight() -----------------------------------------
+ * Determines the height of a binary search tree. An empty tree has a height of
+ * 0 and a tree with only a root has a height of 1.
+ * @pre None.
+ * @post This tree remains unchanged.
+ * @return The number of nodes on the longest path from the root to a leaf.
+ */
+int BinTree::getHeight(void) const
+{
+    return heightOf(root);
+} // end getHeight()
+
+/**---------------------- size() ----------------------------------------------
+ * Determines the number of items in a binary search tree.
+ * @pre None.
+ * @post This tree remains unchanged.
+ * @return The number of items in this tree, which is maintained as items are
+ *         added and removed.
+ */
+int BinTree::size(void) const
+{
+    return nodeCount;
+} // end size()
+
+/**---------------------- getStats() ------------------------------------------
+ * Reports the counters of a binary search tree since it was created or
+ * resetStats() was last called, with its current height and size. Searches
+ * of retrieveMany() and getDepth() are counted with those of retrieve(), and
+ * nodes copied into this tree when it is copied are counted as allocations.
+ * @pre None.
+ * @post This tree remains unchanged.
+ * @return The counters and shape of this tree.
+ */
+BinTree::Stats BinTree::getStats(void) const
+{
+    Stats stats = Stats();
+
+#ifdef BINTREE_STATS
+    stats.comparisons = counters.comparisons.load(memory_order_relaxed);
+    stats.retrieves = counters.retrieves.load(memory_order_relaxed);
+    stats.retrieveVisits = counters.retrieveVisits.load(memory_order_relaxed);
+    stats.inserts = counters.inserts.load(memory_order_relaxed);
+    stats.insertVisits = counters.insertVisits.load(memory_order_relaxed);
+    stats.allocations = counters.allocations.load(memory_order_relaxed);
+    stats.cacheHits = counters.cacheHits.load(memory_order_relaxed);
+    stats.cacheMisses = counters.cacheMisses.load(memory_order_relaxed);
+#endif
+
+    stats.height = heightOf(root);
+    stats.size = nodeCount;
+    return stats;
+} // end getStats()
+
+/**---------------------- resetStats() ----------------------------------------
+ * Sets the counters of a binary search tree back to 0.
+ * @pre None.
+ * @post getStats() reports no work done by this tree.
+ */
+void BinTree::resetStats(void)
+{
+#ifdef BINTREE_STATS
+    counters.comparisons.store(0, memory_order_relaxed);
+    counters.retrieves.store(0, memory_order_relaxed);
+    counters.retrieveVisits.store(0, memory_order_relaxed);
+    counters.inserts.store(0, memory_order_relaxed);
+    counters.insertVisits.store(0, memory_order_relaxed);
+    counters.allocations.store(0, memory_order_relaxed);
+    counters.cacheHits.store(0, memory_order_relaxed);
+    counters.cacheMisses.store(0, memory_order_relaxed);
+#endif
+} // end resetStats()
+
+/**---------------------- rebalance() -----------------------------------------
+ * Rebalances a binary search tree in place, using the Day-Stout-Warren
+ * algorithm: the tree is rotated into a sorted vine, which is then compressed
+ * into a complete tree. No items are compared, and no nodes are allocated or
+ * freed, except that a SHARED tree first copies any nodes it still shares and
+ * tombstones are freed as the vine is built.
+ * @pre None.
+ * @post This tree holds the same items as before and no tombstones, with a
+ *       height of ceil(log2(size() + 1)); stored heights are current.
+ */
+void BinTree::rebalance(void)
+{
+    Node  pseudoRoot(NULL, HEAP_DATA);  // parent of the root; never freed
+    Node *tail = &pseudoRoot;
+    Node *rest = root;
+    int   length = 0;                   // number of nodes in the vine
+    int   full = 1;                     // nodes in a perfect tree, plus one
+    int   dropped = 0;                  // number of tombstones freed
+
+    if (options & SHARED)
+    {
+        try
+        {
+            unshareAll(root);           // other trees keep their shape
+            rest = root;
+        }
+        catch (bad_alloc e)
+        {
+            cerr << "Could not allocate memory: rebalance() failed.";
+            rest = NULL;                // tree is left as it is
+        } // end try
+    } // end if (options & SHARED)
+
+    // rotate left children up until the tree is a right-leaning vine, which
+    // tombstones leave as they come into place
+    pseudoRoot.right = rest;
+
+    while (rest != NULL)
+    {
+        if (rest->left == NULL && rest->dead)   // unlink and free tombstone
+        {
+            tail->right = rest->right;
+            freeNode(rest);
+            rest = tail->right;
+            ++dropped;
+        }
+        else if (rest->left == NULL)    // rest is in place; move down
+        {
+            tail = rest;
+            rest = rest->right;
+            ++length;
+        }
+        else                            // rotate left child up
+        {
+            Node *pivot = rest->left;
+
+            rest->left = pivot->right;
+            pivot->right = rest;
+            rest = pivot;
+            tail->right = pivot;
+        } // end if (rest->left == NULL)
+    } // end while (rest != NULL)
+
+    if (length > 0)
+    {
+        // the bottom level holds whatever a perfect tree cannot
+        while (full <= length + 1)
+        {
+            full *= 2;
+        } // end while (full <= length + 1)
+
+        full /= 2;
+        compress(&pseudoRoot, length + 1 - full);
+
+        // each remaining pass halves the height of the vine
+        for (int vine = full - 1; vine > 1; vine /= 2)
+        {
+            compress(&pseudoRoot, vine / 2);
+        } // end for (int vine = full - 1)
+    } // end if (length > 0)
+
+    if (length > 0 || dropped > 0)
+    {
+        root = pseudoRoot.right;        // NULL if only tombstones were left
+        refreshAll(root);
+        indexed = false;                // shape may differ from packed keys
+        deadCount -= dropped;
+    } // end if (length > 0 || dropped > 0)
+} // end rebalance()
+
+/**---------------------- compact() -------------------------------------------
+ * Frees the tombstones left by remove() in a LAZY tree, in one linear pass,
+ * by rebalancing the tree: each tombstone is unlinked as the vine is built.
+ * A tree without tombstones is left as it is.
+ * @pre None.
+ * @post This tree holds the same items as before and no tombstones; if any
+ *       were freed, it has minimal height.
+ */
+void BinTree::compact(void)
+{
+    if (deadCount > 0)
+    {
+        rebalance();
+    } // end if (deadCount > 0)
+} // end compact()
+
+/**---------------------- compress() ------------------------------------------
+ * Performs one pass of the Day-Stout-Warren vine compression, rotating left
+ * every other node down the right spine below vineTop.
+ * @param vineTop  The node above the portion of the vine to compress.
+ * @param count  The number of left rotations to perform.
+ * @pre The right spine below vineTop has at least 2 * count nodes.
+ * @post count nodes on the spine have become left children of their former
+ *       right children; stored heights are not updated.
+ */
+void BinTree::compress(Node *vineTop, int count)
+{
+    Node *scanner = vineTop;
+
+    for (int i = 0; i < count; ++i)
+    {
+        Node *child = scanner->right;
+
+        scanner->right = child->right;
+        scanner = scanner->right;
+        child->right = scanner->left;
+        scanner->left = child;
+    } // end for (int i = 0)
+} // end compress(Node*, int)
+
+/**---------------------- refreshAll() ----------------------------------------
+ * Recomputes the height, count, and hash stored in every node of a subtree
+ * with a postorder traversal, after a restructuring that did not maintain
+ * them.
+ * @param treePtr  The root of the subtree to update; may be NULL.
+ * @pre None.
+ * @post The heights, counts, and hashes stored throughout the subtree are
+ *       current.
+ */
+void BinTree::refreshAll(Node *treePtr)
+{
+    vector<Node*> ancestors;
+    Node         *lastDone = NULL;      // most recently refreshed node
+
+    while (treePtr != NULL || !ancestors.empty())
+    {
+        if (treePtr != NULL)            // defer current node; go left
+        {
+            ancestors.push_back(treePtr);
+            treePtr = treePtr->left;
+        }
+        else
+        {
+            Node *top = ancestors.back();
+
+            if (top->right != NULL && top->right != lastDone)
+            {
+                treePtr = top->right;   // right subtree not yet done
+            }
+            else                        // both subtrees done
+            {
+                refresh(top);
+                lastDone = top;
+                ancestors.pop_back();
+            } // end if (top->right != NULL && ...)
+        } // end if (treePtr != NULL)
+    } // end while (treePtr != NULL || !ancestors.empty())
+} // end refreshAll(Node*)
+
+/**---------------------- setRebalanceFactor() --------------------------------
+ * Arranges for rebalance() to be called automatically by insert() whenever the
+ * height of this tree grows beyond factor * log2(size()). Sorted input makes
+ * this happen repeatedly, so BALANCED is better suited to it; the factor is
+ * meant to catch a tree that gradually drifts out of shape.
+ * @param factor  The multiple of log2(size()) that the height may reach, or 0
+ *        to disable automatic rebalancing.
+ * @pre factor is 0 or greater than 1.
+ * @post Later insertions keep the height of this tree within the given bound.
+ */
+void BinTree::setRebalanceFactor(double factor)
+{
+    rebalanceFactor = factor;
+} // end setRebalanceFactor(double)
+
+/**---------------------- isTooTall() -----------------------------------------
+ * Determines whether this tree has outgrown the bound set by
+ * setRebalanceFactor().
+ * @pre None.
+ * @post This tree remains unchanged.
+ * @return true if automatic rebalancing is enabled and the height exceeds
+ *         rebalanceFactor * log2(nodeCount); false, otherwise.
+ */
+bool BinTree::isTooTall(void) const
+{
+    bool tooTall = false;
+
+    // small trees are cheap to search whatever their shape
+    if (rebalanceFactor > 0 && nodeCount > 2)
+    {
+        tooTall = heightOf(root) > rebalanceFactor * log2(nodeCount);
+    } // end if (rebalanceFactor > 0 && nodeCount > 2)
+
+    return tooTall;
+} // end isTooTall()
+
+/**---------------------- freeze() --------------------------------------------
+ * Packs the items of a binary search tree into one contiguous array in
+ * Eytzinger order: the root at index 1 and the children of index k at 2k and
+ * 2k + 1. The nodes are relinked into the same complete shape, so the tree
+ * itself is unchanged in content, while retrieve() and getDepth() search the
+ * array without branching on comparisons and in-order output reads it
+ * directly. Tombstones are compacted first. The first insert, removal, or
+ * rebalance() thaws the tree, which then goes back to searching its nodes;
+ * the array lives on until the tree is emptied.
+ * @pre None.
+ * @post This tree holds the same items as before, in a complete tree whose
+ *       items are stored contiguously; isFrozen() is true unless this tree is
+ *       empty or memory could not be allocated.
+ */
+void BinTree::freeze(void)
+{
+    size_t        count = nodeCount;
+    vector<Node*> sorted;               // nodes in ascending order
+    vector<Node*> placed;               // node given each array index
+    vector<Node*> ancestors;            // stack for the inorder traversal
+    shared_ptr< vector<NodeData> > keys;
+    bool          ready;
+
+    compact();                          // tombstones take no place in the array
+    ready = (root != NULL && deadCount == 0);
+
+    // everything is allocated up front, so a failure changes nothing
+    try
+    {
+        if (ready && (options & SHARED))
+        {
+            unshareAll(root);           // other trees keep their nodes
+        } // end if (ready && (options & SHARED))
+
+        if (ready)
+        {
+            sorted.reserve(count);
+            placed.resize(count + 1, NULL);
+            ancestors.reserve(heightOf(root));
+            keys.reset(new vector<NodeData>(count + 1));
+        } // end if (ready)
+    }
+    catch (bad_alloc e)
+    {
+        cerr << "Could not allocate memory: freeze() failed.";
+        ready = false;
+    } // end try
+
+    if (ready)
+    {
+        Node  *treePtr = root;
+        size_t index = firstIndex(count);
+
+        // collect the nodes in sorted order
+        while (treePtr != NULL || !ancestors.empty())
+        {
+            if (treePtr != NULL)        // defer current node; go left
+            {
+                ancestors.push_back(treePtr);
+                treePtr = treePtr->left;
+            }
+            else                        // left subtree done
+            {
+                treePtr = ancestors.back();
+                ancestors.pop_back();
+                sorted.push_back(treePtr);
+                treePtr = treePtr->right;
+            } // end if (treePtr != NULL)
+        } // end while (treePtr != NULL || !ancestors.empty())
+
+        // the array positions, visited in order, take the items in order
+        for (size_t i = 0; i < count; ++i)
+        {
+            treePtr = sorted[i];
+            (*keys)[index] = std::move(*treePtr->data);
+            releaseData(treePtr);
+            treePtr->data = &(*keys)[index];
+            treePtr->store = FROZEN_DATA;
+            placed[index] = treePtr;
+            index = nextIndex(index, count);
+        } // end for (size_t i = 0)
+
+        // link each node to the nodes at its children's positions, bottom up
+        for (index = count; index > 0; --index)
+        {
+            treePtr = placed[index];
+            treePtr->left = (2 * index <= count ? placed[2 * index] : NULL);
+            treePtr->right = (2 * index + 1 <= count ? placed[2 * index + 1]
+                                                    : NULL);
+            refresh(treePtr);
+        } // end for (index = count)
+
+        root = placed[1];
+        frozen = keys;                  // nodes of an earlier freeze are moved
+        indexed = true;
+        forgetCached();                 // every item was moved into keys
+    } // end if (ready)
+} // end freeze()
+
+/**---------------------- isFrozen() ------------------------------------------
+ * Determines whether a binary search tree is searched through the array
+ * packed by freeze().
+ * @pre None.
+ * @post This tree remains unchanged.
+ * @return true if freeze() has been called and the tree has not changed since;
+ *         false, otherwise.
+ */
+bool BinTree::isFrozen(void) const
+{
+    return indexed;
+} // end isFrozen()
+
+/**---------------------- save() ----------------------------------------------
+ * Writes the items of a binary search tree to a binary snapshot file: a
+ * header, then each key in sorted order, prefixed by its length, then,
+ * optionally, the offsets of the keys in the Eytzinger order of freeze(). A
+ * TreeSnapshot may search the file in place, and load() reads it back.
+ * @param fileName  The name of the file to be written.
+ * @param layout  Whether to write the Eytzinger offsets as well.
+ * @pre NodeData provides the view() method.
+ * @post The file holds every item of this tree; this tree remains unchanged.
+ * @return true if the file was written; false if it could not be.
+ */
+bool BinTree::save(const char *fileName, bool layout) const
+{
+    static const char padding[sizeof(uint64_t)] = { 0 };
+    SnapshotHeader    header;
+    vector<uint64_t>  offsets;          // key offsets, in Eytzinger order
+    size_t            count = nodeCount;
+    size_t            index = firstIndex(count);
+    uint64_t          position = sizeof(header);
+    FILE             *output = fopen(fileName, "wb");
+    bool              success = (output != NULL);
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, "BINTREE", sizeof(header.magic));
+    header.version = SnapshotHeader::VERSION;
+    header.byteOrder = SnapshotHeader::ORDER_MARK;
+    header.count = count;
+    header.keysOffset = position;
+
+    try
+    {
+        if (success && layout)
+        {
+            offsets.resize(count + 1, 0);
+        } // end if (success && layout)
+    }
+    catch (bad_alloc e)
+    {
+        cerr << "Could not allocate memory: save() failed.";
+        success = false;
+    } // end try
+
+    // the header is written again once the sections are measured
+    success = success && fwrite(&header, sizeof(header), 1, output) == 1;
+
+    for (const_iterator it = begin(); success && it != end(); ++it)
+    {
+        string_view key = it->view();
+        uint32_t    size = static_cast<uint32_t>(key.size());
+
+        success = fwrite(&size, sizeof(size), 1, output) == 1
+                  && fwrite(key.data(), 1, size, output) == size;
+
+        if (layout)
+        {
+            offsets[index] = position;
+            index = nextIndex(index, count);
+        } // end if (layout)
+
+        position += sizeof(size) + size;
+    } // end for (const_iterator it = begin())
+
+    header.keysBytes = position - header.keysOffset;
+
+    if (success && layout)
+    {
+        size_t pad = (sizeof(uint64_t) - position % sizeof(uint64_t))
+                     % sizeof(uint64_t);
+
+        header.layoutOffset = position + pad;
+        success = fwrite(padding, 1, pad, output) == pad
+                  && fwrite(offsets.data(), sizeof(uint64_t), count + 1,
+                            output) == count + 1;
+    } // end if (success && layout)
+
+    success = success && fseek(output, 0, SEEK_SET) == 0
+              && fwrite(&header, sizeof(header), 1, output) == 1;
+
+    if (output != NULL)
+    {
+        success = (fclose(output) == 0) && success;
+    } // end if (output != NULL)
+
+    return success;
+} // end save(const char*, bool)
+
+/**---------------------- load() ----------------------------------------------
+ * Replaces the contents of a binary search tree with the items of a snapshot
+ * file written by save(). The keys are stored in sorted order, so the tree is
+ * built without comparisons, and it is frozen if the file holds a layout.
+ * @param fileName  The name of the file to be read.
+ * @pre None.
+ * @post If the file is a snapshot, this tree is balanced and holds its items;
+ *       otherwise, this tree remains unchanged.
+ * @return true if the file was loaded; false if it could not be read or
+ *         memory could not be allocated.
+ */
+bool BinTree::load(const char *fileName)
+{
+    TreeSnapshot      snapshot(fileName);
+    vector<NodeData*> items;
+    bool              success = snapshot.isOpen();
+
+    try
+    {
+        if (success)
+        {
+            items.reserve(snapshot.size());
+
+            for (TreeSnapshot::const_iterator it = snapshot.begin();
+                                              it != snapshot.end(); ++it)
+            {
+                items.push_back(NULL);
+                items.back() = new NodeData(*it);
+            } // end for (TreeSnapshot::const_iterator it = snapshot.begin())
+        } // end if (success)
+    }
+    catch (bad_alloc e)
+    {
+        for (size_t i = 0; i < items.size(); ++i)
+        {
+            delete items[i];
+        } // end for (size_t i = 0)
+
+        cerr << "Could not allocate memory: load() failed.";
+        success = false;
+    } // end try
+
+    if (success)
+    {
+        build(items.data(), static_cast<int>(items.size()));
+
+        if (snapshot.hasLayout())
+        {
+            freeze();
+        } // end if (snapshot.hasLayout())
+    } // end if (success)
+
+    return success;
+} // end load(const char*)
+
+/**---------------------- depth() ---------------------------------------------
+ * Determines the depth of a node in a binary search tree. If the data is found
+ * at the root, the depth is 1. If the data is not found, the depth is 0. The
+ * item is sought by following the comparison path from the root, so the cost
+ * is bounded by the height of the tree.
+ * @param treePtr  The root of the subtree in which to search.
+ * @param dataItem  The item to locate in the tree.
+ * @pre treePtr points to a binary search tree; NodeData provides the
+ *      compare() method.
+ * @post This tree remains unchanged.
+ * @return The depth of the node containing dataItem, relative to treePtr, if
+ *         found; 0 the item is not found.
+ */
+int BinTree::depth(const Node *treePtr, const NodeData& dataItem) const
+{
+    int level = 0;          // remains 0 if a leaf is hit: item not found
+    int steps = 1;          // depth of treePtr relative to the starting node
+
+    // descend one level per comparison until the item or a leaf is reached
+    while (treePtr != NULL && level == 0)
+    {
+        int order = dataItem.compare(*treePtr->data);
+
+        BINTREE_COUNT(retrieveVisits, 1);
+        BINTREE_COUNT(comparisons, 1);
+
+        if (order == 0 && !treePtr->dead)      // item found at this level
+        {
+            level = steps;
+        }
+        else if (order == 0)    // item was removed
+        {
+            treePtr = NULL;
+        }
+        else
+        {
+            treePtr = (order < 0 ? treePtr->left : treePtr->right);
+            ++steps;
+        } // end if (order == 0)
+    } // end while (treePtr != NULL && level == 0)
+
+    return level;
+} // end depth(Node*, NodeData&)
+
+/**---------------------- bstreeToArray() -------------------------------------
+ * Fills an array of NodeData* by using an inorder traversal of the tree. The
+ * tree is left empty. The size of the array is not checked and is assumed to
+ * be sufficient to contain every element in the tree.
+ * @param target[]  The array to fill with the NodeData* from this tree.
+ * @pre target[] has room for at least size() elements.
+ * @post target[] contains every element found in this tree, in sorded order,
+ *       starting at index 0; this tree is empty.
+ */
+void BinTree::bstreeToArray(NodeData *target[])
+{
+    bstreeToArray(target, nodeCount);
+} // end bstreeToArray(NodeData*[])
+
+/**---------------------- bstreeToArray() -------------------------------------
+ * Fills an array of NodeData* of known capacity by using an inorder traversal
+ * of the tree. The tree is left empty, unless the array is too small, in
+ * which case nothing is moved. A SHARED tree first copies any nodes it still
+ * shares, so that other trees keep their data.
+ * @param target[]  The array to fill with the NodeData* from this tree.
+ * @param capacity  The number of elements target[] has room for.
+ * @pre None.
+ * @post If capacity >= size(), target[] contains every element found in this
+ *       tree, in sorted order, starting at index 0, and this tree is empty;
+ *       otherwise, both remain unchanged.
+ * @return The number of elements placed in target[].
+ */
+int BinTree::bstreeToArray(NodeData *target[], int capacity)
+{
+    int  index = 0;
+    bool movable = (capacity >= nodeCount);
+
+    if (movable && (options & SHARED))
+    {
+        try
+        {
+            unshareAll(root);       // other trees keep their data
+        }
+        catch (bad_alloc e)
+        {
+            cerr << "Could not allocate memory: bstreeToArray() failed.";
+            movable = false;
+        } // end try
+    } // end if (movable && (options & SHARED))
+
+    if (movable)
+    {
+        inorderToArray(root, target, index);
+        makeEmpty();
+    } // end if (movable)
+
+    return index;
+} // end bstreeToArray(NodeData*[], int)
+
+/**---------------------- bstreeToArray() -------------------------------------
+ * Appends the NodeData* from this tree to a growable buffer, in sorted order,
+ * by using an inorder traversal of the tree. The tree is left empty.
+ * @param target  The buffer to which to append the NodeData* from this tree.
+ * @pre None.
+ * @post target ends with every element found in this tree, in sorted order;
+ *       this tree is empty.
+ * @return The number of elements appended to target.
+ */
+int BinTree::bstreeToArray(vector<NodeData*>& target)
+{
+    int start = static_cast<int>(target.size());
+    int index = 0;
+
+    if (nodeCount > 0)
+    {
+        target.resize(start + nodeCount);       // one allocation at most
+        index = bstreeToArray(&target[start], nodeCount);
+        target.resize(start + index);           // nothing moved on failure
+    } // end if (nodeCount > 0)
+
+    return index;
+} // end bstreeToArray(vector<NodeData*>&)
+
+/**---------------------- inorderToArray() ------------------------------------
+ * Traverses a binary search tree in sorted order and moves each data element
+ * into an array of NodeData*. The size of targe[] is assumed to be sufficient
+ * to contain all elements in the subtree. Ancestors whose data is still to be
+ * moved are kept on an explicit stack.
+ * @param treePtr  The root of a subtree to move into an array.
+ * @param target[]  An array to move a subtree into.
+ * @param index  The index at which to insert the next item into the array.
+ * @pre target[] is large enough to contain every element in the subtree; the
+ *      initial call to this method is proceeded by destroyTree().
+ * @post target[] contains every data item from the subtree in sorted order;
+ *       data pointers in the subree are NULL.
+ * @note This tree MUST be emptied after calling this method, or it will not be
+ *       a binary search tree.
+ */
+void BinTree::inorderToArray(Node *treePtr, NodeData *target[], int& index)
+{
+    vector<Node*> ancestors;
+
+    ancestors.reserve(heightOf(treePtr));
+
+    while (treePtr != NULL || !ancestors.empty())
+    {
+        if (treePtr != NULL)        // defer current data; go left
+        {
+            ancestors.push_back(treePtr);
+            treePtr = treePtr->left;
+        }
+        else                        // left subtree done
+        {
+            treePtr = ancestors.back();
+            ancestors.pop_back();
+
+            if (!treePtr->dead)     // tombstones are freed with the tree
+            {
+                target[index++] = detachData(treePtr);
+            } // end if (!treePtr->dead)
+
+            treePtr = treePtr->right;
+        } // end if (treePtr != NULL)
+    } // end while (treePtr != NULL || !ancestors.empty())
+} // end inorderTransfer(Node*, NodeData*[])
+
+/**---------------------- arrayToBSTree() -------------------------------------
+ * Populates this tree from the contents of an array of sorted NodeData*,
+ * terminated by the first NULL element. Any contents of this tree are removed
+ * beforehand. The new tree is balanced by linking the middle element of each
+ * segment of the array as the root of its subtree.
+ * @param source[]  The array from which to populate this tree.
+ * @pre source[] is sorted in ascending order and has a NULL element after the
+ *      last item.
+ * @post This tree is balanced and contains all NodeData* that were contained
+ *       in source[]; all elements of source[] are now NULL.
+ */
+void BinTree::arrayToBSTree(NodeData *source[])
+{
+    int count;
+
+    // find last element, assuming contiguous data
+    for (count = 0; source[count] != NULL; ++count)
+    {
+    } // end for (count = 0)
+
+    build(source, count);               // build a balanced tree
+} // end arrayToBSTree(NodeData*[])
+
+/**---------------------- arrayToBSTree() -------------------------------------
+ * Populates this tree from the contents of an array of sorted NodeData* of
+ * known length, in one linear pass. Any contents of this tree are removed
+ * beforehand. This is build(), which also accepts unsorted arrays.
+ * @param source[]  The array from which to populate this tree.
+ * @param count  The number of elements in source[].
+ * @pre source[] holds count distinct, non-NULL pointers.
+ * @post This tree is balanced and contains all NodeData* that were contained
+ *       in source[]; all elements of source[] are now NULL.
+ * @return The number of items in this tree.
+ */
+int BinTree::arrayToBSTree(NodeData *source[], int count)
+{
+    return build(source, count);
+} // end arrayToBSTree(NodeData*[], int)
+
+/**---------------------- build() ---------------------------------------------
+ * Populates this tree from an array of NodeData*, taking ownership of them.
+ * Any contents of this tree are removed beforehand. If the array is not
+ * already in strictly ascending order, it is sorted and duplicates are
+ * deleted. The nodes are then linked into a perfectly balanced tree without
+ * further comparisons, so sorted input is loaded in O(n).
+ * @param source[]  The array from which to populate this tree.
+ * @param count  The number of elements in source[].
+ * @pre source[] holds count distinct, non-NULL pointers.
+ * @post This tree is balanced and holds one item for every distinct value in
+ *       source[]; source[] is in ascending order with every element NULL.
+ * @return The number of items in this tree.
+ */
+int BinTree::build(NodeData *source[], int count)
+{
+    int unique = count;
+
+    makeEmpty();
+
+    if (!isStrictlySorted(source, count))
+    {
+        sort(source, source + count, precedes);
+        unique = 0;
+
+        // keep the first of each run of equal items
+        for (int i = 0; i < count; ++i)
+        {
+            if (unique > 0 && source[unique - 1]->compare(*source[i]) == 0)
+            {
+                delete source[i];
+            }
+            else
+            {
+                source[unique++] = source[i];
+            } // end if (unique > 0 && ...)
+        } // end for (int i = 0)
+
+        for (int i = unique; i < count; ++i)
+        {
+            source[i] = NULL;       // duplicates were deleted
+        } // end for (int i = unique)
+    } // end if (!isStrictlySorted(source, count))
+
+    if (!forkLink(root, source, source, 0, unique - 1, forkLevels(),
+                  nodeCount))
+    {
+        cerr << "Could not allocate memory: build() failed.";
+    } // end if (!forkLink(root, source, source, ...))
+
+    return nodeCount;
+} // end build(NodeData*[], int)
+
+/**---------------------- build() ---------------------------------------------
+ * Populates this tree with copies of the items in an array. Any contents of
+ * this tree are removed beforehand. If the array is not already in strictly
+ * ascending order, a sorted view of it is used and duplicates are skipped.
+ * The copies are linked into a perfectly balanced tree without further
+ * comparisons, so sorted input is loaded in O(n).
+ * @param source[]  The array of values from which to populate this tree.
+ * @param count  The number of elements in source[].
+ * @pre source[] holds count elements.
+ * @post This tree is balanced and holds a copy of every distinct value in
+ *       source[]; source[] remains unchanged.
+ * @return The number of items in this tree.
+ */
+int BinTree::build(const NodeData source[], int count)
+{
+    vector<const NodeData*> view(count);
+    int unique = count;
+
+    makeEmpty();
+
+    for (int i = 0; i < count; ++i)
+    {
+        view[i] = &source[i];
+    } // end for (int i = 0)
+
+    if (count > 0 && !isStrictlySorted(&view[0], count))
+    {
+        sort(view.begin(), view.end(), precedes);
+        unique = 0;
+
+        // keep the first of each run of equal items
+        for (int i = 0; i < count; ++i)
+        {
+            if (unique == 0 || view[unique - 1]->compare(*view[i]) != 0)
+            {
+                view[unique++] = view[i];
+            } // end if (unique == 0 || ...)
+        } // end for (int i = 0)
+    } // end if (count > 0 && ...)
+
+    if (unique > 0 && !forkLink(root, &view[0], NULL, 0, unique - 1,
+                                forkLevels(), nodeCount))
+    {
+        cerr << "Could not allocate memory: build() failed.";
+    } // end if (unique > 0 && ...)
+
+    return nodeCount;
+} // end build(NodeData[], int)
+
+/**---------------------- linkSorted() ----------------------------------------
+ * Links a balanced subtree holding the items of a sorted array segment, using
+ * the middle item as its root. No items are compared.
+ * @param treePtr  A container for the root of the new subtree.
+ * @param items[]  The values to be held, in strictly ascending order.
+ * @param owned[]  Heap objects equal to items[] that this tree may keep, or
+ *        NULL if the values of items[] must be copied.
+ * @param low  The lower bound of the segment to link.
+ * @param high  The upper bound of the segment to link.
+ * @param linked  A counter to which every node linked is added.
+ * @pre treePtr is NULL.
+ * @post treePtr points to a balanced subtree of every item in the segment,
+ *       with current heights; elements of owned[] in the segment are NULL;
+ *       linked includes every node linked.
+ * @throw bad_alloc if memory could not be allocated; treePtr then points to
+ *        the part of the subtree linked so far.
+ */
+void BinTree::linkSorted(Node *& treePtr, const NodeData *const items[],
+                         NodeData *owned[], int low, int high, int& linked)
+{
+    if (low <= high)                    // base case check
+    {
+        int mid = low + (high - low) / 2;
+
+        // middle element is subtree root
+        treePtr = makeLeaf(*items[mid],
+                           owned == NULL ? NULL : owned[mid], NULL);
+        ++linked;
+
+        if (owned != NULL)
+        {
+            owned[mid] = NULL;          // array emptied as tree is built
+        } // end if (owned != NULL)
+
+        linkSorted(treePtr->left, items, owned, low, mid - 1, linked);
+        linkSorted(treePtr->right, items, owned, mid + 1, high, linked);
+        refresh(treePtr);
+    } // end if (low <= high)
+} // end linkSorted(Node*&, NodeData*[], NodeData*[], int, int, int&)
+
+/**---------------------- forkLevels() ----------------------------------------
+ * Determines how many levels from the root may fork their subtrees onto the
+ * shared TaskPool: enough to give every worker a few pieces of work. Only a
+ * PARALLEL tree without a pool forks, since a NodePool is not thread safe.
+ * @pre None.
+ * @post This tree remains unchanged.
+ * @return The number of levels that may fork; 0 if this tree does not.
+ */
+int BinTree::forkLevels(void) const
+{
+    int levels = 0;
+
+    if ((options & PARALLEL) && pool == NULL)
+    {
+        // about four pieces of work per worker
+        for (int pieces = 1; pieces < 4 * TaskPool::shared().workerCount();
+             pieces *= 2)
+        {
+            ++levels;
+        } // end for (int pieces = 1)
+    } // end if ((options & PARALLEL) && pool == NULL)
+
+    return levels;
+} // end forkLevels()
+
+/**---------------------- forkCopy() ------------------------------------------
+ * Copies the tree rooted at treePtr into a tree rooted at newTreePtr. For the
+ * top levels, a node whose subtrees are both at least PARALLEL_HEIGHT tall
+ * is copied here while its left subtree is copied by another thread; any
+ * other subtree is copied by copyTree().
+ * @param treePtr  The root of the tree to be copied.
+ * @param newTreePtr  A container for the root of a copy of treePtr.
+ * @param level  The number of levels below which nothing forks.
+ * @pre There is sufficient memory to allocate a new tree.
+ * @post newTreePtr points to the root of a structural copy of the tree whose
+ *       root is pointed to by treePtr.
+ * @return The number of live items copied, which leaves out tombstones.
+ */
+int BinTree::forkCopy(Node *treePtr, Node *& newTreePtr, int level) const
+{
+    int copied = 0;
+
+    if (level > 0 && treePtr != NULL
+        && heightOf(treePtr->left) >= PARALLEL_HEIGHT
+        && heightOf(treePtr->right) >= PARALLEL_HEIGHT)
+    {
+        TaskPool::Group group;
+        int leftCopied = 0;
+
+        newTreePtr = NULL;
+
+        try
+        {
+            newTreePtr = makeLeaf(*treePtr->data, NULL, NULL);
+            newTreePtr->height = treePtr->height;
+            newTreePtr->hash = treePtr->hash;
+            newTreePtr->dead = treePtr->dead;
+            newTreePtr->count = treePtr->count;
+            copied = (treePtr->dead ? 0 : 1);
+        }
+        catch (bad_alloc e)
+        {
+            cerr << "Could not allocate memory: copyTree() failed.";
+        } // end try
+
+        if (newTreePtr != NULL)
+        {
+            Node *copy = newTreePtr;
+
+            TaskPool::shared().spawn(group, [this, treePtr, copy, level,
+                                             &leftCopied]
+            {
+                leftCopied = forkCopy(treePtr->left, copy->left, level - 1);
+            });
+
+            copied += forkCopy(treePtr->right, copy->right, level - 1);
+            TaskPool::shared().wait(group);
+            copied += leftCopied;
+        } // end if (newTreePtr != NULL)
+    }
+    else
+    {
+        copied = copyTree(treePtr, newTreePtr);
+    } // end if (level > 0 && treePtr != NULL && ...)
+
+    return copied;
+} // end forkCopy(Node*, Node*&, int)
+
+/**---------------------- forkDestroy() ---------------------------------------
+ * Deallocates memory for a tree. For the top levels, a node whose subtrees
+ * are both at least PARALLEL_HEIGHT tall has its left subtree freed by
+ * another thread while its right subtree is freed here; any other subtree is
+ * freed by destroyTree().
+ * @param treePtr  Pointer to the root of the tree to be deallocated.
+ * @param level  The number of levels below which nothing forks.
+ * @pre No node of the tree is shared with another tree, if level > 0.
+ * @post treePtr points to an empty tree.
+ */
+void BinTree::forkDestroy(Node *& treePtr, int level)
+{
+    if (level > 0 && treePtr != NULL
+        && heightOf(treePtr->left) >= PARALLEL_HEIGHT
+        && heightOf(treePtr->right) >= PARALLEL_HEIGHT)
+    {
+        TaskPool::Group group;
+        Node *subtree = treePtr;
+
+        TaskPool::shared().spawn(group, [this, subtree, level]
+        {
+            forkDestroy(subtree->left, level - 1);
+        });
+
+        forkDestroy(subtree->right, level - 1);
+        TaskPool::shared().wait(group);
+        freeNode(subtree);              // both subtrees are gone
+        treePtr = NULL;
+    }
+    else
+    {
+        destroyTree(treePtr);
+    } // end if (level > 0 && treePtr != NULL && ...)
+} // end forkDestroy(Node*&, int)
+
+/**---------------------- forkLink() ------------------------------------------
+ * Links a balanced subtree holding the items of a sorted array segment, as
+ * linkSorted() does. For the top levels, a segment of at least PARALLEL_ITEMS
+ * items has its left half linked by another thread.
+ * @param treePtr  A container for the root of the new subtree.
+ * @param items[]  The values to be held, in strictly ascending order.
+ * @param owned[]  Heap objects equal to items[] that this tree may keep, or
+ *        NULL if the values of items[] must be copied.
+ * @param low  The lower bound of the segment to link.
+ * @param high  The upper bound of the segment to link.
+ * @param level  The number of levels below which nothing forks.
+ * @param linked  A counter to which every node linked is added.
+ * @pre treePtr is NULL.
+ * @post treePtr points to a balanced subtree of every item in the segment,
+ *       with current heights, unless memory ran out; elements of owned[]
+ *       that were linked are NULL; linked includes every node linked.
+ * @return true if every item was linked; false if memory ran out.
+ */
+bool BinTree::forkLink(Node *& treePtr, const NodeData *const items[],
+                       NodeData *owned[], int low, int high, int level,
+                       int& linked)
+{
+    bool success = true;
+
+    if (level > 0 && high - low + 1 >= PARALLEL_ITEMS)
+    {
+        TaskPool::Group group;
+        int  mid = low + (high - low) / 2;
+        int  leftLinked = 0;
+        bool leftSuccess = true;
+
+        try
+        {
+            treePtr = makeLeaf(*items[mid],
+                               owned == NULL ? NULL : owned[mid], NULL);
+            ++linked;
+        }
+        catch (bad_alloc e)
+        {
+            success = false;
+        } // end try
+
+        if (success)
+        {
+            Node *subtree = treePtr;
+
+            if (owned != NULL)
+            {
+                owned[mid] = NULL;      // array emptied as tree is built
+            } // end if (owned != NULL)
+
+            TaskPool::shared().spawn(group, [&, subtree]
+            {
+                leftSuccess = forkLink(subtree->left, items, owned, low,
+                                       mid - 1, level - 1, leftLinked);
+            });
+
+            success = forkLink(subtree->right, items, owned, mid + 1, high,
+                               level - 1, linked);
+            TaskPool::shared().wait(group);
+            linked += leftLinked;
+            success = success && leftSuccess;
+            refresh(subtree);
+        } // end if (success)
+    }
+    else
+    {
+        try
+        {
+            linkSorted(treePtr, items, owned, low, high, linked);
+        }
+        catch (bad_alloc e)
+        {
+            success = false;
+        } // end try
+    } // end if (level > 0 && high - low + 1 >= PARALLEL_ITEMS)
+
+    return success;
+} // end forkLink(Node*&, NodeData*[], NodeData*[], int, int, int, int&)
+
+/**---------------------- begin() ---------------------------------------------
+ * Locates the smallest item in a binary search tree.
+ * @pre None.
+ * @post This tree remains unchanged.
+ * @return An iterator at the smallest item; end() if this tree is empty.
+ */
+BinTree::const_iterator BinTree::begin(void) const
+{
+    const_iterator first(root);
+
+    for (const Node *treePtr = root; treePtr != NULL; treePtr = treePtr->left)
+    {
+        first.descend(treePtr);
+    } // end for (const Node *treePtr = root)
+
+    if (first.current != NULL && first.current->dead)
+    {
+        ++first;                        // smallest live item lies beyond
+    } // end if (first.current != NULL && first.current->dead)
+
+    return first;
+} // end begin()
+
+/**---------------------- end() -----------------------------------------------
+ * Provides the position one past the largest item in a binary search tree.
+ * @pre None.
+ * @post This tree remains unchanged.
+ * @return An iterator that may be decremented to reach the largest item, but
+ *         may not be dereferenced.
+ */
+BinTree::const_iterator BinTree::end(void) const
+{
+    return const_iterator(root);
+} // end end()
+
+/**---------------------- lower_bound() ---------------------------------------
+ * Locates the first item in a binary search tree that is not less than a key,
+ * following a single comparison path from the root.
+ * @param searchItem  The key to compare items with.
+ * @pre NodeData provides the compare() method.
+ * @post This tree remains unchanged.
+ * @return An iterator at the smallest item >= searchItem; end() if every item
+ *         is less than searchItem.
+ */
+BinTree::const_iterator BinTree::lower_bound(const NodeData& searchItem) const
+{
+    const_iterator bound(root);
+    const Node    *treePtr = root;
+    const Node    *candidate = NULL;    // smallest item >= searchItem so far
+    int            steps = 0;           // depth of treePtr
+    int            keep = 0;            // depth of candidate
+
+    while (treePtr != NULL)
+    {
+        int order = searchItem.compare(*treePtr->data);
+
+        bound.descend(treePtr);
+        ++steps;
+
+        if (order <= 0)     // treePtr qualifies; look for a smaller one
+        {
+            candidate = treePtr;
+            keep = steps;
+            treePtr = (order == 0 ? NULL : treePtr->left);
+        }
+        else
+        {
+            treePtr = treePtr->right;
+        } // end if (order <= 0)
+    } // end while (treePtr != NULL)
+
+    bound.moveTo(candidate, keep);
+
+    if (candidate != NULL && candidate->dead)
+    {
+        ++bound;                        // next live item qualifies too
+    } // end if (candidate != NULL && candidate->dead)
+
+    return bound;
+} // end lower_bound(NodeData&)
+
+/**---------------------- upper_bound() ---------------------------------------
+ * Locates the first item in a binary search tree that is greater than a key,
+ * following a single comparison path from the root.
+ * @param searchItem  The key to compare items with.
+ * @pre NodeData provides the compare() method.
+ * @post This tree remains unchanged.
+ * @return An iterator at the smallest item > searchItem; end() if no item is
+ *         greater than searchItem.
+ */
+BinTree::const_iterator BinTree::upper_bound(const NodeData& searchItem) const
+{
+    const_iterator bound(root);
+    const Node    *treePtr = root;
+    const Node    *candidate = NULL;    // smallest item > searchItem so far
+    int            steps = 0;           // depth of treePtr
+    int            keep = 0;            // depth of candidate
+
+    while (treePtr != NULL)
+    {
+        bound.descend(treePtr);
+        ++steps;
+
+        if (searchItem.compare(*treePtr->data) < 0)    // treePtr qualifies
+        {
+            candidate = treePtr;
+            keep = steps;
+            treePtr = treePtr->left;
+        }
+        else
+        {
+            treePtr = treePtr->right;
+        } // end if (searchItem.compare(*treePtr->data) < 0)
+    } // end while (treePtr != NULL)
+
+    bound.moveTo(candidate, keep);
+
+    if (candidate != NULL && candidate->dead)
+    {
+        ++bound;                        // next live item qualifies too
+    } // end if (candidate != NULL && candidate->dead)
+
+    return bound;
+} // end upper_bound(NodeData&)
+
+/**---------------------- rank() ----------------------------------------------
+ * Determines how many items of a binary search tree are less than a key,
+ * which is the position the key has or would have in sorted order. Each node
+ * counts the items below it, so one comparison path from the root suffices.
+ * @param searchItem  The key to compare items with.
+ * @pre NodeData provides the compare() method.
+ * @post This tree remains unchanged.
+ * @return The number of items less than searchItem, from 0 to size().
+ */
+int BinTree::rank(const NodeData& searchItem) const
+{
+    const Node *treePtr = root;
+    int         smaller = 0;            // items known to be less than the key
+
+    while (treePtr != NULL)
+    {
+        int order = searchItem.compare(*treePtr->data);
+
+        BINTREE_COUNT(comparisons, 1);
+
+        if (order > 0)      // treePtr and its left subtree are all smaller
+        {
+            smaller += countOf(treePtr->left) + (treePtr->dead ? 0 : 1);
+            treePtr = treePtr->right;
+        }
+        else if (order == 0)
+        {
+            smaller += countOf(treePtr->left);
+            treePtr = NULL;
+        }
+        else
+        {
+            treePtr = treePtr->left;
+        } // end if (order > 0)
+    } // end while (treePtr != NULL)
+
+    return smaller;
+} // end rank(NodeData&)
+
+/**---------------------- select() --------------------------------------------
+ * Locates the item of a binary search tree at a position in sorted order, by
+ * following the counts stored in the nodes from the root, without comparing
+ * items. The iterator may then be moved to read a page of items from there.
+ * @param index  The position of the item, where the smallest is at 0.
+ * @pre None.
+ * @post This tree remains unchanged.
+ * @return An iterator at the item with index smaller items; end() if index
+ *         is negative or not less than size().
+ */
+BinTree::const_iterator BinTree::select(int index) const
+{
+    const_iterator found(root);
+    const Node    *treePtr = (index >= 0 && index < countOf(root) ? root
+                                                                  : NULL);
+
+    while (treePtr != NULL)
+    {
+        int before = countOf(treePtr->left);    // items ahead of treePtr
+
+        found.descend(treePtr);
+
+        if (index < before)                     // item is to the left
+        {
+            treePtr = treePtr->left;
+        }
+        else if (index == before && !treePtr->dead)     // item is here
+        {
+            treePtr = NULL;
+        }
+        else                                    // item is to the right
+        {
+            index -= before + (treePtr->dead ? 0 : 1);
+            treePtr = treePtr->right;
+        } // end if (index < before)
+    } // end while (treePtr != NULL)
+
+    return found;
+} // end select(int)
+
+/**---------------------- equal_range() ---------------------------------------
+ * Locates the range of items in a binary search tree that are equal to a key.
+ * Since duplicates are not allowed, the range is empty or holds one item.
+ * @param searchItem  The key to compare items with.
+ * @pre NodeData provides the compare() method.
+ * @post This tree remains unchanged.
+ * @return The pair lower_bound(searchItem), upper_bound(searchItem).
+ */
+pair<BinTree::const_iterator, BinTree::const_iterator>
+    BinTree::equal_range(const NodeData& searchItem) const
+{
+    const_iterator low = lower_bound(searchItem);
+    const_iterator high = low;
+
+    // one comparison tells whether the range holds an item
+    if (high.current != NULL && searchItem.compare(*high) == 0)
+    {
+        ++high;
+    } // end if (high.current != NULL && ...)
+
+    return make_pair(low, high);
+} // end equal_range(NodeData&)
+
+/**---------------------- Default Constructor ---------------------------------
+ * Creates an iterator that belongs to no tree.
+ * @pre None.
+ * @post This iterator may be assigned to but not moved or dereferenced.
+ */
+BinTree::const_iterator::const_iterator()
+    : root(NULL), current(NULL), depth(0), deep(false)
+{
+} // end default constructor
+
+/**---------------------- Root Constructor ------------------------------------
+ * Creates an iterator at end() of the tree rooted at treePtr.
+ * @param treePtr  The root of the tree to be traversed; may be NULL.
+ * @pre None.
+ * @post This iterator is at end(); its path is empty.
+ */
+BinTree::const_iterator::const_iterator(const Node *treePtr)
+    : root(treePtr), current(NULL), depth(0), deep(false)
+{
+} // end constructor(Node*)
+
+/**---------------------- * Dereference Operator ------------------------------
+ * Provides the item at the position of this iterator.
+ * @pre This iterator is not at end().
+ * @post This iterator remains unchanged.
+ * @return A reference to the item at this position.
+ */
+BinTree::const_iterator::reference
+    BinTree::const_iterator::operator*(void) const
+{
+    return *current->data;
+} // end operator*()
+
+/**---------------------- -> Member Access Operator ---------------------------
+ * Provides the item at the position of this iterator.
+ * @pre This iterator is not at end().
+ * @post This iterator remains unchanged.
+ * @return A pointer to the item at this position.
+ */
+BinTree::const_iterator::pointer
+    BinTree::const_iterator::operator->(void) const
+{
+    return current->data;
+} // end operator->()
+
+/**---------------------- ++ Increment Operators ------------------------------
+ * Moves this iterator to the next larger item, or to end() from the largest,
+ * passing over any tombstones.
+ * @pre This iterator is not at end().
+ * @post This iterator is at the in-order successor of its former position.
+ * @return This iterator after (prefix) or before (postfix) moving.
+ */
+BinTree::const_iterator& BinTree::const_iterator::operator++(void)
+{
+    next();
+
+    while (current != NULL && current->dead)
+    {
+        next();
+    } // end while (current != NULL && current->dead)
+
+    return *this;
+} // end operator++()
+
+BinTree::const_iterator BinTree::const_iterator::operator++(int)
+{
+    const_iterator before = *this;
+
+    ++*this;
+    return before;
+} // end operator++(int)
+
+/**---------------------- -- Decrement Operators ------------------------------
+ * Moves this iterator to the next smaller item, or to the largest from end(),
+ * passing over any tombstones.
+ * @pre This iterator is not at begin().
+ * @post This iterator is at the in-order predecessor of its former position.
+ * @return This iterator after (prefix) or before (postfix) moving.
+ */
+BinTree::const_iterator& BinTree::const_iterator::operator--(void)
+{
+    previous();
+
+    while (current->dead)               // a live item lies before begin()
+    {
+        previous();
+    } // end while (current->dead)
+
+    return *this;
+} // end operator--()
+
+BinTree::const_iterator BinTree::const_iterator::operator--(int)
+{
+    const_iterator before = *this;
+
+    --*this;
+    return before;
+} // end operator--(int)
+
+/**---------------------- == Equality Operator --------------------------------
+ * Determines whether two iterators of the same tree are at the same position.
+ * @param rhs  The right-hand iterator to be compared.
+ * @pre None.
+ * @post Both iterators remain unchanged.
+ * @return true if both iterators are at the same item, or both at end();
+ *         false, otherwise.
+ */
+bool BinTree::const_iterator::operator==(const const_iterator& rhs) const
+{
+    return current == rhs.current;
+} // end operator==(const_iterator&)
+
+/**---------------------- != Inequality Operator ------------------------------
+ * Determines whether two iterators of the same tree are at different
+ * positions.
+ * @param rhs  The right-hand iterator to be compared.
+ * @pre None.
+ * @post Both iterators remain unchanged.
+ * @return false if both iterators are at the same item, or both at end();
+ *         true, otherwise.
+ */
+bool BinTree::const_iterator::operator!=(const const_iterator& rhs) const
+{
+    return current != rhs.current;
+} // end operator!=(const_iterator&)
+
+/**---------------------- descend() -------------------------------------------
+ * Moves this iterator down to a node, recording it on the path. Once the
+ * path is full, only current is kept and deep is set.
+ * @param treePtr  The node to move to.
+ * @pre treePtr is not NULL; it is a child of current, or root if this
+ *      iterator is at end() with an empty path.
+ * @post current is treePtr.
+ */
+void BinTree::const_iterator::descend(const Node *treePtr)
+{
+    if (!deep && depth < PATH_LIMIT)
+    {
+        path[depth++] = treePtr;
+    }
+    else
+    {
+        deep = true;
+    } // end if (!deep && depth < PATH_LIMIT)
+
+    current = treePtr;
+} // end descend(Node*)
+
+/**---------------------- moveTo() --------------------------------------------
+ * Moves this iterator back up a path just recorded by descend(), to the node
+ * at a given depth along it.
+ * @param treePtr  The node to move to, or NULL to move to end().
+ * @param level  The depth of treePtr on the path; 1 for the root.
+ * @pre treePtr was passed to descend() at depth level since the path was last
+ *      emptied, or is NULL.
+ * @post current is treePtr; the path is valid unless level > PATH_LIMIT.
+ */
+void BinTree::const_iterator::moveTo(const Node *treePtr, int level)
+{
+    current = treePtr;
+
+    if (treePtr == NULL)        // end() has an empty path
+    {
+        depth = 0;
+        deep = false;
+    }
+    else if (level <= PATH_LIMIT)
+    {
+        depth = level;          // entries up to level are still in place
+        deep = false;
+    } // end if (treePtr == NULL)
+} // end moveTo(Node*, int)
+
+/**---------------------- ascend() --------------------------------------------
+ * Moves this iterator up the path to the nearest ancestor of current that
+ * has current within its left (or right) subtree.
+ * @param fromLeft  true to find an ancestor reached through its left child;
+ *        false, for one reached through its right child.
+ * @pre This iterator is not deep and not at end().
+ * @post current is that ancestor, or NULL with an empty path if none exists.
+ */
+void BinTree::const_iterator::ascend(bool fromLeft)
+{
+    const Node *child = path[--depth];
+
+    while (depth > 0 &&
+           (fromLeft ? path[depth - 1]->left : path[depth - 1]->right) != child)
+    {
+        child = path[--depth];
+    } // end while (depth > 0 && ...)
+
+    current = (depth > 0 ? path[depth - 1] : NULL);
+} // end ascend(bool)
+
+/**---------------------- seek() ----------------------------------------------
+ * Moves a deep iterator to the successor (or predecessor) of current by
+ * searching from the root.
+ * @param forward  true to find the successor; false, for the predecessor.
+ * @pre This iterator is deep and not at end().
+ * @post current is the successor (or predecessor), or NULL if none exists.
+ */
+void BinTree::const_iterator::seek(bool forward)
+{
+    const Node *treePtr = root;
+    const Node *found = NULL;
+
+    while (treePtr != NULL)
+    {
+        int order = current->data->compare(*treePtr->data);
+
+        if (forward ? order < 0 : order > 0)    // treePtr is a candidate
+        {
+            found = treePtr;
+            treePtr = (forward ? treePtr->left : treePtr->right);
+        }
+        else
+        {
+            treePtr = (forward ? treePtr->right : treePtr->left);
+        } // end if (forward ? order < 0 : order > 0)
+    } // end while (treePtr != NULL)
+
+    current = found;
+
+    if (found == NULL)          // ran off the end of the tree
+    {
+        moveTo(NULL, 0);
+    } // end if (found == NULL)
+} // end seek(bool)
+
+/**---------------------- next() ----------------------------------------------
+ * Moves this iterator to the in-order successor of current, whether or not
+ * that node is a tombstone.
+ * @pre This iterator is not at end().
+ * @post current is the successor, or NULL if none exists.
+ */
+void BinTree::const_iterator::next(void)
+{
+    if (deep)                           // path was not recorded
+    {
+        seek(true);
+    }
+    else if (current->right != NULL)    // smallest item of right subtree
+    {
+        for (const Node *treePtr = current->right; treePtr != NULL;
+             treePtr = treePtr->left)
+        {
+            descend(treePtr);
+        } // end for (const Node *treePtr = current->right)
+    }
+    else                                // nearest ancestor to the right
+    {
+        ascend(true);
+    } // end if (deep)
+} // end next()
+
+/**---------------------- previous() ------------------------------------------
+ * Moves this iterator to the in-order predecessor of current, or to the
+ * largest node from end(), whether or not that node is a tombstone.
+ * @pre This iterator is not at the smallest node.
+ * @post current is the predecessor.
+ */
+void BinTree::const_iterator::previous(void)
+{
+    if (current == NULL)                // largest item of the tree
+    {
+        moveTo(NULL, 0);
+
+        for (const Node *treePtr = root; treePtr != NULL;
+             treePtr = treePtr->right)
+        {
+            descend(treePtr);
+        } // end for (const Node *treePtr = root)
+    }
+    else if (deep)                      // path was not recorded
+    {
+        seek(false);
+    }
+    else if (current->left != NULL)     // largest item of left subtree
+    {
+        for (const Node *treePtr = current->left; treePtr != NULL;
+             treePtr = treePtr->right)
+        {
+            descend(treePtr);
+        } // end for (const Node *treePtr = current->left)
+    }
+    else                                // nearest ancestor to the left
+    {
+        ascend(false);
+    } // end if (current == NULL)
+} // end previous()
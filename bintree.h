@@ -6,10 +6,20 @@
  *              556-559. Boston, MA: Pearson Education, Inc.
  * @brief   This class represents a binary search tree which holds its data in
  *          a NodeData object, to which it holds a pointer. NodeData must
- *          support ==, <, and << operators. Some specialized methods are
- *          provided for displaying the contents of the tree. There is no
- *          method for removing a single item, so the tree must be emptied to
- *          remove anything.
+ *          support compare(), ==, and <<. Some specialized methods are
+ *          provided for displaying the contents of the tree. Items may be
+ *          removed singly, or in bulk by a predicate. A tree may be
+ *          constructed in BALANCED mode, in which case it is kept height
+ *          balanced (AVL) on every insert and removal, in POOLED mode, in
+ *          which case its nodes are carved from a NodePool, in INLINE mode,
+ *          in which case each key is stored in its node, in SHARED mode, in
+ *          which case copies share nodes until changed, in PARALLEL mode, in
+ *          which case bulk operations use threads, in LAZY mode, in which
+ *          case removed items are marked and compacted later, and in CACHED
+ *          mode, in which case recently found items are found again at once.
+ *          A tree that is mostly read may be frozen, which packs its items
+ *          into one contiguous array that is searched without branching.
+ *          Keys of other types are held by SearchTree, in searchtree.h.
  * @author  Brendan Sweeney, SID 1161836
  * @date    January 20, 2012
  */
@@ -17,10 +27,17 @@
 #ifndef _BINTREE_H
 #define	_BINTREE_H
 
-#include "nodedata.h"
+#include <cstddef>          // for ptrdiff_t
+#include <iterator>         // for bidirectional_iterator_tag
+#include <memory>           // for shared_ptr, which owns frozen keys
+#include <utility>          // for pair
+#include <vector>           // growable buffers for bstreeToArray()
+
+#include <atomic>           // cache slots and counters shared by searches
 
+#include "nodedata.h"
+#include "nodepool.h"
 
-typedef void (*FunctionType)(NodeData& anItem);
 
 class BinTree
 {
@@ -39,15 +56,61 @@ class BinTree
 
 public:
 
+/**---------------------- Option ----------------------------------------------
+ * Construction options for a tree, which may be combined with bitwise or.
+ * PLAIN trees insert without rebalancing, so their shape depends on the order
+ * of insertion; BALANCED trees are kept height balanced (AVL) on every insert.
+ * POOLED trees allocate their nodes, and the NodeData copies made by copyTree,
+ * from contiguous blocks owned by the tree, which are released all at once.
+ * INLINE trees store a copy of each key inside its node, so a search touches
+ * one allocation per level; short keys then never leave the node. SHARED trees
+ * are copied in O(1) by sharing reference counted nodes; an insert then copies
+ * only the nodes on its path, and operations that restructure the whole tree
+ * first copy whatever is still shared. SHARED trees never use a pool, since
+ * their nodes may outlive the tree that allocated them. PARALLEL trees copy,
+ * destroy, and build large trees with the threads of the shared TaskPool,
+ * unless they are POOLED, and destroy sequentially if SHARED. LAZY trees mark
+ * removed items as tombstones instead of unlinking them, so a removal changes
+ * one node; the tombstones are dropped by compact(), which runs by itself once
+ * they outnumber the items still held. CACHED trees keep a small direct-mapped
+ * cache, indexed by NodeData::hash(), of the items last found by retrieve(),
+ * so a hot key costs one hash and one comparison instead of a walk from the
+ * root. Searches never reshape the tree, so concurrent readers remain safe;
+ * a removal forgets its item, and anything that moves or frees items, or
+ * any change to a SHARED tree, forgets them all.
+ */
+    enum Option
+    {
+        PLAIN    = 0,       // unbalanced insertion
+        BALANCED = 1,       // AVL rebalancing on insertion
+        POOLED   = 2,       // nodes are allocated from a NodePool
+        INLINE   = 4,       // keys are stored inside their nodes
+        SHARED   = 8,       // copies share nodes until they are changed
+        PARALLEL = 16,      // bulk operations on large trees use threads
+        LAZY     = 32,      // removal marks nodes, which are compacted later
+        CACHED   = 64       // retrieve() first looks in a cache of hot items
+    }; // end Option
+
 /**---------------------- Default Constructor ---------------------------------
  * Creates an empty tree.
  * @pre None.
- * @post An empty binary search tree exists.
+ * @post An empty, unbalanced binary search tree exists.
  */
     BinTree();
 
+/**---------------------- Option Constructor ----------------------------------
+ * Creates an empty tree which behaves according to the provided options.
+ * @param options  A bitwise or of Option values.
+ * @pre None.
+ * @post An empty binary search tree exists; if options includes BALANCED, the
+ *       tree will remain height balanced as items are inserted; if options
+ *       includes POOLED but not SHARED, the tree has its own NodePool.
+ */
+    explicit BinTree(int options);
+
 /**---------------------- Copy Constructor ------------------------------------
- * Copies the tree orig into a new tree.
+ * Copies the tree orig into a new tree. If orig is SHARED, the new tree shares
+ * its nodes, so the copy takes constant time and memory.
  * @param orig  The tree to be copied.
  * @pre There is sufficient memory to allocate a copy of orig.
  * @post A binary search tree exists that is a structural copy of the tree
@@ -61,7 +124,7 @@ public:
  * @post This tree is empty before is is released; all NodeData objects to
  *       which this tree held pointers are deleted.
  */
-    virtual ~BinTree();
+    ~BinTree();
 
 /**---------------------- isEmpty() -------------------------------------------
  * Determines whether a binary search tree is empty.
@@ -69,37 +132,42 @@ public:
  * @post This tree remains unchanged.
  * @return true if the tree is empty; false, otherwise.
  */
-    virtual bool isEmpty(void) const;
+    bool isEmpty(void) const;
 
 /**---------------------- makeEmpty() -----------------------------------------
- * Deallocates memory for a tree.
+ * Deallocates memory for a tree. In a POOLED tree, the blocks holding the
+ * nodes are released together once the data they hold is destroyed.
  * @pre None.
  * @post This tree is now empty; all NodeData objects to which this tree held
  *       pointers are deleted.
  */
-    virtual void makeEmpty(void);
+    void makeEmpty(void);
 
 /**---------------------- = Assignment Operator -------------------------------
  * Copies the contents of rhs into this tree. Any contents of this tree are
  * removed beforehand. Once copied, this tree will hold pointers to the same
  * objects as rhs, so emptying one tree will cause data loss in the other.
+ * Since the copy is structural, this tree also takes on the options of rhs.
+ * If rhs is SHARED, this tree shares its nodes instead of copying them.
  * @param rhs  The right-hand tree to be copied.
  * @pre There is sufficient memory to allocate a copy of rhs.
  * @post This tree is a structural copy of rhs; rhs remains unchanged.
  * @return This binary search tree, which is equivalent to rhs.
  */
-    virtual BinTree& operator=(const BinTree& rhs);
+    BinTree& operator=(const BinTree& rhs);
 
 /**---------------------- == Equality Operator --------------------------------
  * Compares this binary search tree with another for equality. Equality means
- * that both trees contain the same data and have the same structure.
+ * that both trees contain the same data and have the same structure. Trees of
+ * different sizes or root hashes are told apart in constant time, and shared
+ * subtrees are not walked.
  * @param rhs  The right-hand tree to be compared.
  * @pre NodeData provides an equality operator.
  * @post Both binary search trees remain unchanged.
  * @return true if both trees have identical structures and content; false,
  *         otherwise.
  */
-    virtual bool operator==(const BinTree& rhs) const;
+    bool operator==(const BinTree& rhs) const;
 
 /**---------------------- != Inequality Operator ------------------------------
  * Compares this binary search tree with another for inequality. Inequality
@@ -110,28 +178,151 @@ public:
  * @return false if both trees have identical structures and content; true,
  *         otherwise.
  */
-    virtual bool operator!=(const BinTree& rhs) const;
+    bool operator!=(const BinTree& rhs) const;
+
+/**---------------------- locateDifference() ----------------------------------
+ * Finds the shallowest position at which this tree and rhs differ. Only links
+ * whose subtree hashes disagree are followed, so one path is visited rather
+ * than either tree. The search stops at a position whose items differ, where
+ * either tree has no node, or where both subtrees differ, since from there
+ * the difference is not confined to one subtree.
+ * @param rhs  The right-hand tree to be compared.
+ * @param dataItem  A container for the item of this tree at that position;
+ *        NULL if this tree has no node there.
+ * @pre NodeData provides an equality operator.
+ * @post Both binary search trees remain unchanged.
+ * @return The depth of the position, where the root is at depth 1; 0 if both
+ *         trees have identical structures and content.
+ */
+    int locateDifference(const BinTree& rhs,
+                               NodeData *& dataItem) const;
 
 /**---------------------- insert() --------------------------------------------
- * Inserts an item into a binary search tree.
+ * Inserts an item into a binary search tree. In a BALANCED tree, the path to
+ * the new item is rebalanced, so the height remains O(log n). This tree takes
+ * ownership of newItem if it is inserted; in an INLINE tree, the value of
+ * newItem is then moved into its node and newItem is deleted.
  * @param newItem  An object to be added to the tree.
- * @pre NodeData provdes the == and < operators.
+ * @pre NodeData provides the compare() method.
  * @post newItem is in its proper position in the tree.
  * @return true if newItem could be inserted in the tree; false if newItem
  *         already existed in the tree.
  */
-    virtual bool insert(NodeData *newItem);
+    bool insert(NodeData *newItem);
+
+/**---------------------- insert() --------------------------------------------
+ * Inserts an item into a binary search tree by moving its value into storage
+ * owned by the tree, as insert(const NodeData&) would store a copy. The value
+ * is only moved if newItem is not already in the tree, so no allocation is
+ * made for its key beyond what newItem already holds.
+ * @param newItem  An object whose value is to be added to the tree.
+ * @pre NodeData provides the compare() method.
+ * @post The former value of newItem is in its proper position in the tree,
+ *       and newItem is empty; if the insertion failed, newItem is unchanged.
+ * @return true if newItem could be inserted in the tree; false if newItem
+ *         already existed in the tree.
+ */
+    bool insert(NodeData&& newItem);
+
+/**---------------------- insert() --------------------------------------------
+ * Inserts a copy of an item into a binary search tree. The copy is stored in
+ * its node in an INLINE tree, in the pool of a POOLED tree, or on the heap
+ * otherwise; the caller keeps ownership of newItem. The copy is only made if
+ * newItem is not already in the tree.
+ * @param newItem  An object whose value is to be added to the tree.
+ * @pre NodeData provides the compare() method.
+ * @post A copy of newItem is in its proper position in the tree.
+ * @return true if newItem could be inserted in the tree; false if newItem
+ *         already existed in the tree.
+ */
+    bool insert(const NodeData& newItem);
+
+/**---------------------- remove() --------------------------------------------
+ * Removes an item from a binary search tree. A node with two children is
+ * replaced by its in-order successor, and in a BALANCED tree the path is
+ * rebalanced on the way back up, so the height remains O(log n). In a LAZY
+ * tree, the node is only marked as removed; it is freed by compact(), which
+ * runs once the tree holds more tombstones than items.
+ * @param oldItem  An object equal to the item to be removed.
+ * @pre NodeData provides the compare() method.
+ * @post No item equal to oldItem is in the tree; the item that was is
+ *       deleted, unless it is a tombstone, which is deleted by compact().
+ * @return true if oldItem was found and removed; false if it was not in the
+ *         tree or memory could not be allocated.
+ */
+    bool remove(const NodeData& oldItem);
+
+/**---------------------- removeIf() ------------------------------------------
+ * Removes every item of a binary search tree for which a predicate holds. The
+ * items are visited in sorted order and matching nodes are marked, then all
+ * are dropped by one pass of compact(), which leaves the tree with minimal
+ * height. A SHARED tree first copies any nodes it still shares.
+ * @param doomed  A function or functor taking a const NodeData& and returning
+ *        true for an item that is to be removed.
+ * @pre doomed does not change this tree.
+ * @post No item for which doomed returns true is in the tree; those items are
+ *       deleted.
+ * @return The number of items removed.
+ */
+    template <class Predicate>
+    int removeIf(Predicate doomed)
+    {
+        vector<Node*> nodes;        // nodes holding live items, in order
+        int           removed = 0;
+
+        if (collectLive(nodes))
+        {
+            for (size_t i = 0; i < nodes.size(); ++i)
+            {
+                const NodeData& item = *nodes[i]->data;
+
+                if (doomed(item))
+                {
+                    nodes[i]->dead = true;
+                    ++removed;
+                } // end if (doomed(item))
+            } // end for (size_t i = 0)
+
+            nodeCount -= removed;
+            deadCount += removed;
+            forgetCached();         // the cache may hold marked items
+            compact();              // refreshes the hashes of marked nodes
+        } // end if (collectLive(nodes))
+
+        return removed;
+    } // end removeIf(Predicate)
 
 /**---------------------- retrieve() ------------------------------------------
- * Retrieves a given item from a binary search tree.
+ * Retrieves a given item from a binary search tree. In a SHARED tree, the
+ * item found may also be held by copies of this tree, so it must not be
+ * changed through dataItem. A frozen tree is searched through its array. A
+ * CACHED tree first looks in the cache slot of searchItem, and remembers the
+ * item there once found.
  * @param searchItem  The item to be located.
  * @param dataItem  A container for the found item.
- * @pre NodeData provides the == and < operators.
+ * @pre NodeData provides the compare() method.
  * @post If the retrieval was successful, dataItem contains the retrieved item;
- *       this tree remains unchanged.
+ *       this tree remains unchanged, but for its cache.
+ */
+    bool retrieve(const NodeData& searchItem,
+                        NodeData *& dataItem) const;
+
+/**---------------------- retrieveMany() --------------------------------------
+ * Retrieves a batch of items from a binary search tree. Up to SEARCH_GROUP
+ * searches advance together, one level at a time, and each prefetches the
+ * node it will visit next, so the cache misses of one search overlap with
+ * the comparisons of the others rather than following one another.
+ * @param keys[]  The items to be located.
+ * @param count  The number of elements in keys[].
+ * @param found[]  A container for the found items, in the order of keys[].
+ * @pre found[] has room for count elements; NodeData provides the compare()
+ *      method.
+ * @post found[i] points to the item matching keys[i], or is NULL if there is
+ *       none; this tree remains unchanged.
+ * @return The number of keys that were found.
  */
-    virtual bool retrieve(const NodeData& searchItem,
-                                NodeData *& dataItem) const;
+    int retrieveMany(const NodeData keys[], int count,
+                           NodeData *found[]) const;
 
 /**---------------------- displaySideways() -----------------------------------
  * Displays a binary tree as though you are viewing it from the side;
@@ -139,93 +330,854 @@ public:
  * @pre cout can be written to.
  * @post This tree remains unchanged.
  */
-    virtual void displaySideways(void) const;
+    void displaySideways(void) const;
+
+/**---------------------- displaySideways() -----------------------------------
+ * Displays a binary tree as though you are viewing it from the side, on any
+ * ostream. The lines are gathered in a buffer and written in large blocks,
+ * rather than one item at a time. Nodes deeper than maxDepth are left out,
+ * and at most maxNodes lines are written.
+ * @param output  The ostream to which to write.
+ * @param maxDepth  The depth of the deepest nodes to display; 0 for all.
+ * @param maxNodes  The number of nodes to display; 0 for all.
+ * @pre The ostream, output, can be written to; maxDepth and maxNodes are not
+ *      negative.
+ * @post output contains a graphical representation of this tree; this tree
+ *       remains unchanged.
+ */
+    void displaySideways(ostream& output, int maxDepth = 0,
+                         int maxNodes = 0) const;
+
+/**---------------------- appendSideways() ------------------------------------
+ * Appends the sideways display of a binary tree to a string, as
+ * displaySideways() would write it. Reusing a string whose capacity suffices
+ * makes the call free of allocation for trees no taller than PATH_LIMIT.
+ * @param output  The string to which to append.
+ * @param maxDepth  The depth of the deepest nodes to display; 0 for all.
+ * @param maxNodes  The number of nodes to display; 0 for all.
+ * @pre NodeData provides the view() method; maxDepth and maxNodes are not
+ *      negative.
+ * @post output ends with a graphical representation of this tree; this tree
+ *       remains unchanged.
+ * @return The number of nodes displayed.
+ */
+    int appendSideways(string& output, int maxDepth = 0,
+                       int maxNodes = 0) const;
+
+/**---------------------- appendInorder() -------------------------------------
+ * Appends the contents of a binary search tree to a string, in sorted order,
+ * each item preceded by a space, as operator<< writes them but without the
+ * line end. Reusing a string whose capacity suffices makes the call free of
+ * allocation for trees no taller than PATH_LIMIT.
+ * @param output  The string to which to append.
+ * @param limit  The number of items to append, from the smallest; 0 for all.
+ * @pre NodeData provides the view() method; limit is not negative.
+ * @post output ends with the smallest items of this tree, space separated;
+ *       this tree remains unchanged.
+ * @return The number of items appended.
+ */
+    int appendInorder(string& output, int limit = 0) const;
 
 /**---------------------- getDepth() ------------------------------------------
  * Determines the depth of a node in a binary search tree. If the data is found
  * at the root, the depth is 1. If the data is not found, the depth is 0. The
- * item is sought with iteration through the tree, rather than binary
- * comparisons.
+ * item is sought by following the comparison path from the root, so the cost
+ * is bounded by the height of the tree; a frozen tree follows it through its
+ * array instead.
  * @param searchItem  The item to locate in the tree.
- * @pre NodeData provides an equality operator.
+ * @pre NodeData provides the compare() method.
  * @post This tree remains unchanged.
  * @return The depth of the node containing treeItem, if found; 0, otherwise.
  */
-    virtual int getDepth(const NodeData& searchItem) const;
+    int getDepth(const NodeData& searchItem) const;
+
+/**---------------------- getHeight() -----------------------------------------
+ * Determines the height of a binary search tree. An empty tree has a height of
+ * 0 and a tree with only a root has a height of 1.
+ * @pre None.
+ * @post This tree remains unchanged.
+ * @return The number of nodes on the longest path from the root to a leaf.
+ */
+    int getHeight(void) const;
+
+/**---------------------- size() ----------------------------------------------
+ * Determines the number of items in a binary search tree.
+ * @pre None.
+ * @post This tree remains unchanged.
+ * @return The number of items in this tree, which is maintained as items are
+ *         added and removed.
+ */
+    int size(void) const;
+
+/**---------------------- Stats -----------------------------------------------
+ * A snapshot of the work done by a tree, for finding out why it is slow. The
+ * counters are kept only in programs compiled with BINTREE_STATS defined;
+ * otherwise they cost nothing and read 0, while height and size are always
+ * current. Visits divided by calls give the average path length of a search
+ * or an insert, which grows with a tree that has drifted out of shape. In a
+ * CACHED tree, hits divided by hits and misses give the share of retrieve()
+ * calls that the cache answered.
+ */
+    struct Stats
+    {
+        unsigned long long comparisons;     // NodeData compare() calls
+        unsigned long long retrieves;       // Keys sought by retrieve()
+        unsigned long long retrieveVisits;  // Nodes visited seeking them
+        unsigned long long inserts;         // Items offered to insert()
+        unsigned long long insertVisits;    // Nodes visited placing them
+        unsigned long long allocations;     // Nodes allocated for items
+        unsigned long long cacheHits;       // Retrieves answered by the cache
+        unsigned long long cacheMisses;     // Retrieves that searched instead
+        int                height;          // Current getHeight()
+        int                size;            // Current size()
+    }; // end Stats
+
+/**---------------------- getStats() ------------------------------------------
+ * Reports the counters of a binary search tree since it was created or
+ * resetStats() was last called, with its current height and size. Searches
+ * of retrieveMany() and getDepth() are counted with those of retrieve(), and
+ * nodes copied into this tree when it is copied are counted as allocations.
+ * @pre None.
+ * @post This tree remains unchanged.
+ * @return The counters and shape of this tree.
+ */
+    Stats getStats(void) const;
+
+/**---------------------- resetStats() ----------------------------------------
+ * Sets the counters of a binary search tree back to 0.
+ * @pre None.
+ * @post getStats() reports no work done by this tree.
+ */
+    void resetStats(void);
+
+/**---------------------- rebalance() -----------------------------------------
+ * Rebalances a binary search tree in place, using the Day-Stout-Warren
+ * algorithm: the tree is rotated into a sorted vine, which is then compressed
+ * into a complete tree. No items are compared, and no nodes are allocated or
+ * freed, except that a SHARED tree first copies any nodes it still shares and
+ * tombstones are freed as the vine is built.
+ * @pre None.
+ * @post This tree holds the same items as before and no tombstones, with a
+ *       height of ceil(log2(size() + 1)); stored heights are current.
+ */
+    void rebalance(void);
+
+/**---------------------- compact() -------------------------------------------
+ * Frees the tombstones left by remove() in a LAZY tree, in one linear pass,
+ * by rebalancing the tree: each tombstone is unlinked as the vine is built.
+ * A tree without tombstones is left as it is.
+ * @pre None.
+ * @post This tree holds the same items as before and no tombstones; if any
+ *       were freed, it has minimal height.
+ */
+    void compact(void);
+
+/**---------------------- setRebalanceFactor() --------------------------------
+ * Arranges for rebalance() to be called automatically by insert() whenever the
+ * height of this tree grows beyond factor * log2(size()). Sorted input makes
+ * this happen repeatedly, so BALANCED is better suited to it; the factor is
+ * meant to catch a tree that gradually drifts out of shape.
+ * @param factor  The multiple of log2(size()) that the height may reach, or 0
+ *        to disable automatic rebalancing.
+ * @pre factor is 0 or greater than 1.
+ * @post Later insertions keep the height of this tree within the given bound.
+ */
+    void setRebalanceFactor(double factor);
+
+/**---------------------- freeze() --------------------------------------------
+ * Packs the items of a binary search tree into one contiguous array in
+ * Eytzinger order: the root at index 1 and the children of index k at 2k and
+ * 2k + 1. The nodes are relinked into the same complete shape, so the tree
+ * itself is unchanged in content, while retrieve() and getDepth() search the
+ * array without branching on comparisons and in-order output reads it
+ * directly. Tombstones are compacted first. The first insert, removal, or
+ * rebalance() thaws the tree, which then goes back to searching its nodes;
+ * the array lives on until the tree is emptied.
+ * @pre None.
+ * @post This tree holds the same items as before, in a complete tree whose
+ *       items are stored contiguously; isFrozen() is true unless this tree is
+ *       empty or memory could not be allocated.
+ */
+    void freeze(void);
+
+/**---------------------- isFrozen() ------------------------------------------
+ * Determines whether a binary search tree is searched through the array
+ * packed by freeze().
+ * @pre None.
+ * @post This tree remains unchanged.
+ * @return true if freeze() has been called and the tree has not changed since;
+ *         false, otherwise.
+ */
+    bool isFrozen(void) const;
+
+/**---------------------- save() ----------------------------------------------
+ * Writes the items of a binary search tree to a binary snapshot file: a
+ * header, then each key in sorted order, prefixed by its length, then,
+ * optionally, the offsets of the keys in the Eytzinger order of freeze(). A
+ * TreeSnapshot may search the file in place, and load() reads it back.
+ * @param fileName  The name of the file to be written.
+ * @param layout  Whether to write the Eytzinger offsets as well.
+ * @pre NodeData provides the view() method.
+ * @post The file holds every item of this tree; this tree remains unchanged.
+ * @return true if the file was written; false if it could not be.
+ */
+    bool save(const char *fileName, bool layout = true) const;
+
+/**---------------------- load() ----------------------------------------------
+ * Replaces the contents of a binary search tree with the items of a snapshot
+ * file written by save(). The keys are stored in sorted order, so the tree is
+ * built without comparisons, and it is frozen if the file holds a layout.
+ * @param fileName  The name of the file to be read.
+ * @pre None.
+ * @post If the file is a snapshot, this tree is balanced and holds its items;
+ *       otherwise, this tree remains unchanged.
+ * @return true if the file was loaded; false if it could not be read or
+ *         memory could not be allocated.
+ */
+    bool load(const char *fileName);
 
 /**---------------------- bstreeToArray() -------------------------------------
  * Fills an array of NodeData* by using an inorder traversal of the tree. The
  * tree is left empty. The size of the array is not checked and is assumed to
  * be sufficient to contain every element in the tree.
  * @param target[]  The array to fill with the NodeData* from this tree.
- * @pre target[] currently contains 100 NULL elements.
- * @post target[] contains every element found in this tree, in sorded order;
+ * @pre target[] has room for at least size() elements.
+ * @post target[] contains every element found in this tree, in sorded order,
+ *       starting at index 0; this tree is empty.
+ */
+    void bstreeToArray(NodeData* target[]);
+
+/**---------------------- bstreeToArray() -------------------------------------
+ * Fills an array of NodeData* of known capacity by using an inorder traversal
+ * of the tree. The tree is left empty, unless the array is too small, in
+ * which case nothing is moved. A SHARED tree first copies any nodes it still
+ * shares, so that other trees keep their data.
+ * @param target[]  The array to fill with the NodeData* from this tree.
+ * @param capacity  The number of elements target[] has room for.
+ * @pre None.
+ * @post If capacity >= size(), target[] contains every element found in this
+ *       tree, in sorted order, starting at index 0, and this tree is empty;
+ *       otherwise, both remain unchanged.
+ * @return The number of elements placed in target[].
+ */
+    int bstreeToArray(NodeData* target[], int capacity);
+
+/**---------------------- bstreeToArray() -------------------------------------
+ * Appends the NodeData* from this tree to a growable buffer, in sorted order,
+ * by using an inorder traversal of the tree. The tree is left empty.
+ * @param target  The buffer to which to append the NodeData* from this tree.
+ * @pre None.
+ * @post target ends with every element found in this tree, in sorted order;
  *       this tree is empty.
+ * @return The number of elements appended to target.
+ */
+    int bstreeToArray(vector<NodeData*>& target);
+
+/**---------------------- arrayToBSTree() -------------------------------------
+ * Populates this tree from the contents of an array of sorted NodeData*,
+ * terminated by the first NULL element. Any contents of this tree are removed
+ * beforehand. The new tree is balanced by linking the middle element of each
+ * segment of the array as the root of its subtree.
+ * @param source[]  The array from which to populate this tree.
+ * @pre source[] is sorted in ascending order and has a NULL element after the
+ *      last item.
+ * @post This tree is balanced and contains all NodeData* that were contained
+ *       in source[]; all elements of source[] are now NULL.
  */
-    virtual void bstreeToArray(NodeData* target[]);
+    void arrayToBSTree(NodeData* source[]);
 
 /**---------------------- arrayToBSTree() -------------------------------------
- * Populates this tree from the contents of an array of sorted NodeData*. Any
- * contents of this tree are removed beforehand. The new tree is balanced by
- * using bisection of the array to choose the order of insertion.
+ * Populates this tree from the contents of an array of sorted NodeData* of
+ * known length, in one linear pass. Any contents of this tree are removed
+ * beforehand. This is build(), which also accepts unsorted arrays.
  * @param source[]  The array from which to populate this tree.
- * @pre target[] is sorted in ascending order.
+ * @param count  The number of elements in source[].
+ * @pre source[] holds count distinct, non-NULL pointers.
  * @post This tree is balanced and contains all NodeData* that were contained
  *       in source[]; all elements of source[] are now NULL.
+ * @return The number of items in this tree.
  */
-    virtual void arrayToBSTree(NodeData* source[]);
-    
+    int arrayToBSTree(NodeData* source[], int count);
+
+/**---------------------- build() ---------------------------------------------
+ * Populates this tree from an array of NodeData*, taking ownership of them.
+ * Any contents of this tree are removed beforehand. If the array is not
+ * already in strictly ascending order, it is sorted and duplicates are
+ * deleted. The nodes are then linked into a perfectly balanced tree without
+ * further comparisons, so sorted input is loaded in O(n).
+ * @param source[]  The array from which to populate this tree.
+ * @param count  The number of elements in source[].
+ * @pre source[] holds count distinct, non-NULL pointers.
+ * @post This tree is balanced and holds one item for every distinct value in
+ *       source[]; source[] is in ascending order with every element NULL.
+ * @return The number of items in this tree.
+ */
+    int build(NodeData *source[], int count);
+
+/**---------------------- build() ---------------------------------------------
+ * Populates this tree with copies of the items in an array. Any contents of
+ * this tree are removed beforehand. If the array is not already in strictly
+ * ascending order, a sorted view of it is used and duplicates are skipped.
+ * The copies are linked into a perfectly balanced tree without further
+ * comparisons, so sorted input is loaded in O(n).
+ * @param source[]  The array of values from which to populate this tree.
+ * @param count  The number of elements in source[].
+ * @pre source[] holds count elements.
+ * @post This tree is balanced and holds a copy of every distinct value in
+ *       source[]; source[] remains unchanged.
+ * @return The number of items in this tree.
+ */
+    int build(const NodeData source[], int count);
+
+/**---------------------- const_iterator --------------------------------------
+ * A bidirectional iterator over the data in a tree, in sorted order. Moving
+ * an iterator allocates no memory and costs O(1) amortized, except in trees
+ * taller than PATH_LIMIT, where each step is a search from the root. Any
+ * change to the tree invalidates its iterators. Tombstones are skipped.
+ */
+    class const_iterator;
+
+/**---------------------- begin() ---------------------------------------------
+ * Locates the smallest item in a binary search tree.
+ * @pre None.
+ * @post This tree remains unchanged.
+ * @return An iterator at the smallest item; end() if this tree is empty.
+ */
+    const_iterator begin(void) const;
+
+/**---------------------- end() -----------------------------------------------
+ * Provides the position one past the largest item in a binary search tree.
+ * @pre None.
+ * @post This tree remains unchanged.
+ * @return An iterator that may be decremented to reach the largest item, but
+ *         may not be dereferenced.
+ */
+    const_iterator end(void) const;
+
+/**---------------------- lower_bound() ---------------------------------------
+ * Locates the first item in a binary search tree that is not less than a key,
+ * following a single comparison path from the root.
+ * @param searchItem  The key to compare items with.
+ * @pre NodeData provides the compare() method.
+ * @post This tree remains unchanged.
+ * @return An iterator at the smallest item >= searchItem; end() if every item
+ *         is less than searchItem.
+ */
+    const_iterator lower_bound(const NodeData& searchItem) const;
+
+/**---------------------- upper_bound() ---------------------------------------
+ * Locates the first item in a binary search tree that is greater than a key,
+ * following a single comparison path from the root.
+ * @param searchItem  The key to compare items with.
+ * @pre NodeData provides the compare() method.
+ * @post This tree remains unchanged.
+ * @return An iterator at the smallest item > searchItem; end() if no item is
+ *         greater than searchItem.
+ */
+    const_iterator upper_bound(const NodeData& searchItem) const;
+
+/**---------------------- rank() ----------------------------------------------
+ * Determines how many items of a binary search tree are less than a key,
+ * which is the position the key has or would have in sorted order. Each node
+ * counts the items below it, so one comparison path from the root suffices.
+ * @param searchItem  The key to compare items with.
+ * @pre NodeData provides the compare() method.
+ * @post This tree remains unchanged.
+ * @return The number of items less than searchItem, from 0 to size().
+ */
+    int rank(const NodeData& searchItem) const;
+
+/**---------------------- select() --------------------------------------------
+ * Locates the item of a binary search tree at a position in sorted order, by
+ * following the counts stored in the nodes from the root, without comparing
+ * items. The iterator may then be moved to read a page of items from there.
+ * @param index  The position of the item, where the smallest is at 0.
+ * @pre None.
+ * @post This tree remains unchanged.
+ * @return An iterator at the item with index smaller items; end() if index
+ *         is negative or not less than size().
+ */
+    const_iterator select(int index) const;
+
+/**---------------------- equal_range() ---------------------------------------
+ * Locates the range of items in a binary search tree that are equal to a key.
+ * Since duplicates are not allowed, the range is empty or holds one item.
+ * @param searchItem  The key to compare items with.
+ * @pre NodeData provides the compare() method.
+ * @post This tree remains unchanged.
+ * @return The pair lower_bound(searchItem), upper_bound(searchItem).
+ */
+    pair<const_iterator, const_iterator>
+        equal_range(const NodeData& searchItem) const;
+
 private:
 
+    // searches no deeper than this record their path without allocating memory
+    static const int PATH_LIMIT = 64;
+
+    // subtrees shorter than this, or segments with fewer items than this, are
+    // not worth handing to another thread
+    static const int PARALLEL_HEIGHT = 12;
+    static const int PARALLEL_ITEMS = 4096;
+
+    // searches interleaved by retrieveMany(); enough to cover a miss to memory
+    static const int SEARCH_GROUP = 16;
+
+    // text bound for an ostream is written once this much is buffered
+    static const size_t OUTPUT_CHUNK = 1 << 16;
+
+    // slots in the cache of a CACHED tree; a power of 2, to mask hashes with
+    static const int CACHE_SLOTS = 1024;
+
+    // where the data object of a node was allocated, so it is freed properly
+    enum DataStore
+    {
+        HEAP_DATA,          // allocated with new; owned by this tree
+        POOL_DATA,          // allocated in a slot of this tree's pool
+        INLINE_DATA,        // stored in the node, which is an InlineNode
+        FROZEN_DATA         // an element of the keys packed by freeze()
+    }; // end DataStore
+
     struct Node
     {
         NodeData *data;     // Pointer to data object
         Node     *left;     // Pointer to left child
         Node     *right;    // Pointer to right child
+        size_t    hash;     // Structural hash of the subtree rooted here
+        size_t    itemHash; // data->hash(), taken once when data is stored
+        int       height;   // Height of the subtree rooted at this node
+        unsigned  store : 2;    // DataStore of data
+        unsigned  refs : 30;    // Links to this node, if SHARED; 1, otherwise
+        int       count;    // Live items in the subtree rooted at this node
+        bool      dead;     // Whether data was removed from a LAZY tree;
+                            // apart from refs, which writers change while
+                            // readers of snapshots test this
+
+        Node(NodeData *item, DataStore where)
+            : data(item), left(NULL), right(NULL), hash(0), itemHash(0),
+              height(1), store(where), refs(1), count(1), dead(false)
+        {
+        } // end constructor
     }; // end Node
 
-    Node *root;             // Pointer to root of tree
+    // a node followed by its own data object; data points to value until the
+    // value is detached, but value lives as long as the node
+    struct InlineNode : Node
+    {
+        NodeData value;     // Data object referred to by data
+
+        InlineNode(const NodeData& item) : Node(NULL, INLINE_DATA), value(item)
+        {
+            data = &value;
+        } // end constructor
+
+        InlineNode(NodeData&& item)
+            : Node(NULL, INLINE_DATA), value(std::move(item))
+        {
+            data = &value;
+        } // end constructor
+    }; // end InlineNode
+
+    Node     *root;         // Pointer to root of tree
+    int       options;      // Bitwise or of Option values
+    NodePool *pool;         // Source of nodes if POOLED; NULL, otherwise
+    int       nodeCount;    // Number of items in this tree
+    int       deadCount;    // Number of tombstones still linked, if LAZY
+    double    rebalanceFactor;  // Height bound over log2(nodeCount); 0 if none
+    shared_ptr< vector<NodeData> > frozen;
+                            // Keys packed by freeze(), from index 1; or NULL
+    bool      indexed;      // Whether frozen holds every key, in tree order
+    mutable std::atomic<NodeData*> *cache;
+                            // Items last found, by hash, if CACHED; or NULL
+
+#ifdef BINTREE_STATS
+    // counters behind getStats(), updated by const searches from any thread
+    struct Counters
+    {
+        std::atomic<unsigned long long> comparisons;
+        std::atomic<unsigned long long> retrieves;
+        std::atomic<unsigned long long> retrieveVisits;
+        std::atomic<unsigned long long> inserts;
+        std::atomic<unsigned long long> insertVisits;
+        std::atomic<unsigned long long> allocations;
+        std::atomic<unsigned long long> cacheHits;
+        std::atomic<unsigned long long> cacheMisses;
+
+        Counters()
+            : comparisons(0), retrieves(0), retrieveVisits(0), inserts(0),
+              insertVisits(0), allocations(0), cacheHits(0), cacheMisses(0)
+        {
+        } // end constructor
+    }; // end Counters
+
+    mutable Counters counters;
+#endif
+
+/**---------------------- setOptions() ----------------------------------------
+ * Changes the options of an empty tree, creating or releasing its pool and
+ * its cache.
+ * @param newOptions  A bitwise or of Option values.
+ * @pre This tree is empty.
+ * @post This tree behaves according to newOptions; pool is not NULL if and
+ *       only if newOptions includes POOLED but not SHARED, and cache is not
+ *       NULL if and only if newOptions includes CACHED.
+ * @throw bad_alloc if memory could not be allocated.
+ */
+    void setOptions(int newOptions);
+
+/**---------------------- forgetCached() --------------------------------------
+ * Empties the cache of a CACHED tree, before its items are moved or freed, or
+ * before nodes it shares with other trees are given up.
+ * @pre None.
+ * @post No item is found through the cache until it is found again.
+ */
+    void forgetCached(void);
+
+/**---------------------- forgetCached() --------------------------------------
+ * Empties the cache slot of an item of a CACHED tree, before it is removed.
+ * @param oldItem  An object equal to the item that is leaving the tree.
+ * @pre None.
+ * @post No item equal to oldItem is found through the cache.
+ */
+    void forgetCached(const NodeData& oldItem);
+
+/**---------------------- newNode() -------------------------------------------
+ * Allocates a leaf node, from the pool of this tree if it has one.
+ * @param item  The data object to be held by the new node.
+ * @param where  Where item was allocated.
+ * @pre None.
+ * @post A new leaf node holding item exists.
+ * @return A pointer to the new node.
+ * @throw bad_alloc if memory could not be allocated.
+ */
+    Node *newNode(NodeData *item, DataStore where) const;
+
+/**---------------------- makeLeaf() ------------------------------------------
+ * Allocates a leaf node holding the value of item, stored as the options of
+ * this tree dictate. If owned is not NULL, it is a heap object equal to item
+ * that this tree may keep or move from; otherwise, if movable is not NULL,
+ * its value may be moved into the node; otherwise, item must be copied.
+ * @param item  The value to be held by the new node.
+ * @param owned  A heap object with the value of item, or NULL.
+ * @param movable  An object with the value of item that may be left empty,
+ *        or NULL.
+ * @pre If owned or movable is not NULL, it is item itself or equal to it.
+ * @post A new leaf node holding the value of item, and its hash, exists; if
+ *       owned was not kept by the node, it is deleted.
+ * @return A pointer to the new node.
+ * @throw bad_alloc if memory could not be allocated; owned is not deleted.
+ */
+    Node *makeLeaf(const NodeData& item,
+                   NodeData *owned, NodeData *movable) const;
+
+/**---------------------- freeNode() ------------------------------------------
+ * Destroys the data object held by a node, if any, then deallocates the node
+ * itself, each in the way it was allocated. The data in an InlineNode is
+ * destroyed with its node, even if it was detached.
+ * @param treePtr  The node to deallocate; its children are not affected.
+ * @pre treePtr is not NULL and was allocated by newNode().
+ * @post treePtr and its data are deallocated.
+ */
+    void freeNode(Node *treePtr);
+
+/**---------------------- releaseData() ---------------------------------------
+ * Destroys the data object held by a node in the way it was allocated, unless
+ * it is stored in the node or in the array packed by freeze().
+ * @param treePtr  The node whose data is to be released.
+ * @pre treePtr is not NULL.
+ * @post The data of treePtr is destroyed if it was separately allocated; the
+ *       data pointer of treePtr is unchanged.
+ */
+    void releaseData(Node *treePtr);
+
+/**---------------------- copyData() ------------------------------------------
+ * Allocates a copy of a data object, from the pool of this tree if it has
+ * one, and reports where it was allocated.
+ * @param item  The data object to be copied.
+ * @param where  A container for where the copy was allocated.
+ * @pre None.
+ * @post A copy of item exists.
+ * @return A pointer to the copy.
+ * @throw bad_alloc if memory could not be allocated.
+ */
+    NodeData *copyData(const NodeData& item, DataStore& where) const;
+
+/**---------------------- moveData() ------------------------------------------
+ * Allocates a data object, from the pool of this tree if it has one, taking
+ * the value of item, and reports where it was allocated.
+ * @param item  The data object whose value is to be moved.
+ * @param where  A container for where the new object was allocated.
+ * @pre None.
+ * @post A data object with the former value of item exists; item is empty.
+ * @return A pointer to the new object.
+ * @throw bad_alloc if memory could not be allocated; item is unchanged.
+ */
+    NodeData *moveData(NodeData& item, DataStore& where) const;
+
+/**---------------------- detachData() ----------------------------------------
+ * Removes the data object from a node and hands it over as a heap object that
+ * the caller may delete.
+ * @param treePtr  The node whose data is to be detached.
+ * @pre treePtr is not NULL and holds data.
+ * @post The data pointer of treePtr is NULL.
+ * @return A pointer to the data, allocated with new.
+ */
+    NodeData *detachData(Node *treePtr);
+
+/**---------------------- unshare() -------------------------------------------
+ * Gives a SHARED tree its own copy of a node that other trees or nodes also
+ * link to. The copy links to the same children, which gain a reference.
+ * @param treePtr  The link to the node that is to be changed.
+ * @pre treePtr is not NULL; the node holding the link, if any, belongs to
+ *      this tree alone.
+ * @post treePtr points to a node that belongs to this tree alone and holds
+ *       the same value, children, and height as before.
+ * @throw bad_alloc if memory could not be allocated; the tree is unchanged.
+ */
+    void unshare(Node *& treePtr);
+
+/**---------------------- unshareAll() ----------------------------------------
+ * Gives a SHARED tree its own copy of every node that is still shared, from
+ * the root down, so that it may be restructured in place.
+ * @param treePtr  Pointer to the root of the tree to be unshared.
+ * @pre treePtr is NULL or links to a node held by this tree.
+ * @post No node of the tree is linked to from another tree.
+ * @throw bad_alloc if memory could not be allocated; the tree holds the same
+ *        items as before.
+ */
+    void unshareAll(Node *& treePtr);
+
+/**---------------------- unsharePath() ---------------------------------------
+ * Gives a SHARED tree its own copy of every node on a search path, from the
+ * root down, and updates the recorded links to point into the copies. Only
+ * these nodes are changed by an insert: AVL rotations after an insert touch
+ * nodes on the path and the new leaf alone.
+ * @param path[]  The links followed from the root, the first being the root.
+ * @param length  The number of links in path[].
+ * @param link  The link at the end of the path, below the last node.
+ * @pre path[] and link were recorded by a search of this tree.
+ * @post Every node on the path belongs to this tree alone; path[] and link
+ *       refer to the same positions within the tree as before.
+ * @throw bad_alloc if memory could not be allocated; the tree holds the same
+ *        items as before.
+ */
+    void unsharePath(Node **path[], int length, Node **& link);
+
+/**---------------------- unshareRotation() -----------------------------------
+ * Gives a SHARED tree its own copy of the nodes below a node that
+ * restoreBalance() would rotate. After a removal, unlike after an insert,
+ * these lie off the path, in the taller subtree.
+ * @param treePtr  The node about to be balanced.
+ * @pre treePtr is not NULL and belongs to this tree alone.
+ * @post The taller child of treePtr, if the children differ in height by
+ *       more than one, and that child's inner child belong to this tree alone.
+ * @throw bad_alloc if memory could not be allocated; the tree holds the same
+ *        items as before.
+ */
+    void unshareRotation(Node *treePtr);
+
+/**---------------------- flushText() -----------------------------------------
+ * Writes buffered text to an ostream once there is enough of it to be worth
+ * a write, and empties the buffer.
+ * @param text  The buffered text.
+ * @param output  The ostream the text is bound for; NULL if it is kept.
+ * @pre None.
+ * @post If output is not NULL and text held OUTPUT_CHUNK characters or more,
+ *       they are written to output and text is empty.
+ */
+    static void flushText(string& text, ostream *output);
 
 /**---------------------- inorderHelper() -------------------------------------
- * Traverses a binary search tree in sorted order, starting at treePtr, and
- * writes the data value of each item once, preceded by a space.
- * @param treePtr  Node at which to begin traversal.
- * @pre The ostream, output, can be written to; NodeData prvides the <<
- *      operator.
- * @post The ostream, output, contains the data element of every node in the
- *       subtree rooted at treePtr, space separated.
+ * Traverses a binary search tree in sorted order and appends the data value
+ * of each item once, preceded by a space. Ancestors whose data is still to be
+ * written are kept on an explicit stack, on the call stack unless the tree is
+ * taller than PATH_LIMIT.
+ * @param text  The string to which to append.
+ * @param output  The ostream to which to flush text as it grows; NULL to
+ *        keep it all in text.
+ * @param limit  The number of items to append; 0 for all.
+ * @pre NodeData provides the view() method.
+ * @post text, with whatever was flushed to output, ends with the data
+ *       element of each node appended, space separated.
+ * @return The number of items appended.
  */
-    void inorderHelper(ostream& output, const Node *treePtr) const;
+    int inorderHelper(string& text, ostream *output, int limit) const;
 
 /**---------------------- sideways() ------------------------------------------
- * Displays a binary tree as though you are viewing it from the side;
- * hard coded displaying to standard output.
- * @param current  The Node being examined for display.
- * @param level  The depth of the current Node, used to determine indentation.
- * @pre cout can be written to.
- * @post cout contains a graphical representation of this tree.
+ * Appends the display of a binary tree as though you are viewing it from the
+ * side. Nodes are visited in reverse order, with the ancestors still to be
+ * displayed kept on an explicit stack, on the call stack unless the tree is
+ * taller than PATH_LIMIT.
+ * @param text  The string to which to append.
+ * @param output  The ostream to which to flush text as it grows; NULL to
+ *        keep it all in text.
+ * @param maxDepth  The depth of the deepest nodes to display; 0 for all.
+ * @param maxNodes  The number of nodes to display; 0 for all.
+ * @pre NodeData provides the view() method.
+ * @post text, with whatever was flushed to output, ends with a graphical
+ *       representation of this tree.
+ * @return The number of nodes displayed.
  */
-    void sideways(Node *current, int level) const;
+    int sideways(string& text, ostream *output, int maxDepth,
+                 int maxNodes) const;
 
 /**---------------------- insertItem() ----------------------------------------
- * Recursively inserts an item into a binary search tree.
+ * Inserts an item into a binary search tree, recording the links followed so
+ * that the path may be fixed up without recursion.
  * @param treePtr  Pointer to the node to start a check for insertion.
  * @param newItem  The item to be inserted into this tree.
- * @pre treePtr points to a binary search tree; NodeData provides the == and <
- *      operators.
+ * @param owned  A heap object equal to newItem that this tree may keep, or
+ *        NULL if newItem must be copied.
+ * @param movable  newItem, if its value may be moved into the tree; NULL,
+ *        otherwise.
+ * @pre treePtr points to a binary search tree; NodeData provides the
+ *      compare() method.
  * @post newItem is in its proper position in the tree.
  * @return true if the item is successfully inserted; false if the item already
  *         exists in this tree or memory could not be allocated.
  */
-    bool insertItem(Node *& treePtr, NodeData *newItem);
+    bool insertItem(Node *& treePtr, const NodeData& newItem,
+                    NodeData *owned, NodeData *movable);
+
+/**---------------------- removeItem() ----------------------------------------
+ * Removes an item from a binary search tree, recording the links followed so
+ * that the path may be fixed up without recursion. A node with two children
+ * trades places with its in-order successor, which is unlinked instead; in a
+ * LAZY tree, the node is marked as a tombstone.
+ * @param oldItem  An object equal to the item to be removed.
+ * @pre NodeData provides the compare() method.
+ * @post No live item equal to oldItem is in the tree; stored heights and
+ *       hashes are current.
+ * @return true if the item was removed; false if it was not in this tree or
+ *         memory could not be allocated.
+ */
+    bool removeItem(const NodeData& oldItem);
+
+/**---------------------- collectLive() ---------------------------------------
+ * Lists the nodes of a binary search tree that hold live items, in sorted
+ * order, so that they may be marked in place. A SHARED tree first copies any
+ * nodes it still shares.
+ * @param nodes  A container for the nodes, which is emptied beforehand.
+ * @pre None.
+ * @post nodes holds every node of this tree that is not a tombstone, in
+ *       sorted order, and none of them is shared with another tree.
+ * @return true if the nodes were listed; false if memory could not be
+ *         allocated, in which case nodes is empty.
+ */
+    bool collectLive(vector<Node*>& nodes);
+
+/**---------------------- heightOf() ------------------------------------------
+ * Determines the height of a subtree from the height stored in its root.
+ * @param treePtr  The root of the subtree to measure; may be NULL.
+ * @pre Heights stored in the subtree are current.
+ * @post The subtree remains unchanged.
+ * @return The height of the subtree rooted at treePtr; 0 if it is empty.
+ */
+    static int heightOf(const Node *treePtr);
+
+/**---------------------- hashOf() --------------------------------------------
+ * Determines the structural hash of a subtree from the hash stored in its
+ * root. Each hash combines the hash of a node's item with the hashes of its
+ * left and right subtrees, in order, so equal subtrees have equal hashes.
+ * @param treePtr  The root of the subtree; may be NULL.
+ * @pre Hashes stored in the subtree are current.
+ * @post The subtree remains unchanged.
+ * @return The hash of the subtree rooted at treePtr; 0 if it is empty.
+ */
+    static size_t hashOf(const Node *treePtr);
+
+/**---------------------- countOf() -------------------------------------------
+ * Determines the number of live items in a subtree from the count stored in
+ * its root.
+ * @param treePtr  The root of the subtree; may be NULL.
+ * @pre Counts stored in the subtree are current.
+ * @post The subtree remains unchanged.
+ * @return The number of items in the subtree, leaving out tombstones; 0 if
+ *         it is empty.
+ */
+    static int countOf(const Node *treePtr);
+
+/**---------------------- refresh() -------------------------------------------
+ * Recomputes the height, item count, and structural hash stored in a node
+ * from those of its children and from the hash of its own item, which was
+ * stored with the item, so no key is hashed again.
+ * @param treePtr  The node to update.
+ * @pre treePtr is not NULL; the heights, counts, and hashes of both children
+ *      are current.
+ * @post The height, count, and hash stored in treePtr are current.
+ */
+    static void refresh(Node *treePtr);
+
+/**---------------------- rotateLeft() ----------------------------------------
+ * Rotates a subtree to the left, so that the right child of treePtr becomes
+ * the root of the subtree.
+ * @param treePtr  The root of the subtree to rotate.
+ * @pre treePtr and its right child are not NULL.
+ * @post treePtr points to the former right child, which now holds the former
+ *       root as its left child; stored heights are current.
+ */
+    static void rotateLeft(Node *& treePtr);
+
+/**---------------------- rotateRight() ---------------------------------------
+ * Rotates a subtree to the right, so that the left child of treePtr becomes
+ * the root of the subtree.
+ * @param treePtr  The root of the subtree to rotate.
+ * @pre treePtr and its left child are not NULL.
+ * @post treePtr points to the former left child, which now holds the former
+ *       root as its right child; stored heights are current.
+ */
+    static void rotateRight(Node *& treePtr);
+
+/**---------------------- restoreBalance() ------------------------------------
+ * Restores the AVL property at the root of a subtree whose children differ in
+ * height by at most two, using a single or double rotation.
+ * @param treePtr  The root of the subtree to balance.
+ * @pre treePtr is not NULL; both subtrees of treePtr are AVL balanced.
+ * @post The subtree rooted at treePtr is AVL balanced; stored heights are
+ *       current.
+ */
+    static void restoreBalance(Node *& treePtr);
+
+/**---------------------- compress() ------------------------------------------
+ * Performs one pass of the Day-Stout-Warren vine compression, rotating left
+ * every other node down the right spine below vineTop.
+ * @param vineTop  The node above the portion of the vine to compress.
+ * @param count  The number of left rotations to perform.
+ * @pre The right spine below vineTop has at least 2 * count nodes.
+ * @post count nodes on the spine have become left children of their former
+ *       right children; stored heights are not updated.
+ */
+    static void compress(Node *vineTop, int count);
+
+/**---------------------- refreshAll() ----------------------------------------
+ * Recomputes the height, count, and hash stored in every node of a subtree
+ * with a postorder traversal, after a restructuring that did not maintain
+ * them.
+ * @param treePtr  The root of the subtree to update; may be NULL.
+ * @pre None.
+ * @post The heights, counts, and hashes stored throughout the subtree are
+ *       current.
+ */
+    static void refreshAll(Node *treePtr);
+
+/**---------------------- isTooTall() -----------------------------------------
+ * Determines whether this tree has outgrown the bound set by
+ * setRebalanceFactor().
+ * @pre None.
+ * @post This tree remains unchanged.
+ * @return true if automatic rebalancing is enabled and the height exceeds
+ *         rebalanceFactor * log2(nodeCount); false, otherwise.
+ */
+    bool isTooTall(void) const;
 
 /**---------------------- retrieveItem() --------------------------------------
- * Recursively retrieves an item from a binary search tree.
+ * Retrieves an item from a binary search tree, descending one level per
+ * comparison.
  * @param treePtr  Pointer to the node at which to start searching.
  * @param searchItem  The item to be located.
  * @param dataItem  A container for the located item.
- * @pre treePtr points to a binary search tree; NodeData provides the == and <
- *      operators.
+ * @pre treePtr points to a binary search tree; NodeData provides the
+ *      compare() method.
  * @post If the retrieval was successful, treeItem contains the retrieved item;
  *       this tree remains unchanged.
  * @return true if searchItem matches an item in the tree; false if searchItem
@@ -235,19 +1187,51 @@ private:
                       const NodeData& treeItem,
                             NodeData *& dataItem) const;
 
+/**---------------------- frozenIndex() ---------------------------------------
+ * Locates an item in the array packed by freeze(). The search descends to
+ * index 2k or 2k + 1 by adding the result of each comparison, so it does not
+ * branch on the data; the position of the match is then recovered by
+ * dropping the trailing right turns, and one more, from the final index.
+ * @param searchItem  The item to be located.
+ * @pre indexed is true; NodeData provides the compare() method.
+ * @post This tree remains unchanged.
+ * @return The index of the item matching searchItem; 0 if there is none.
+ */
+    size_t frozenIndex(const NodeData& searchItem) const;
+
+/**---------------------- frozenInorder() -------------------------------------
+ * Appends the items of the array packed by freeze() in sorted order, each
+ * preceded by a space, by stepping from each index to its successor.
+ * @param text  The string to which to append.
+ * @param output  The ostream to which to flush text as it grows; NULL to
+ *        keep it all in text.
+ * @param limit  The number of items to append; 0 for all.
+ * @pre indexed is true; NodeData provides the view() method.
+ * @post text, with whatever was flushed to output, ends with the items of
+ *       this tree appended, space separated.
+ * @return The number of items appended.
+ */
+    int frozenInorder(string& text, ostream *output, int limit) const;
+
 /**---------------------- copyTree() ------------------------------------------
- * Copies the tree rooted at treePtr into a tree rooted at newTreePtr.
+ * Copies the tree rooted at treePtr into a tree rooted at newTreePtr. Each
+ * stack entry pairs a node to be copied with the link that will point to its
+ * copy; new leaves have NULL links, so a failed copy is still a valid tree.
  * @param treePtr  The root of the tree to be copied.
  * @param newTreePtr  A container for the root of a copy of treePtr.
- * @pre There is sufficient memory to allocate a new tree; NodeData provides
- *      the == and < operators.
+ * @pre There is sufficient memory to allocate a new tree.
  * @post newTreePtr points to the root of a structural copy of the tree whose
  *       root is pointed to by treePtr.
+ * @return The number of live items copied, which leaves out tombstones.
  */
-    void copyTree(Node *treePtr, Node *& newTreePtr) const;
+    int copyTree(Node *treePtr, Node *& newTreePtr) const;
 
 /**---------------------- destroyTree() ---------------------------------------
- * Deallocates memory for a tree.
+ * Deallocates memory for a tree. Left children are rotated up until the
+ * current node has none, at which point it is freed and its right child
+ * becomes current, so no stack is needed for a tree of any shape. In a SHARED
+ * tree, each node loses one reference instead, and only nodes left with none
+ * are freed, their children being released in turn from an explicit stack.
  * @param treePtr  Pointer to the root of the tree to be deallocated.
  * @pre None.
  * @post treePtr points to an empty tree.
@@ -255,7 +1239,9 @@ private:
     void destroyTree(Node *& treePtr);
 
 /**---------------------- compare() -------------------------------------------
- * Compares two subtrees for equivalent content and structure.
+ * Compares two subtrees for equivalent content and structure. Pairs of nodes
+ * still to be compared are kept on an explicit stack; a pair whose hashes
+ * differ ends the search, and a pair that is one shared node is skipped.
  * @param lhs  A binary search tree to check for equality.
  * @param rhs  A binary search tree to check against for equality.
  * @pre None.
@@ -268,20 +1254,23 @@ private:
 /**---------------------- depth() ---------------------------------------------
  * Determines the depth of a node in a binary search tree. If the data is found
  * at the root, the depth is 1. If the data is not found, the depth is 0. The
- * item is sought with iteration through the tree, rather than binary
- * comparisons.
- * @param searchItem  The item to locate in the tree.
- * @pre NodeData provides an equality operator.
+ * item is sought by following the comparison path from the root, so the cost
+ * is bounded by the height of the tree.
+ * @param treePtr  The root of the subtree in which to search.
+ * @param dataItem  The item to locate in the tree.
+ * @pre treePtr points to a binary search tree; NodeData provides the
+ *      compare() method.
  * @post This tree remains unchanged.
- * @return The depth of the node containing treeItem, if found; 0 the item is
- *         not found.
+ * @return The depth of the node containing dataItem, relative to treePtr, if
+ *         found; 0 the item is not found.
  */
     int depth(const Node *treePtr, const NodeData& dataItem) const;
 
 /**---------------------- inorderToArray() ------------------------------------
  * Traverses a binary search tree in sorted order and moves each data element
  * into an array of NodeData*. The size of targe[] is assumed to be sufficient
- * to contain all elements in the subtree.
+ * to contain all elements in the subtree. Ancestors whose data is still to be
+ * moved are kept on an explicit stack.
  * @param treePtr  The root of a subtree to move into an array.
  * @param target[]  An array to move a subtree into.
  * @param index  The index at which to insert the next item into the array.
@@ -294,22 +1283,237 @@ private:
  */
     void inorderToArray(Node *treePtr, NodeData *target[], int& index);
 
-/**---------------------- bisectBuild() ---------------------------------------
- * Fills this tree from the contents of an array segment of sorted NodeData*.
- * The new tree is balanced by using bisection of the array segment to choose
- * the order of insertion. Elements are removed from the array as they are
- * inserted into this tree.
- * @param source[]  The array from which to fill this tree.
- * @param low  The lower bound of the segment to examine.
- * @param high  The upper bound of the segment to examine.
- * @pre source[] is sorted in ascending order; this tree only contains data
- *      from the array source[].
- * @post The data elements in the provided array segment have been inserted
- *       into this tree; this tree is balanced.
- */
-    void bisectBuild(NodeData *source[], int low, int high);
+/**---------------------- linkSorted() ----------------------------------------
+ * Links a balanced subtree holding the items of a sorted array segment, using
+ * the middle item as its root. No items are compared.
+ * @param treePtr  A container for the root of the new subtree.
+ * @param items[]  The values to be held, in strictly ascending order.
+ * @param owned[]  Heap objects equal to items[] that this tree may keep, or
+ *        NULL if the values of items[] must be copied.
+ * @param low  The lower bound of the segment to link.
+ * @param high  The upper bound of the segment to link.
+ * @param linked  A counter to which every node linked is added.
+ * @pre treePtr is NULL.
+ * @post treePtr points to a balanced subtree of every item in the segment,
+ *       with current heights; elements of owned[] in the segment are NULL;
+ *       linked includes every node linked.
+ * @throw bad_alloc if memory could not be allocated; treePtr then points to
+ *        the part of the subtree linked so far.
+ */
+    void linkSorted(Node *& treePtr, const NodeData *const items[],
+                    NodeData *owned[], int low, int high, int& linked);
+
+/**---------------------- forkLevels() ----------------------------------------
+ * Determines how many levels from the root may fork their subtrees onto the
+ * shared TaskPool: enough to give every worker a few pieces of work. Only a
+ * PARALLEL tree without a pool forks, since a NodePool is not thread safe.
+ * @pre None.
+ * @post This tree remains unchanged.
+ * @return The number of levels that may fork; 0 if this tree does not.
+ */
+    int forkLevels(void) const;
+
+/**---------------------- forkCopy() ------------------------------------------
+ * Copies the tree rooted at treePtr into a tree rooted at newTreePtr. For the
+ * top levels, a node whose subtrees are both at least PARALLEL_HEIGHT tall
+ * is copied here while its left subtree is copied by another thread; any
+ * other subtree is copied by copyTree().
+ * @param treePtr  The root of the tree to be copied.
+ * @param newTreePtr  A container for the root of a copy of treePtr.
+ * @param level  The number of levels below which nothing forks.
+ * @pre There is sufficient memory to allocate a new tree.
+ * @post newTreePtr points to the root of a structural copy of the tree whose
+ *       root is pointed to by treePtr.
+ * @return The number of live items copied, which leaves out tombstones.
+ */
+    int forkCopy(Node *treePtr, Node *& newTreePtr, int level) const;
+
+/**---------------------- forkDestroy() ---------------------------------------
+ * Deallocates memory for a tree. For the top levels, a node whose subtrees
+ * are both at least PARALLEL_HEIGHT tall has its left subtree freed by
+ * another thread while its right subtree is freed here; any other subtree is
+ * freed by destroyTree().
+ * @param treePtr  Pointer to the root of the tree to be deallocated.
+ * @param level  The number of levels below which nothing forks.
+ * @pre No node of the tree is shared with another tree, if level > 0.
+ * @post treePtr points to an empty tree.
+ */
+    void forkDestroy(Node *& treePtr, int level);
+
+/**---------------------- forkLink() ------------------------------------------
+ * Links a balanced subtree holding the items of a sorted array segment, as
+ * linkSorted() does. For the top levels, a segment of at least PARALLEL_ITEMS
+ * items has its left half linked by another thread.
+ * @param treePtr  A container for the root of the new subtree.
+ * @param items[]  The values to be held, in strictly ascending order.
+ * @param owned[]  Heap objects equal to items[] that this tree may keep, or
+ *        NULL if the values of items[] must be copied.
+ * @param low  The lower bound of the segment to link.
+ * @param high  The upper bound of the segment to link.
+ * @param level  The number of levels below which nothing forks.
+ * @param linked  A counter to which every node linked is added.
+ * @pre treePtr is NULL.
+ * @post treePtr points to a balanced subtree of every item in the segment,
+ *       with current heights, unless memory ran out; elements of owned[]
+ *       that were linked are NULL; linked includes every node linked.
+ * @return true if every item was linked; false if memory ran out.
+ */
+    bool forkLink(Node *& treePtr, const NodeData *const items[],
+                  NodeData *owned[], int low, int high, int level,
+                  int& linked);
 
 }; // end BinTree
 
 
+class BinTree::const_iterator
+{
+public:
+
+    typedef bidirectional_iterator_tag iterator_category;
+    typedef NodeData                   value_type;
+    typedef ptrdiff_t                  difference_type;
+    typedef const NodeData*            pointer;
+    typedef const NodeData&            reference;
+
+/**---------------------- Default Constructor ---------------------------------
+ * Creates an iterator that belongs to no tree.
+ * @pre None.
+ * @post This iterator may be assigned to but not moved or dereferenced.
+ */
+    const_iterator();
+
+/**---------------------- * Dereference Operator ------------------------------
+ * Provides the item at the position of this iterator.
+ * @pre This iterator is not at end().
+ * @post This iterator remains unchanged.
+ * @return A reference to the item at this position.
+ */
+    reference operator*(void) const;
+
+/**---------------------- -> Member Access Operator ---------------------------
+ * Provides the item at the position of this iterator.
+ * @pre This iterator is not at end().
+ * @post This iterator remains unchanged.
+ * @return A pointer to the item at this position.
+ */
+    pointer operator->(void) const;
+
+/**---------------------- ++ Increment Operators ------------------------------
+ * Moves this iterator to the next larger item, or to end() from the largest,
+ * passing over any tombstones.
+ * @pre This iterator is not at end().
+ * @post This iterator is at the in-order successor of its former position.
+ * @return This iterator after (prefix) or before (postfix) moving.
+ */
+    const_iterator& operator++(void);
+    const_iterator operator++(int);
+
+/**---------------------- -- Decrement Operators ------------------------------
+ * Moves this iterator to the next smaller item, or to the largest from end(),
+ * passing over any tombstones.
+ * @pre This iterator is not at begin().
+ * @post This iterator is at the in-order predecessor of its former position.
+ * @return This iterator after (prefix) or before (postfix) moving.
+ */
+    const_iterator& operator--(void);
+    const_iterator operator--(int);
+
+/**---------------------- == Equality Operator --------------------------------
+ * Determines whether two iterators of the same tree are at the same position.
+ * @param rhs  The right-hand iterator to be compared.
+ * @pre None.
+ * @post Both iterators remain unchanged.
+ * @return true if both iterators are at the same item, or both at end();
+ *         false, otherwise.
+ */
+    bool operator==(const const_iterator& rhs) const;
+
+/**---------------------- != Inequality Operator ------------------------------
+ * Determines whether two iterators of the same tree are at different
+ * positions.
+ * @param rhs  The right-hand iterator to be compared.
+ * @pre None.
+ * @post Both iterators remain unchanged.
+ * @return false if both iterators are at the same item, or both at end();
+ *         true, otherwise.
+ */
+    bool operator!=(const const_iterator& rhs) const;
+
+private:
+
+    friend class BinTree;
+
+    const Node *root;       // Root of the tree being traversed
+    const Node *current;    // Node at this position; NULL at end()
+    const Node *path[PATH_LIMIT];   // Nodes from root to current
+    int         depth;      // Number of nodes in path
+    bool        deep;       // true if current is deeper than PATH_LIMIT
+
+/**---------------------- Root Constructor ------------------------------------
+ * Creates an iterator at end() of the tree rooted at treePtr.
+ * @param treePtr  The root of the tree to be traversed; may be NULL.
+ * @pre None.
+ * @post This iterator is at end(); its path is empty.
+ */
+    explicit const_iterator(const Node *treePtr);
+
+/**---------------------- descend() -------------------------------------------
+ * Moves this iterator down to a node, recording it on the path. Once the
+ * path is full, only current is kept and deep is set.
+ * @param treePtr  The node to move to.
+ * @pre treePtr is not NULL; it is a child of current, or root if this
+ *      iterator is at end() with an empty path.
+ * @post current is treePtr.
+ */
+    void descend(const Node *treePtr);
+
+/**---------------------- moveTo() --------------------------------------------
+ * Moves this iterator back up a path just recorded by descend(), to the node
+ * at a given depth along it.
+ * @param treePtr  The node to move to, or NULL to move to end().
+ * @param level  The depth of treePtr on the path; 1 for the root.
+ * @pre treePtr was passed to descend() at depth level since the path was last
+ *      emptied, or is NULL.
+ * @post current is treePtr; the path is valid unless level > PATH_LIMIT.
+ */
+    void moveTo(const Node *treePtr, int level);
+
+/**---------------------- ascend() --------------------------------------------
+ * Moves this iterator up the path to the nearest ancestor of current that
+ * has current within its left (or right) subtree.
+ * @param fromLeft  true to find an ancestor reached through its left child;
+ *        false, for one reached through its right child.
+ * @pre This iterator is not deep and not at end().
+ * @post current is that ancestor, or NULL with an empty path if none exists.
+ */
+    void ascend(bool fromLeft);
+
+/**---------------------- seek() ----------------------------------------------
+ * Moves a deep iterator to the successor (or predecessor) of current by
+ * searching from the root.
+ * @param forward  true to find the successor; false, for the predecessor.
+ * @pre This iterator is deep and not at end().
+ * @post current is the successor (or predecessor), or NULL if none exists.
+ */
+    void seek(bool forward);
+
+/**---------------------- next() ----------------------------------------------
+ * Moves this iterator to the in-order successor of current, whether or not
+ * that node is a tombstone.
+ * @pre This iterator is not at end().
+ * @post current is the successor, or NULL if none exists.
+ */
+    void next(void);
+
+/**---------------------- previous() ------------------------------------------
+ * Moves this iterator to the in-order predecessor of current, or to the
+ * largest node from end(), whether or not that node is a tombstone.
+ * @pre This iterator is not at the smallest node.
+ * @post current is the predecessor.
+ */
+    void previous(void);
+
+}; // end BinTree::const_iterator
+
+
 #endif	/* _BINTREE_H */
@@ -0,0 +1,706 @@
+/*
+ * @file    bintreebench.cpp
+ * @brief   Microbenchmarks of the operations of BinTree, run with Google
+ *          Benchmark. Each case is run for trees of 1e3 to 1e7 keys. The keys
+ *          are "k" followed by an even number, zero padded so that numeric
+ *          and sorted order agree, and the odd numbers between them are the
+ *          keys that searches miss. Trees are torn down with the timer
+ *          paused, so each case times only its own operation.
+ *              bintreebench --benchmark_filter=Retrieve
+ *          runs only the cases whose names match the filter. The Search
+ *          cases time SearchTree, for NodeData and for integer keys, against
+ *          the Insert and Retrieve cases of a PLAIN BinTree, and PLAIN
+ *          against BALANCED integer trees for random and sorted inserts. The Rcu case
+ *          also checks its searches, so a build with -fsanitize=thread runs
+ *          it to catch readers racing the writer of an RcuBinTree.
+ * @author  Brendan Sweeney, SID 1161836
+ * @date    October 14, 2026
+ */
+
+#include <algorithm>        // for shuffle, reverse
+#include <cmath>            // for exp and log, to draw skewed keys
+#include <cstdint>          // for uint64_t
+#include <cstdio>           // for snprintf
+#include <map>              // keys of each size, made once
+#include <random>           // for mt19937
+#include <vector>           // keys and arrays of items
+
+#include <benchmark/benchmark.h>
+
+#include "bintree.h"
+#include "rcubintree.h"
+#include "searchtree.h"
+
+using namespace std;
+
+static const int MIN_KEYS = 1000;
+static const int MAX_KEYS = 10000000;
+static const int MAX_PLAIN_SORTED = 10000;  // a PLAIN tree of sorted keys is
+                                            // a list; inserts are quadratic
+
+// the order in which keys are inserted
+enum Order
+{
+    RANDOM,
+    SORTED,
+    REVERSE
+}; // end Order
+
+/**---------------------- makeKey() -------------------------------------------
+ * Makes the key of a number, padded so that keys sort in numeric order.
+ * @param number  The number of the key.
+ * @pre number is not negative.
+ * @post None.
+ * @return The key "k" followed by number in at least nine digits.
+ */
+static NodeData makeKey(int number)
+{
+    char text[16];
+
+    snprintf(text, sizeof(text), "k%09d", number);
+    return NodeData(text);
+} // end makeKey()
+
+/**---------------------- keysOf() --------------------------------------------
+ * Provides count keys in an order, made the first time they are asked for.
+ * Random keys are shuffled with a fixed seed, so every run sees the same.
+ * @param count  The number of keys.
+ * @param order  The order of the keys.
+ * @param miss  Whether the keys are those between the keys of a tree, which
+ *        searches of it miss.
+ * @pre count is greater than 0.
+ * @post None.
+ * @return The keys, which last until the program ends.
+ */
+static const vector<NodeData>& keysOf(int count, Order order, bool miss = false)
+{
+    static map<int, vector<NodeData> > made[3][2];
+    vector<NodeData>& keys = made[order][miss][count];
+
+    if (keys.empty())
+    {
+        keys.reserve(count);
+
+        for (int i = 0; i < count; ++i)
+        {
+            keys.push_back(makeKey(2 * i + miss));
+        } // end for (int i = 0)
+
+        if (order == RANDOM)
+        {
+            mt19937 engine(count);
+
+            shuffle(keys.begin(), keys.end(), engine);
+        } // end if (order == RANDOM)
+        else if (order == REVERSE)
+        {
+            reverse(keys.begin(), keys.end());
+        } // end else if (order == REVERSE)
+    } // end if (keys.empty())
+
+    return keys;
+} // end keysOf()
+
+/**---------------------- fill() ----------------------------------------------
+ * Inserts keys into a tree, one at a time.
+ * @param tree  The tree to fill.
+ * @param keys  The keys to insert, in order.
+ * @pre None.
+ * @post The tree holds every key.
+ */
+static void fill(BinTree& tree, const vector<NodeData>& keys)
+{
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        tree.insert(keys[i]);
+    } // end for (size_t i = 0)
+} // end fill()
+
+/**---------------------- finish() --------------------------------------------
+ * Records the number of keys handled by each iteration of a case.
+ * @param state  The state of the case.
+ * @param count  The number of keys handled by each iteration.
+ * @pre None.
+ * @post The items processed and size of the case are reported.
+ */
+static void finish(benchmark::State& state, int count)
+{
+    state.SetItemsProcessed(state.iterations() * count);
+    state.counters["keys"] = count;
+} // end finish()
+
+
+/**---------------------- BM_Insert() -----------------------------------------
+ * Times inserting state.range(0) keys, in an order, into an empty tree.
+ */
+static void BM_Insert(benchmark::State& state, Order order, int options)
+{
+    int                     count = static_cast<int>(state.range(0));
+    const vector<NodeData>& keys = keysOf(count, order);
+
+    for (auto _ : state)
+    {
+        BinTree tree(options);
+
+        fill(tree, keys);
+
+        state.PauseTiming();
+        tree.makeEmpty();
+        state.ResumeTiming();
+    } // end for (auto _ : state)
+
+    finish(state, count);
+} // end BM_Insert()
+
+/**---------------------- BM_Retrieve() ---------------------------------------
+ * Times one search of a tree of state.range(0) keys per iteration, for keys
+ * it holds or keys it lacks, taken in random order.
+ */
+static void BM_Retrieve(benchmark::State& state, bool miss)
+{
+    int                     count = static_cast<int>(state.range(0));
+    const vector<NodeData>& keys = keysOf(count, RANDOM, miss);
+    BinTree                 tree;
+    NodeData               *found;
+    size_t                  next = 0;
+
+    fill(tree, keysOf(count, RANDOM));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(tree.retrieve(keys[next], found));
+        next = (next + 1 == keys.size()) ? 0 : next + 1;
+    } // end for (auto _ : state)
+
+    state.SetItemsProcessed(state.iterations());
+    state.counters["keys"] = count;
+} // end BM_Retrieve()
+
+/**---------------------- BM_RetrieveZipf() -----------------------------------
+ * Times one search of a tree of state.range(0) keys per iteration, for keys
+ * drawn with Zipfian skew: the key of rank r, in random order, is sought in
+ * proportion to 1 / r, so a few hot keys take most of the searches.
+ */
+static void BM_RetrieveZipf(benchmark::State& state, int options)
+{
+    int                     count = static_cast<int>(state.range(0));
+    const vector<NodeData>& keys = keysOf(count, RANDOM);
+    vector<const NodeData*> drawn(1 << 16);
+    mt19937                 engine(count);
+    uniform_real_distribution<double> uniform(0.0, 1.0);
+    BinTree                 tree(options);
+    NodeData               *found;
+    size_t                  next = 0;
+
+    fill(tree, keys);
+
+    // the inverse of the cumulative density of 1 / r, over ranks 1 to count
+    for (size_t i = 0; i < drawn.size(); ++i)
+    {
+        int rank = static_cast<int>(exp(uniform(engine) * log(count + 1.0)));
+
+        drawn[i] = &keys[min(rank, count) - 1];
+    } // end for (size_t i = 0)
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(tree.retrieve(*drawn[next], found));
+        next = (next + 1 == drawn.size()) ? 0 : next + 1;
+    } // end for (auto _ : state)
+
+    state.SetItemsProcessed(state.iterations());
+    state.counters["keys"] = count;
+} // end BM_RetrieveZipf()
+
+/**---------------------- BM_GetDepth() ---------------------------------------
+ * Times finding the depth of one key of a tree of state.range(0) keys per
+ * iteration, taken in random order.
+ */
+static void BM_GetDepth(benchmark::State& state)
+{
+    int                     count = static_cast<int>(state.range(0));
+    const vector<NodeData>& keys = keysOf(count, RANDOM);
+    BinTree                 tree;
+    size_t                  next = 0;
+
+    fill(tree, keys);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(tree.getDepth(keys[next]));
+        next = (next + 1 == keys.size()) ? 0 : next + 1;
+    } // end for (auto _ : state)
+
+    state.SetItemsProcessed(state.iterations());
+    state.counters["keys"] = count;
+} // end BM_GetDepth()
+
+/**---------------------- BM_Rank() -------------------------------------------
+ * Times finding the rank of one key of a tree of state.range(0) keys per
+ * iteration, taken in random order.
+ */
+static void BM_Rank(benchmark::State& state)
+{
+    int                     count = static_cast<int>(state.range(0));
+    const vector<NodeData>& keys = keysOf(count, RANDOM);
+    BinTree                 tree;
+    size_t                  next = 0;
+
+    fill(tree, keys);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(tree.rank(keys[next]));
+        next = (next + 1 == keys.size()) ? 0 : next + 1;
+    } // end for (auto _ : state)
+
+    state.SetItemsProcessed(state.iterations());
+    state.counters["keys"] = count;
+} // end BM_Rank()
+
+/**---------------------- BM_Select() -----------------------------------------
+ * Times locating the item at one position of a tree of state.range(0) keys
+ * per iteration, stepping through the positions by a large prime.
+ */
+static void BM_Select(benchmark::State& state)
+{
+    int     count = static_cast<int>(state.range(0));
+    BinTree tree;
+    int     index = 0;
+
+    fill(tree, keysOf(count, RANDOM));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(tree.select(index));
+        index = static_cast<int>((index + 1000003LL) % count);
+    } // end for (auto _ : state)
+
+    state.SetItemsProcessed(state.iterations());
+    state.counters["keys"] = count;
+} // end BM_Select()
+
+/**---------------------- BM_Copy() -------------------------------------------
+ * Times copy constructing a tree of state.range(0) keys.
+ */
+static void BM_Copy(benchmark::State& state)
+{
+    int     count = static_cast<int>(state.range(0));
+    BinTree tree;
+
+    fill(tree, keysOf(count, RANDOM));
+
+    for (auto _ : state)
+    {
+        BinTree copy(tree);
+
+        benchmark::DoNotOptimize(copy.size());
+
+        state.PauseTiming();
+        copy.makeEmpty();
+        state.ResumeTiming();
+    } // end for (auto _ : state)
+
+    finish(state, count);
+} // end BM_Copy()
+
+/**---------------------- BM_Equal() ------------------------------------------
+ * Times comparing two trees of the same state.range(0) keys, built by
+ * inserting them in the same order, so that every node is compared.
+ */
+static void BM_Equal(benchmark::State& state)
+{
+    int                     count = static_cast<int>(state.range(0));
+    const vector<NodeData>& keys = keysOf(count, RANDOM);
+    BinTree                 left;
+    BinTree                 right;
+
+    fill(left, keys);
+    fill(right, keys);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(left == right);
+    } // end for (auto _ : state)
+
+    finish(state, count);
+} // end BM_Equal()
+
+/**---------------------- BM_ArrayRoundTrip() ---------------------------------
+ * Times moving the items of a tree of state.range(0) keys into an array with
+ * bstreeToArray(), then back into the tree with arrayToBSTree().
+ */
+static void BM_ArrayRoundTrip(benchmark::State& state)
+{
+    int               count = static_cast<int>(state.range(0));
+    vector<NodeData*> items(count + 1, NULL);   // NULL after the last item
+    BinTree           tree;
+
+    fill(tree, keysOf(count, RANDOM));
+
+    for (auto _ : state)
+    {
+        tree.bstreeToArray(items.data());
+        tree.arrayToBSTree(items.data());
+    } // end for (auto _ : state)
+
+    finish(state, count);
+} // end BM_ArrayRoundTrip()
+
+/**---------------------- BM_MakeEmpty() --------------------------------------
+ * Times emptying a copy of a tree of state.range(0) keys.
+ */
+static void BM_MakeEmpty(benchmark::State& state)
+{
+    int     count = static_cast<int>(state.range(0));
+    BinTree tree;
+
+    fill(tree, keysOf(count, RANDOM));
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        BinTree copy(tree);
+        state.ResumeTiming();
+
+        copy.makeEmpty();
+    } // end for (auto _ : state)
+
+    finish(state, count);
+} // end BM_MakeEmpty()
+
+/**---------------------- BM_Remove() -----------------------------------------
+ * Times removing every key of a tree of state.range(0) keys, one at a time,
+ * in random order, for a tree built with the given options.
+ */
+static void BM_Remove(benchmark::State& state, int options)
+{
+    int                     count = static_cast<int>(state.range(0));
+    const vector<NodeData>& keys = keysOf(count, RANDOM);
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        BinTree tree(options);
+
+        fill(tree, keys);
+        state.ResumeTiming();
+
+        for (size_t i = 0; i < keys.size(); ++i)
+        {
+            tree.remove(keys[i]);
+        } // end for (size_t i = 0)
+    } // end for (auto _ : state)
+
+    finish(state, count);
+} // end BM_Remove()
+
+/**---------------------- BM_RemoveIf() ---------------------------------------
+ * Times removing every other key of a tree of state.range(0) keys in one
+ * call, which marks them and then compacts the tree.
+ */
+static void BM_RemoveIf(benchmark::State& state)
+{
+    int                     count = static_cast<int>(state.range(0));
+    const vector<NodeData>& keys = keysOf(count, RANDOM);
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        BinTree tree;
+        bool    odd = false;
+
+        fill(tree, keys);
+        state.ResumeTiming();
+
+        tree.removeIf([&odd](const NodeData&)
+        {
+            odd = !odd;
+            return odd;
+        });
+    } // end for (auto _ : state)
+
+    finish(state, count);
+} // end BM_RemoveIf()
+
+// the tree of BM_RcuRetrieve, which outlives the threads of each run
+static RcuBinTree *rcuTree = NULL;
+
+/**---------------------- setUpRcu() ------------------------------------------
+ * Fills the tree of BM_RcuRetrieve before its threads start.
+ * @param state  The state of the run, with state.range(0) keys and options
+ *        state.range(1).
+ * @pre rcuTree is NULL.
+ * @post rcuTree holds every key.
+ */
+static void setUpRcu(const benchmark::State& state)
+{
+    int                     count = static_cast<int>(state.range(0));
+    const vector<NodeData>& keys = keysOf(count, RANDOM);
+
+    rcuTree = new RcuBinTree(static_cast<int>(state.range(1)));
+
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        rcuTree->insert(keys[i]);
+    } // end for (size_t i = 0)
+} // end setUpRcu()
+
+/**---------------------- tearDownRcu() ---------------------------------------
+ * Deletes the tree of BM_RcuRetrieve once its threads are done.
+ * @param state  The state of the run.
+ * @pre No thread is reading rcuTree.
+ * @post rcuTree is NULL.
+ */
+static void tearDownRcu(const benchmark::State&)
+{
+    delete rcuTree;
+    rcuTree = NULL;
+} // end tearDownRcu()
+
+/**---------------------- BM_RcuRetrieve() ------------------------------------
+ * Times one wait-free search of an RcuBinTree of state.range(0) keys, built
+ * with options state.range(1), per iteration of each reader thread, while the
+ * first thread removes and reinserts the keys at odd positions in turn. The
+ * keys at even positions are never removed, so the case fails if a reader
+ * misses one.
+ */
+static void BM_RcuRetrieve(benchmark::State& state)
+{
+    int                     count = static_cast<int>(state.range(0));
+    const vector<NodeData>& keys = keysOf(count, RANDOM);
+    bool                    writer = (state.thread_index() == 0);
+    int                     reader = (writer ? -1 : rcuTree->registerReader());
+    size_t                  next = (writer ? 1 : state.thread_index());
+    NodeData                found;
+
+    for (auto _ : state)
+    {
+        if (writer)
+        {
+            rcuTree->remove(keys[next]);
+            rcuTree->insert(keys[next]);
+            next = (next + 2 < keys.size()) ? next + 2 : 1;
+        }
+        else
+        {
+            if (!rcuTree->retrieve(reader, keys[next], found) && next % 2 == 0)
+            {
+                state.SkipWithError("a key never removed was not found");
+                break;
+            } // end if (!rcuTree->retrieve(reader, keys[next], found) && ...)
+
+            next = (next + 1 == keys.size()) ? 0 : next + 1;
+        } // end if (writer)
+    } // end for (auto _ : state)
+
+    if (!writer)
+    {
+        rcuTree->unregisterReader(reader);
+    } // end if (!writer)
+
+    state.SetItemsProcessed(state.iterations());
+} // end BM_RcuRetrieve()
+
+/**---------------------- integerKeys() ---------------------------------------
+ * Provides the numbers of count keys in random order, for the integer trees.
+ * @param count  The number of keys.
+ * @param miss  Whether the numbers are those between the keys of a tree.
+ * @pre count is greater than 0.
+ * @post None.
+ * @return The numbers, which last until the program ends.
+ */
+static const vector<uint64_t>& integerKeys(int count, bool miss = false)
+{
+    static map<int, vector<uint64_t> > made[2];
+    vector<uint64_t>& keys = made[miss][count];
+
+    if (keys.empty())
+    {
+        mt19937 engine(count);
+
+        keys.reserve(count);
+
+        for (int i = 0; i < count; ++i)
+        {
+            keys.push_back(2 * i + miss);
+        } // end for (int i = 0)
+
+        shuffle(keys.begin(), keys.end(), engine);
+    } // end if (keys.empty())
+
+    return keys;
+} // end integerKeys()
+
+// the keys of each kind of SearchTree, in random order
+template <class Tree>
+struct SearchKeys;
+
+template <>
+struct SearchKeys<NodeDataTree>
+{
+    static const vector<NodeData>& of(int count, bool miss)
+    {
+        return keysOf(count, RANDOM, miss);
+    } // end of()
+}; // end SearchKeys<NodeDataTree>
+
+template <>
+struct SearchKeys<SearchTree<uint64_t> >
+{
+    static const vector<uint64_t>& of(int count, bool miss)
+    {
+        return integerKeys(count, miss);
+    } // end of()
+}; // end SearchKeys<SearchTree<uint64_t> >
+
+/**---------------------- BM_SearchInsert() -----------------------------------
+ * Times inserting state.range(0) keys, in random order or, if sorted, in
+ * ascending order, into an empty SearchTree built with options.
+ */
+template <class Tree, int options, bool sorted>
+static void BM_SearchInsert(benchmark::State& state)
+{
+    int  count = static_cast<int>(state.range(0));
+    auto keys = SearchKeys<Tree>::of(count, false);
+
+    if (sorted)
+    {
+        sort(keys.begin(), keys.end());
+    } // end if (sorted)
+
+    for (auto _ : state)
+    {
+        Tree tree(options);
+
+        for (size_t i = 0; i < keys.size(); ++i)
+        {
+            tree.insert(keys[i]);
+        } // end for (size_t i = 0)
+
+        state.PauseTiming();
+        tree.makeEmpty();
+        state.ResumeTiming();
+    } // end for (auto _ : state)
+
+    finish(state, count);
+} // end BM_SearchInsert()
+
+/**---------------------- BM_SearchRetrieve() ---------------------------------
+ * Times one search of a SearchTree of state.range(0) keys per iteration, for
+ * keys it holds or, if miss, keys it lacks, taken in random order.
+ */
+template <class Tree, bool miss>
+static void BM_SearchRetrieve(benchmark::State& state)
+{
+    int         count = static_cast<int>(state.range(0));
+    const auto& keys = SearchKeys<Tree>::of(count, miss);
+    const auto& held = SearchKeys<Tree>::of(count, false);
+    Tree        tree;
+    const typename decay<decltype(keys[0])>::type *found;
+    size_t      next = 0;
+
+    for (size_t i = 0; i < held.size(); ++i)
+    {
+        tree.insert(held[i]);
+    } // end for (size_t i = 0)
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(tree.retrieve(keys[next], found));
+        next = (next + 1 == keys.size()) ? 0 : next + 1;
+    } // end for (auto _ : state)
+
+    state.SetItemsProcessed(state.iterations());
+    state.counters["keys"] = count;
+} // end BM_SearchRetrieve()
+
+
+BENCHMARK_CAPTURE(BM_Insert, Random, RANDOM, BinTree::PLAIN)
+    ->RangeMultiplier(10)->Range(MIN_KEYS, MAX_KEYS)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_Insert, Sorted, SORTED, BinTree::PLAIN)
+    ->RangeMultiplier(10)->Range(MIN_KEYS, MAX_PLAIN_SORTED)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_Insert, Reverse, REVERSE, BinTree::PLAIN)
+    ->RangeMultiplier(10)->Range(MIN_KEYS, MAX_PLAIN_SORTED)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_Insert, SortedBalanced, SORTED, BinTree::BALANCED)
+    ->RangeMultiplier(10)->Range(MIN_KEYS, MAX_KEYS)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_Insert, ReverseBalanced, REVERSE, BinTree::BALANCED)
+    ->RangeMultiplier(10)->Range(MIN_KEYS, MAX_KEYS)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_Retrieve, Hit, false)
+    ->RangeMultiplier(10)->Range(MIN_KEYS, MAX_KEYS);
+BENCHMARK_CAPTURE(BM_Retrieve, Miss, true)
+    ->RangeMultiplier(10)->Range(MIN_KEYS, MAX_KEYS);
+BENCHMARK_CAPTURE(BM_RetrieveZipf, Plain, BinTree::PLAIN)
+    ->RangeMultiplier(10)->Range(MIN_KEYS, MAX_KEYS);
+BENCHMARK_CAPTURE(BM_RetrieveZipf, Cached, BinTree::CACHED)
+    ->RangeMultiplier(10)->Range(MIN_KEYS, MAX_KEYS);
+BENCHMARK(BM_GetDepth)
+    ->RangeMultiplier(10)->Range(MIN_KEYS, MAX_KEYS);
+BENCHMARK(BM_Rank)
+    ->RangeMultiplier(10)->Range(MIN_KEYS, MAX_KEYS);
+BENCHMARK(BM_Select)
+    ->RangeMultiplier(10)->Range(MIN_KEYS, MAX_KEYS);
+BENCHMARK(BM_Copy)
+    ->RangeMultiplier(10)->Range(MIN_KEYS, MAX_KEYS)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Equal)
+    ->RangeMultiplier(10)->Range(MIN_KEYS, MAX_KEYS)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ArrayRoundTrip)
+    ->RangeMultiplier(10)->Range(MIN_KEYS, MAX_KEYS)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MakeEmpty)
+    ->RangeMultiplier(10)->Range(MIN_KEYS, MAX_KEYS)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_Remove, Random, BinTree::PLAIN)
+    ->RangeMultiplier(10)->Range(MIN_KEYS, MAX_KEYS)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_Remove, Balanced, BinTree::BALANCED)
+    ->RangeMultiplier(10)->Range(MIN_KEYS, MAX_KEYS)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_Remove, Lazy, BinTree::LAZY)
+    ->RangeMultiplier(10)->Range(MIN_KEYS, MAX_KEYS)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_RemoveIf)
+    ->RangeMultiplier(10)->Range(MIN_KEYS, MAX_KEYS)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_RcuRetrieve)
+    ->ArgNames({"keys", "options"})
+    ->ArgsProduct({ {MIN_KEYS, 100000},
+                    {BinTree::PLAIN, BinTree::BALANCED, BinTree::LAZY,
+                     BinTree::CACHED, BinTree::LAZY | BinTree::CACHED} })
+    ->Setup(setUpRcu)->Teardown(tearDownRcu)
+    ->Threads(4)->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_SearchInsert, NodeDataTree, NodeDataTree::PLAIN, false)
+    ->RangeMultiplier(10)->Range(MIN_KEYS, MAX_KEYS)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_SearchInsert, SearchTree<uint64_t>,
+                   SearchTree<uint64_t>::PLAIN, false)
+    ->RangeMultiplier(10)->Range(MIN_KEYS, MAX_KEYS)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_SearchInsert, SearchTree<uint64_t>,
+                   SearchTree<uint64_t>::BALANCED, false)
+    ->RangeMultiplier(10)->Range(MIN_KEYS, MAX_KEYS)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_SearchInsert, SearchTree<uint64_t>,
+                   SearchTree<uint64_t>::PLAIN, true)
+    ->RangeMultiplier(10)->Range(MIN_KEYS, MAX_PLAIN_SORTED)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_SearchInsert, SearchTree<uint64_t>,
+                   SearchTree<uint64_t>::BALANCED, true)
+    ->RangeMultiplier(10)->Range(MIN_KEYS, MAX_KEYS)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_SearchRetrieve, NodeDataTree, false)
+    ->RangeMultiplier(10)->Range(MIN_KEYS, MAX_KEYS);
+BENCHMARK_TEMPLATE(BM_SearchRetrieve, SearchTree<uint64_t>, false)
+    ->RangeMultiplier(10)->Range(MIN_KEYS, MAX_KEYS);
+BENCHMARK_TEMPLATE(BM_SearchRetrieve, SearchTree<uint64_t>, true)
+    ->RangeMultiplier(10)->Range(MIN_KEYS, MAX_KEYS);
+
+BENCHMARK_MAIN();
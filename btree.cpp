@@ -0,0 +1,809 @@
+/*
+ * @file    btree.cpp
+ * @brief   This class represents a B-tree which holds its data in NodeData
+ *          objects, to which it holds pointers, offering the interface of
+ *          BinTree for inserting, retrieving, writing, and comparing trees.
+ *          Each node holds up to MAX_KEYS items, so a search visits a few
+ *          wide nodes rather than one node per comparison. Beside the items,
+ *          a node keeps the first 8 bytes of each as an integer; a search
+ *          compares the key with all of them at once, with SIMD instructions
+ *          where the compiler targets them, and compares whole strings only
+ *          among the items whose prefixes tie.
+ * @author  Brendan Sweeney, SID 1161836
+ * @date    October 14, 2026
+ */
+
+#include <cstddef>          // definition of NULL
+#include <cstdint>          // for INT64_MAX
+#include <new>              // for bad_alloc
+#include <utility>          // for move and pair
+#include <vector>           // explicit stacks for traversals
+
+#if defined(__GNUC__) && (defined(__AVX2__) || defined(__SSE4_2__))
+#include <immintrin.h>      // 64-bit integer vector compares
+#endif
+
+#include "btree.h"
+
+using namespace std;
+
+/**---------------------- countPrefixes() -------------------------------------
+ * Counts the prefixes of a node that are less than a key and those that are
+ * not greater than it, comparing every slot so that no comparison branches.
+ * Four slots are compared at once with AVX2, two with SSE4.2, and one at a
+ * time otherwise.
+ * @param prefixes[]  The biased prefixes of a node, padded with INT64_MAX.
+ * @param slots  The number of elements in prefixes[], a multiple of 4.
+ * @param key  The biased prefix to compare with.
+ * @param below  A container for the number of prefixes less than key.
+ * @param atMost  A container for the number of prefixes not greater than key.
+ * @pre None.
+ * @post None.
+ */
+static void countPrefixes(const int64_t prefixes[], int slots, int64_t key,
+                          int& below, int& atMost)
+{
+    int above = 0;
+
+    below = 0;
+
+#if defined(__GNUC__) && defined(__AVX2__)
+    __m256i keys = _mm256_set1_epi64x(key);
+
+    for (int i = 0; i < slots; i += 4)
+    {
+        __m256i lane = _mm256_loadu_si256(
+                           reinterpret_cast<const __m256i*>(prefixes + i));
+
+        below += __builtin_popcount(_mm256_movemask_pd(
+                     _mm256_castsi256_pd(_mm256_cmpgt_epi64(keys, lane))));
+        above += __builtin_popcount(_mm256_movemask_pd(
+                     _mm256_castsi256_pd(_mm256_cmpgt_epi64(lane, keys))));
+    } // end for (int i = 0)
+#elif defined(__GNUC__) && defined(__SSE4_2__)
+    __m128i keys = _mm_set1_epi64x(key);
+
+    for (int i = 0; i < slots; i += 2)
+    {
+        __m128i lane = _mm_loadu_si128(
+                           reinterpret_cast<const __m128i*>(prefixes + i));
+
+        below += __builtin_popcount(_mm_movemask_pd(
+                     _mm_castsi128_pd(_mm_cmpgt_epi64(keys, lane))));
+        above += __builtin_popcount(_mm_movemask_pd(
+                     _mm_castsi128_pd(_mm_cmpgt_epi64(lane, keys))));
+    } // end for (int i = 0)
+#else
+    for (int i = 0; i < slots; ++i)
+    {
+        below += (prefixes[i] < key);
+        above += (prefixes[i] > key);
+    } // end for (int i = 0)
+#endif
+
+    atMost = slots - above;
+} // end countPrefixes(int64_t[], int, int64_t, int&, int&)
+
+
+/**---------------------- Node Constructor ------------------------------------
+ * Creates an empty node, whose prefixes are padded so no key is greater.
+ * @pre None.
+ * @post The node holds no items and no children.
+ */
+BTree::Node::Node() : count(0)
+{
+    for (int i = 0; i < SLOTS; ++i)
+    {
+        prefixes[i] = INT64_MAX;
+        keys[i] = NULL;
+        children[i] = NULL;
+    } // end for (int i = 0)
+
+    children[SLOTS] = NULL;
+} // end Node constructor
+
+/**---------------------- Default Constructor ---------------------------------
+ * Creates an empty tree.
+ * @pre None.
+ * @post An empty B-tree exists.
+ */
+BTree::BTree() : root(NULL), nodeCount(0), height(0)
+{
+} // end default constructor
+
+/**---------------------- Copy Constructor ------------------------------------
+ * Copies the tree orig into a new tree, node by node, with copies of its
+ * items.
+ * @param orig  The tree to be copied.
+ * @pre There is sufficient memory to allocate a copy of orig.
+ * @post A B-tree exists that is a structural copy of the tree orig; orig
+ *       remains unchanged.
+ */
+BTree::BTree(const BTree& orig) : root(NULL), nodeCount(0), height(0)
+{
+    try
+    {
+        copyTree(orig.root, root);
+        nodeCount = orig.nodeCount;
+        height = orig.height;
+    }
+    catch (bad_alloc e)
+    {
+        cerr << "Could not allocate memory: copyTree() failed.";
+        destroyTree(root);      // a partial copy is not a B-tree
+    } // end try
+} // end copy constructor
+
+/**---------------------- Destructor ------------------------------------------
+ * Deallocates memory for a tree before it is released.
+ * @pre None.
+ * @post This tree is empty before it is released; all NodeData objects to
+ *       which this tree held pointers are deleted.
+ */
+BTree::~BTree()
+{
+    makeEmpty();
+} // end destructor
+
+/**---------------------- isEmpty() -------------------------------------------
+ * Determines whether a B-tree is empty.
+ * @pre None.
+ * @post This tree remains unchanged.
+ * @return true if the tree is empty; false, otherwise.
+ */
+bool BTree::isEmpty(void) const
+{
+    return (root == NULL);
+} // end isEmpty()
+
+/**---------------------- makeEmpty() -----------------------------------------
+ * Deallocates memory for a tree.
+ * @pre None.
+ * @post This tree is now empty; all NodeData objects to which this tree held
+ *       pointers are deleted.
+ */
+void BTree::makeEmpty(void)
+{
+    destroyTree(root);
+    nodeCount = 0;
+    height = 0;
+} // end makeEmpty()
+
+/**---------------------- = Assignment Operator -------------------------------
+ * Copies the contents of rhs into this tree. Any contents of this tree are
+ * removed beforehand. The items of rhs are copied, so the trees are
+ * independent of each other.
+ * @param rhs  The right-hand tree to be copied.
+ * @pre There is sufficient memory to allocate a copy of rhs.
+ * @post This tree is a structural copy of rhs; rhs remains unchanged.
+ * @return This B-tree, which is equivalent to rhs.
+ */
+BTree& BTree::operator=(const BTree& rhs)
+{
+    if (this != &rhs)
+    {
+        makeEmpty();                // deallocate left-hand side
+
+        try
+        {
+            copyTree(rhs.root, root);
+            nodeCount = rhs.nodeCount;
+            height = rhs.height;
+        }
+        catch (bad_alloc e)
+        {
+            cerr << "Could not allocate memory: copyTree() failed.";
+            destroyTree(root);      // a partial copy is not a B-tree
+        } // end try
+    } // end if (this != &rhs)
+
+    return *this;
+} // end operator=(BTree&)
+
+/**---------------------- copyTree() ------------------------------------------
+ * Copies the tree rooted at treePtr into a tree rooted at newTreePtr. Each
+ * stack entry pairs a node to be copied with the link that will point to its
+ * copy.
+ * @param treePtr  The root of the tree to be copied.
+ * @param newTreePtr  A container for the root of a copy of treePtr.
+ * @pre newTreePtr is NULL.
+ * @post newTreePtr points to the root of a structural copy of the tree whose
+ *       root is pointed to by treePtr.
+ * @throw bad_alloc if memory could not be allocated; newTreePtr then points
+ *        to the part copied so far, which destroyTree() can free.
+ */
+void BTree::copyTree(const Node *treePtr, Node *& newTreePtr)
+{
+    vector< pair<const Node*, Node**> > pending;
+
+    if (treePtr != NULL)
+    {
+        pending.push_back(make_pair(treePtr, &newTreePtr));
+    } // end if (treePtr != NULL)
+
+    while (!pending.empty())
+    {
+        const Node *orig = pending.back().first;
+        Node      **link = pending.back().second;
+
+        pending.pop_back();
+        *link = new Node;
+
+        // the count grows with the items, so a failure leaves a valid node
+        for (int i = 0; i < orig->count; ++i)
+        {
+            (*link)->keys[i] = new NodeData(*orig->keys[i]);
+            (*link)->prefixes[i] = orig->prefixes[i];
+            ++(*link)->count;
+        } // end for (int i = 0)
+
+        if (orig->children[0] != NULL)
+        {
+            for (int i = orig->count; i >= 0; --i)
+            {
+                pending.push_back(make_pair(orig->children[i],
+                                            &(*link)->children[i]));
+            } // end for (int i = orig->count)
+        } // end if (orig->children[0] != NULL)
+    } // end while (!pending.empty())
+} // end copyTree(Node*, Node*&)
+
+/**---------------------- destroyTree() ---------------------------------------
+ * Deallocates memory for a tree, with the nodes still to be freed kept on an
+ * explicit stack.
+ * @param treePtr  Pointer to the root of the tree to be deallocated.
+ * @pre None.
+ * @post treePtr points to an empty tree; the items it held are deleted.
+ */
+void BTree::destroyTree(Node *& treePtr)
+{
+    vector<Node*> pending;
+
+    if (treePtr != NULL)
+    {
+        pending.push_back(treePtr);
+    } // end if (treePtr != NULL)
+
+    while (!pending.empty())
+    {
+        Node *current = pending.back();
+
+        pending.pop_back();
+
+        for (int i = 0; i <= current->count; ++i)
+        {
+            if (current->children[i] != NULL)
+            {
+                pending.push_back(current->children[i]);
+            } // end if (current->children[i] != NULL)
+
+            if (i < current->count)
+            {
+                delete current->keys[i];
+            } // end if (i < current->count)
+        } // end for (int i = 0)
+
+        delete current;
+    } // end while (!pending.empty())
+
+    treePtr = NULL;
+} // end destroyTree(Node*&)
+
+/**---------------------- == Equality Operator --------------------------------
+ * Compares this B-tree with another for equality. Equality means that both
+ * trees contain the same data and have the same structure, which they do if
+ * the same items were inserted in the same order.
+ * @param rhs  The right-hand tree to be compared.
+ * @pre NodeData provides an equality operator.
+ * @post Both B-trees remain unchanged.
+ * @return true if both trees have identical structures and content; false,
+ *         otherwise.
+ */
+bool BTree::operator==(const BTree& rhs) const
+{
+    vector< pair<const Node*, const Node*> > pending;
+    bool same = (nodeCount == rhs.nodeCount && height == rhs.height);
+
+    if (same && root != NULL)
+    {
+        pending.push_back(make_pair(root, rhs.root));
+    } // end if (same && root != NULL)
+
+    // both trees have the same height, so leaves are reached together
+    while (same && !pending.empty())
+    {
+        const Node *lhsPtr = pending.back().first;
+        const Node *rhsPtr = pending.back().second;
+
+        pending.pop_back();
+        same = (lhsPtr->count == rhsPtr->count);
+
+        // prefixes tell most items apart without touching them
+        for (int i = 0; i < lhsPtr->count && same; ++i)
+        {
+            same = (lhsPtr->prefixes[i] == rhsPtr->prefixes[i] &&
+                    *lhsPtr->keys[i] == *rhsPtr->keys[i]);
+        } // end for (int i = 0)
+
+        for (int i = 0; i <= lhsPtr->count && same
+                        && lhsPtr->children[0] != NULL; ++i)
+        {
+            pending.push_back(make_pair(lhsPtr->children[i],
+                                        rhsPtr->children[i]));
+        } // end for (int i = 0)
+    } // end while (same && !pending.empty())
+
+    return same;
+} // end operator==(BTree&)
+
+/**---------------------- != Inequality Operator ------------------------------
+ * Compares this B-tree with another for inequality. Inequality means that
+ * the trees contain different data or have different structures.
+ * @param rhs  The right-hand tree to be compared.
+ * @pre NodeData provides an equality operator.
+ * @post Both B-trees remain unchanged.
+ * @return false if both trees have identical structures and content; true,
+ *         otherwise.
+ */
+bool BTree::operator!=(const BTree& rhs) const
+{
+    return !(*this == rhs);
+} // end operator!=(BTree&)
+
+/**---------------------- << Stream Out Operator ------------------------------
+ * Writes the contents of a tree to the provided ostream, in sorted order,
+ * space separated on a single line.
+ * @param output  The ostream to which to write the tree's contents.
+ * @param source  The tree whose contents are to be written.
+ * @pre The ostream, output, is writable.
+ * @post The ostream, output, contains a string representing the contents of
+ *       the tree, in sorted order; the tree remains unchanged.
+ * @return A reference to the provided ostream, with the contents of the tree
+ *         appended to it.
+ */
+ostream& operator<<(ostream& output, const BTree& source)
+{
+    // each entry is a node and the number of its children already written
+    vector< pair<const BTree::Node*, int> > ancestors;
+
+    ancestors.reserve(source.height);
+
+    if (source.root != NULL)
+    {
+        ancestors.push_back(make_pair(source.root, 0));
+    } // end if (source.root != NULL)
+
+    while (!ancestors.empty())
+    {
+        const BTree::Node *treePtr = ancestors.back().first;
+        int                next = ancestors.back().second;
+
+        if (treePtr->children[0] == NULL)       // leaf: write every item
+        {
+            for (int i = 0; i < treePtr->count; ++i)
+            {
+                output << ' ' << *treePtr->keys[i];
+            } // end for (int i = 0)
+
+            ancestors.pop_back();
+        }
+        else if (next <= treePtr->count)        // child next is unwritten
+        {
+            if (next > 0)
+            {
+                output << ' ' << *treePtr->keys[next - 1];
+            } // end if (next > 0)
+
+            ++ancestors.back().second;
+            ancestors.push_back(make_pair(treePtr->children[next], 0));
+        }
+        else                                    // every child written
+        {
+            ancestors.pop_back();
+        } // end if (treePtr->children[0] == NULL)
+    } // end while (!ancestors.empty())
+
+    output << endl;
+
+    return output;
+} // end operator<<(ostream&, BTree&)
+
+/**---------------------- insert() --------------------------------------------
+ * Inserts an item into a B-tree, taking ownership of newItem if it is
+ * inserted. Full nodes on the way are split, so every leaf stays at the same
+ * depth; nothing is changed if newItem is already in the tree.
+ * @param newItem  An object to be added to the tree.
+ * @pre NodeData provides the compare() and prefix() methods.
+ * @post newItem is in its proper position in the tree.
+ * @return true if newItem could be inserted in the tree; false if newItem
+ *         already existed in the tree or memory could not be allocated.
+ */
+bool BTree::insert(NodeData *newItem)
+{
+    return insertItem(*newItem, newItem, NULL);
+} // end insert(NodeData*)
+
+/**---------------------- insert() --------------------------------------------
+ * Inserts an item into a B-tree by moving its value into a heap object owned
+ * by the tree. The value is only moved if newItem is not already in the tree.
+ * @param newItem  An object whose value is to be added to the tree.
+ * @pre NodeData provides the compare() and prefix() methods.
+ * @post The former value of newItem is in its proper position in the tree,
+ *       and newItem is empty; if the insertion failed, newItem is unchanged.
+ * @return true if newItem could be inserted in the tree; false if newItem
+ *         already existed in the tree or memory could not be allocated.
+ */
+bool BTree::insert(NodeData&& newItem)
+{
+    return insertItem(newItem, NULL, &newItem);
+} // end insert(NodeData&&)
+
+/**---------------------- insert() --------------------------------------------
+ * Inserts a copy of an item into a B-tree; the caller keeps ownership of
+ * newItem. The copy is only made if newItem is not already in the tree.
+ * @param newItem  An object whose value is to be added to the tree.
+ * @pre NodeData provides the compare() and prefix() methods.
+ * @post A copy of newItem is in its proper position in the tree.
+ * @return true if newItem could be inserted in the tree; false if newItem
+ *         already existed in the tree or memory could not be allocated.
+ */
+bool BTree::insert(const NodeData& newItem)
+{
+    return insertItem(newItem, NULL, NULL);
+} // end insert(NodeData&)
+
+/**---------------------- insertItem() ----------------------------------------
+ * Inserts an item into a B-tree, recording the path followed so that full
+ * nodes may be split from the leaf up without recursion. Every node the
+ * splits need is allocated before the tree is changed.
+ * @param newItem  The item to be inserted into this tree.
+ * @param owned  A heap object equal to newItem that this tree may keep, or
+ *        NULL if newItem must be copied or moved.
+ * @param movable  newItem, if its value may be moved into the tree; NULL,
+ *        otherwise.
+ * @pre NodeData provides the compare() and prefix() methods.
+ * @post newItem is in its proper position in the tree.
+ * @return true if the item is successfully inserted; false if the item already
+ *         exists in this tree or memory could not be allocated.
+ */
+bool BTree::insertItem(const NodeData& newItem, NodeData *owned,
+                                                NodeData *movable)
+{
+    Node   *path[HEIGHT_LIMIT];     // nodes from the root to a leaf
+    int     slot[HEIGHT_LIMIT];     // position of newItem in each
+    Node   *spare[HEIGHT_LIMIT + 1];    // nodes allocated for splits
+    int     length = 0;
+    int     needed = 0;
+    int64_t prefix = biasedPrefix(newItem);
+    Node   *treePtr = root;
+    bool    found = false;
+    bool    success;
+
+    // search for the leaf to insert into
+    while (treePtr != NULL && !found)
+    {
+        slot[length] = rankOf(treePtr, newItem, prefix, found);
+        path[length++] = treePtr;
+        treePtr = treePtr->children[slot[length - 1]];
+    } // end while (treePtr != NULL && !found)
+
+    success = !found;       // duplicates are not allowed
+
+    if (success)
+    {
+        NodeData *item = owned;
+
+        // full nodes from the leaf up split; if all do, a new root is needed
+        while (needed < length && path[length - 1 - needed]->count == MAX_KEYS)
+        {
+            ++needed;
+        } // end while (needed < length && ...)
+
+        if (needed == length)
+        {
+            ++needed;
+        } // end if (needed == length)
+
+        try
+        {
+            for (int made = 0; made < needed; ++made)
+            {
+                spare[made] = NULL;     // freed below if allocation fails
+                spare[made] = new Node;
+            } // end for (int made = 0)
+
+            if (item == NULL)
+            {
+                item = (movable != NULL ? new NodeData(std::move(*movable))
+                                        : new NodeData(newItem));
+            } // end if (item == NULL)
+        }
+        catch (bad_alloc e)
+        {
+            cerr << "Could not allocate memory for " << newItem
+                 << ": insert() failed.";
+
+            for (int made = 0; made < needed && spare[made] != NULL; ++made)
+            {
+                delete spare[made];
+            } // end for (int made = 0)
+
+            success = false;
+        } // end try
+
+        if (success)
+        {
+            Node *right = NULL;     // new subtree to the right of item
+            bool  placing = true;
+
+            // place the item, splitting and pushing the median up while full
+            while (placing && length > 0)
+            {
+                --length;
+                placeKey(path[length], slot[length], item, prefix, right);
+
+                if (path[length]->count > MAX_KEYS)
+                {
+                    right = spare[--needed];
+                    split(path[length], right, item, prefix);
+                }
+                else
+                {
+                    placing = false;
+                } // end if (path[length]->count > MAX_KEYS)
+            } // end while (placing && length > 0)
+
+            // the root split, or the tree was empty; grow a new root
+            if (placing)
+            {
+                Node *top = spare[--needed];
+
+                top->children[0] = root;
+                placeKey(top, 0, item, prefix, right);
+                root = top;
+                ++height;
+            } // end if (placing)
+
+            ++nodeCount;
+        } // end if (success)
+    } // end if (success)
+
+    return success;
+} // end insertItem(NodeData&, NodeData*, NodeData*)
+
+/**---------------------- placeKey() ------------------------------------------
+ * Places an item and the subtree to its right into a node, shifting larger
+ * items along. The node may be left holding one item more than MAX_KEYS.
+ * @param treePtr  The node to hold the item.
+ * @param position  The slot for the item.
+ * @param item  The item to be placed.
+ * @param prefix  The biased prefix of item.
+ * @param right  The subtree of items greater than item; NULL in a leaf.
+ * @pre treePtr holds at most MAX_KEYS items; position is the rank of item.
+ * @post item is in slot position of treePtr, with right as the child after
+ *       it.
+ */
+void BTree::placeKey(Node *treePtr, int position, NodeData *item,
+                     int64_t prefix, Node *right)
+{
+    for (int i = treePtr->count; i > position; --i)
+    {
+        treePtr->keys[i] = treePtr->keys[i - 1];
+        treePtr->prefixes[i] = treePtr->prefixes[i - 1];
+        treePtr->children[i + 1] = treePtr->children[i];
+    } // end for (int i = treePtr->count)
+
+    treePtr->keys[position] = item;
+    treePtr->prefixes[position] = prefix;
+    treePtr->children[position + 1] = right;
+    ++treePtr->count;
+} // end placeKey(Node*, int, NodeData*, int64_t, Node*)
+
+/**---------------------- split() ---------------------------------------------
+ * Splits a node holding one item more than MAX_KEYS around its median,
+ * moving the items above the median into an empty node.
+ * @param treePtr  The node to split.
+ * @param sibling  An empty node to take the upper half.
+ * @param median  A container for the median item.
+ * @param prefix  A container for the biased prefix of the median.
+ * @pre treePtr holds SLOTS items.
+ * @post treePtr holds the items below the median and sibling those above;
+ *       the median belongs to neither.
+ */
+void BTree::split(Node *treePtr, Node *sibling, NodeData *& median,
+                  int64_t& prefix)
+{
+    int middle = SLOTS / 2;
+
+    median = treePtr->keys[middle];
+    prefix = treePtr->prefixes[middle];
+    sibling->children[0] = treePtr->children[middle + 1];
+    treePtr->children[middle + 1] = NULL;
+
+    for (int i = middle + 1; i < SLOTS; ++i)
+    {
+        int moved = sibling->count++;
+
+        sibling->keys[moved] = treePtr->keys[i];
+        sibling->prefixes[moved] = treePtr->prefixes[i];
+        sibling->children[moved + 1] = treePtr->children[i + 1];
+        treePtr->children[i + 1] = NULL;
+    } // end for (int i = middle + 1)
+
+    // slots past the last item are padded again, so no search matches them
+    for (int i = middle; i < SLOTS; ++i)
+    {
+        treePtr->keys[i] = NULL;
+        treePtr->prefixes[i] = INT64_MAX;
+    } // end for (int i = middle)
+
+    treePtr->count = middle;
+} // end split(Node*, Node*, NodeData*&, int64_t&)
+
+/**---------------------- biasedPrefix() --------------------------------------
+ * Determines the prefix of an item as it is stored in a node: shifted by
+ * 2^63, so that signed comparisons order prefixes as unsigned ones would.
+ * @param item  The item whose prefix is wanted.
+ * @pre NodeData provides the prefix() method.
+ * @post None.
+ * @return The biased prefix of item.
+ */
+int64_t BTree::biasedPrefix(const NodeData& item)
+{
+    return static_cast<int64_t>(item.prefix() ^ 0x8000000000000000ULL);
+} // end biasedPrefix(NodeData&)
+
+/**---------------------- rankOf() --------------------------------------------
+ * Determines the position of an item among the items of a node: the number
+ * of them that are less than it. Prefixes decide the position wherever they
+ * differ; only items whose prefixes equal that of the item are compared.
+ * @param treePtr  The node to search.
+ * @param item  The item to be located.
+ * @param prefix  The biased prefix of item.
+ * @param found  A container for whether the item at that position is equal
+ *        to item.
+ * @pre treePtr is not NULL.
+ * @post The node remains unchanged.
+ * @return The number of items of treePtr that are less than item.
+ */
+int BTree::rankOf(const Node *treePtr, const NodeData& item,
+                  int64_t prefix, bool& found)
+{
+    int  position;
+    int  atMost;
+    bool searching = true;
+
+    countPrefixes(treePtr->prefixes, SLOTS, prefix, position, atMost);
+
+    // padding ties with the largest prefix; it holds no items
+    if (atMost > treePtr->count)
+    {
+        atMost = treePtr->count;
+    } // end if (atMost > treePtr->count)
+
+    found = false;
+
+    // items whose prefixes tie are in order; find the first not less
+    while (position < atMost && searching)
+    {
+        int order = item.compare(*treePtr->keys[position]);
+
+        if (order <= 0)
+        {
+            found = (order == 0);
+            searching = false;
+        }
+        else
+        {
+            ++position;
+        } // end if (order <= 0)
+    } // end while (position < atMost && searching)
+
+    return position;
+} // end rankOf(Node*, NodeData&, int64_t, bool&)
+
+/**---------------------- retrieve() ------------------------------------------
+ * Retrieves a given item from a B-tree. Each node on the path is searched by
+ * comparing prefixes first, so most nodes cost no string comparison at all.
+ * @param searchItem  The item to be located.
+ * @param dataItem  A container for the found item.
+ * @pre NodeData provides the compare() and prefix() methods.
+ * @post If the retrieval was successful, dataItem contains the retrieved item;
+ *       this tree remains unchanged.
+ * @return true if searchItem matches an item in the tree; false if searchItem
+ *         could not be found.
+ */
+bool BTree::retrieve(const NodeData& searchItem, NodeData *& dataItem) const
+{
+    int level;
+    NodeData *const *slotPtr = locate(searchItem, level);
+
+    if (slotPtr != NULL)
+    {
+        dataItem = *slotPtr;
+    } // end if (slotPtr != NULL)
+
+    return (slotPtr != NULL);
+} // end retrieve(NodeData&, NodeData*&)
+
+/**---------------------- getDepth() ------------------------------------------
+ * Determines the depth of the node holding an item in a B-tree. If the item
+ * is found in the root, the depth is 1. If it is not found, the depth is 0.
+ * @param searchItem  The item to locate in the tree.
+ * @pre NodeData provides the compare() and prefix() methods.
+ * @post This tree remains unchanged.
+ * @return The depth of the node containing searchItem, if found; 0, otherwise.
+ */
+int BTree::getDepth(const NodeData& searchItem) const
+{
+    int level;
+
+    if (locate(searchItem, level) == NULL)
+    {
+        level = 0;
+    } // end if (locate(searchItem, level) == NULL)
+
+    return level;
+} // end getDepth(NodeData&)
+
+/**---------------------- locate() --------------------------------------------
+ * Finds the node holding an item.
+ * @param searchItem  The item to be located.
+ * @param level  A container for the depth of that node, where the root is at
+ *        depth 1.
+ * @pre NodeData provides the compare() and prefix() methods.
+ * @post This tree remains unchanged.
+ * @return The slot holding searchItem in that node, or NULL if no node holds
+ *         it.
+ */
+NodeData *const *BTree::locate(const NodeData& searchItem, int& level) const
+{
+    int64_t          prefix = biasedPrefix(searchItem);
+    const Node      *treePtr = root;
+    NodeData *const *slotPtr = NULL;
+
+    level = 0;
+
+    // descend one node per level until the item or a leaf is passed
+    while (treePtr != NULL && slotPtr == NULL)
+    {
+        bool found;
+        int  position = rankOf(treePtr, searchItem, prefix, found);
+
+        ++level;
+
+        if (found)
+        {
+            slotPtr = &treePtr->keys[position];
+        }
+        else
+        {
+            treePtr = treePtr->children[position];
+        } // end if (found)
+    } // end while (treePtr != NULL && slotPtr == NULL)
+
+    return slotPtr;
+} // end locate(NodeData&, int&)
+
+/**---------------------- getHeight() -----------------------------------------
+ * Determines the height of a B-tree, in nodes. An empty tree has a height of
+ * 0 and a tree with only a root has a height of 1.
+ * @pre None.
+ * @post This tree remains unchanged.
+ * @return The number of nodes on the path from the root to any leaf.
+ */
+int BTree::getHeight(void) const
+{
+    return height;
+} // end getHeight()
+
+/**---------------------- size() ----------------------------------------------
+ * Determines the number of items in a B-tree.
+ * @pre None.
+ * @post This tree remains unchanged.
+ * @return The number of items in this tree.
+ */
+int BTree::size(void) const
+{
+    return nodeCount;
+} // end size()
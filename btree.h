@@ -0,0 +1,328 @@
+/*
+ * @file    btree.h
+ * @brief   This class represents a B-tree which holds its data in NodeData
+ *          objects, to which it holds pointers, offering the interface of
+ *          BinTree for inserting, retrieving, writing, and comparing trees.
+ *          Each node holds up to MAX_KEYS items, so a search visits a few
+ *          wide nodes rather than one node per comparison. Beside the items,
+ *          a node keeps the first 8 bytes of each as an integer; a search
+ *          compares the key with all of them at once, with SIMD instructions
+ *          where the compiler targets them, and compares whole strings only
+ *          among the items whose prefixes tie.
+ * @author  Brendan Sweeney, SID 1161836
+ * @date    October 14, 2026
+ */
+
+#ifndef _BTREE_H
+#define	_BTREE_H
+
+#include <cstdint>          // for int64_t
+
+#include "nodedata.h"
+
+
+class BTree
+{
+/**---------------------- << Stream Out Operator ------------------------------
+ * Writes the contents of a tree to the provided ostream, in sorted order,
+ * space separated on a single line.
+ * @param output  The ostream to which to write the tree's contents.
+ * @param source  The tree whose contents are to be written.
+ * @pre The ostream, output, is writable.
+ * @post The ostream, output, contains a string representing the contents of
+ *       the tree, in sorted order; the tree remains unchanged.
+ * @return A reference to the provided ostream, with the contents of the tree
+ *         appended to it.
+ */
+    friend ostream& operator<<(ostream& output, const BTree& source);
+
+public:
+
+    // most items a node holds; a full node is split in two around its median
+    static const int MAX_KEYS = 31;
+
+/**---------------------- Default Constructor ---------------------------------
+ * Creates an empty tree.
+ * @pre None.
+ * @post An empty B-tree exists.
+ */
+    BTree();
+
+/**---------------------- Copy Constructor ------------------------------------
+ * Copies the tree orig into a new tree, node by node, with copies of its
+ * items.
+ * @param orig  The tree to be copied.
+ * @pre There is sufficient memory to allocate a copy of orig.
+ * @post A B-tree exists that is a structural copy of the tree orig; orig
+ *       remains unchanged.
+ */
+    BTree(const BTree& orig);
+
+/**---------------------- Destructor ------------------------------------------
+ * Deallocates memory for a tree before it is released.
+ * @pre None.
+ * @post This tree is empty before it is released; all NodeData objects to
+ *       which this tree held pointers are deleted.
+ */
+    ~BTree();
+
+/**---------------------- isEmpty() -------------------------------------------
+ * Determines whether a B-tree is empty.
+ * @pre None.
+ * @post This tree remains unchanged.
+ * @return true if the tree is empty; false, otherwise.
+ */
+    bool isEmpty(void) const;
+
+/**---------------------- makeEmpty() -----------------------------------------
+ * Deallocates memory for a tree.
+ * @pre None.
+ * @post This tree is now empty; all NodeData objects to which this tree held
+ *       pointers are deleted.
+ */
+    void makeEmpty(void);
+
+/**---------------------- = Assignment Operator -------------------------------
+ * Copies the contents of rhs into this tree. Any contents of this tree are
+ * removed beforehand. The items of rhs are copied, so the trees are
+ * independent of each other.
+ * @param rhs  The right-hand tree to be copied.
+ * @pre There is sufficient memory to allocate a copy of rhs.
+ * @post This tree is a structural copy of rhs; rhs remains unchanged.
+ * @return This B-tree, which is equivalent to rhs.
+ */
+    BTree& operator=(const BTree& rhs);
+
+/**---------------------- == Equality Operator --------------------------------
+ * Compares this B-tree with another for equality. Equality means that both
+ * trees contain the same data and have the same structure, which they do if
+ * the same items were inserted in the same order.
+ * @param rhs  The right-hand tree to be compared.
+ * @pre NodeData provides an equality operator.
+ * @post Both B-trees remain unchanged.
+ * @return true if both trees have identical structures and content; false,
+ *         otherwise.
+ */
+    bool operator==(const BTree& rhs) const;
+
+/**---------------------- != Inequality Operator ------------------------------
+ * Compares this B-tree with another for inequality. Inequality means that
+ * the trees contain different data or have different structures.
+ * @param rhs  The right-hand tree to be compared.
+ * @pre NodeData provides an equality operator.
+ * @post Both B-trees remain unchanged.
+ * @return false if both trees have identical structures and content; true,
+ *         otherwise.
+ */
+    bool operator!=(const BTree& rhs) const;
+
+/**---------------------- insert() --------------------------------------------
+ * Inserts an item into a B-tree, taking ownership of newItem if it is
+ * inserted. Full nodes on the way are split, so every leaf stays at the same
+ * depth; nothing is changed if newItem is already in the tree.
+ * @param newItem  An object to be added to the tree.
+ * @pre NodeData provides the compare() and prefix() methods.
+ * @post newItem is in its proper position in the tree.
+ * @return true if newItem could be inserted in the tree; false if newItem
+ *         already existed in the tree or memory could not be allocated.
+ */
+    bool insert(NodeData *newItem);
+
+/**---------------------- insert() --------------------------------------------
+ * Inserts an item into a B-tree by moving its value into a heap object owned
+ * by the tree. The value is only moved if newItem is not already in the tree.
+ * @param newItem  An object whose value is to be added to the tree.
+ * @pre NodeData provides the compare() and prefix() methods.
+ * @post The former value of newItem is in its proper position in the tree,
+ *       and newItem is empty; if the insertion failed, newItem is unchanged.
+ * @return true if newItem could be inserted in the tree; false if newItem
+ *         already existed in the tree or memory could not be allocated.
+ */
+    bool insert(NodeData&& newItem);
+
+/**---------------------- insert() --------------------------------------------
+ * Inserts a copy of an item into a B-tree; the caller keeps ownership of
+ * newItem. The copy is only made if newItem is not already in the tree.
+ * @param newItem  An object whose value is to be added to the tree.
+ * @pre NodeData provides the compare() and prefix() methods.
+ * @post A copy of newItem is in its proper position in the tree.
+ * @return true if newItem could be inserted in the tree; false if newItem
+ *         already existed in the tree or memory could not be allocated.
+ */
+    bool insert(const NodeData& newItem);
+
+/**---------------------- retrieve() ------------------------------------------
+ * Retrieves a given item from a B-tree. Each node on the path is searched by
+ * comparing prefixes first, so most nodes cost no string comparison at all.
+ * @param searchItem  The item to be located.
+ * @param dataItem  A container for the found item.
+ * @pre NodeData provides the compare() and prefix() methods.
+ * @post If the retrieval was successful, dataItem contains the retrieved item;
+ *       this tree remains unchanged.
+ * @return true if searchItem matches an item in the tree; false if searchItem
+ *         could not be found.
+ */
+    bool retrieve(const NodeData& searchItem,
+                        NodeData *& dataItem) const;
+
+/**---------------------- getDepth() ------------------------------------------
+ * Determines the depth of the node holding an item in a B-tree. If the item
+ * is found in the root, the depth is 1. If it is not found, the depth is 0.
+ * @param searchItem  The item to locate in the tree.
+ * @pre NodeData provides the compare() and prefix() methods.
+ * @post This tree remains unchanged.
+ * @return The depth of the node containing searchItem, if found; 0, otherwise.
+ */
+    int getDepth(const NodeData& searchItem) const;
+
+/**---------------------- getHeight() -----------------------------------------
+ * Determines the height of a B-tree, in nodes. An empty tree has a height of
+ * 0 and a tree with only a root has a height of 1.
+ * @pre None.
+ * @post This tree remains unchanged.
+ * @return The number of nodes on the path from the root to any leaf.
+ */
+    int getHeight(void) const;
+
+/**---------------------- size() ----------------------------------------------
+ * Determines the number of items in a B-tree.
+ * @pre None.
+ * @post This tree remains unchanged.
+ * @return The number of items in this tree.
+ */
+    int size(void) const;
+
+private:
+
+    // slots in a node: one beyond MAX_KEYS, so a prefix search always covers
+    // a whole number of vectors and prefixes past the last item never match
+    static const int SLOTS = MAX_KEYS + 1;
+
+    // no tree of int-counted items is deeper than this
+    static const int HEIGHT_LIMIT = 16;
+
+    struct alignas(64) Node
+    {
+        int64_t   prefixes[SLOTS];  // Prefixes of keys, biased to sort signed
+        NodeData *keys[SLOTS];      // Items in ascending order
+        Node     *children[SLOTS + 1];  // Subtrees around keys; NULL in a leaf
+        int       count;            // Number of items held
+
+        Node();
+    }; // end Node
+
+    Node *root;             // Pointer to root of tree
+    int   nodeCount;        // Number of items in this tree
+    int   height;           // Nodes on every path from root to a leaf
+
+/**---------------------- biasedPrefix() --------------------------------------
+ * Determines the prefix of an item as it is stored in a node: shifted by
+ * 2^63, so that signed comparisons order prefixes as unsigned ones would.
+ * @param item  The item whose prefix is wanted.
+ * @pre NodeData provides the prefix() method.
+ * @post None.
+ * @return The biased prefix of item.
+ */
+    static int64_t biasedPrefix(const NodeData& item);
+
+/**---------------------- rankOf() --------------------------------------------
+ * Determines the position of an item among the items of a node: the number
+ * of them that are less than it. Prefixes decide the position wherever they
+ * differ; only items whose prefixes equal that of the item are compared.
+ * @param treePtr  The node to search.
+ * @param item  The item to be located.
+ * @param prefix  The biased prefix of item.
+ * @param found  A container for whether the item at that position is equal
+ *        to item.
+ * @pre treePtr is not NULL.
+ * @post The node remains unchanged.
+ * @return The number of items of treePtr that are less than item.
+ */
+    static int rankOf(const Node *treePtr, const NodeData& item,
+                      int64_t prefix, bool& found);
+
+/**---------------------- locate() --------------------------------------------
+ * Finds the node holding an item.
+ * @param searchItem  The item to be located.
+ * @param level  A container for the depth of that node, where the root is at
+ *        depth 1.
+ * @pre NodeData provides the compare() and prefix() methods.
+ * @post This tree remains unchanged.
+ * @return The slot holding searchItem in that node, or NULL if no node holds
+ *         it.
+ */
+    NodeData *const *locate(const NodeData& searchItem, int& level) const;
+
+/**---------------------- insertItem() ----------------------------------------
+ * Inserts an item into a B-tree, recording the path followed so that full
+ * nodes may be split from the leaf up without recursion. Every node the
+ * splits need is allocated before the tree is changed.
+ * @param newItem  The item to be inserted into this tree.
+ * @param owned  A heap object equal to newItem that this tree may keep, or
+ *        NULL if newItem must be copied or moved.
+ * @param movable  newItem, if its value may be moved into the tree; NULL,
+ *        otherwise.
+ * @pre NodeData provides the compare() and prefix() methods.
+ * @post newItem is in its proper position in the tree.
+ * @return true if the item is successfully inserted; false if the item already
+ *         exists in this tree or memory could not be allocated.
+ */
+    bool insertItem(const NodeData& newItem, NodeData *owned,
+                                             NodeData *movable);
+
+/**---------------------- placeKey() ------------------------------------------
+ * Places an item and the subtree to its right into a node, shifting larger
+ * items along. The node may be left holding one item more than MAX_KEYS.
+ * @param treePtr  The node to hold the item.
+ * @param position  The slot for the item.
+ * @param item  The item to be placed.
+ * @param prefix  The biased prefix of item.
+ * @param right  The subtree of items greater than item; NULL in a leaf.
+ * @pre treePtr holds at most MAX_KEYS items; position is the rank of item.
+ * @post item is in slot position of treePtr, with right as the child after
+ *       it.
+ */
+    static void placeKey(Node *treePtr, int position, NodeData *item,
+                         int64_t prefix, Node *right);
+
+/**---------------------- split() ---------------------------------------------
+ * Splits a node holding one item more than MAX_KEYS around its median,
+ * moving the items above the median into an empty node.
+ * @param treePtr  The node to split.
+ * @param sibling  An empty node to take the upper half.
+ * @param median  A container for the median item.
+ * @param prefix  A container for the biased prefix of the median.
+ * @pre treePtr holds SLOTS items.
+ * @post treePtr holds the items below the median and sibling those above;
+ *       the median belongs to neither.
+ */
+    static void split(Node *treePtr, Node *sibling, NodeData *& median,
+                      int64_t& prefix);
+
+/**---------------------- copyTree() ------------------------------------------
+ * Copies the tree rooted at treePtr into a tree rooted at newTreePtr. Each
+ * stack entry pairs a node to be copied with the link that will point to its
+ * copy.
+ * @param treePtr  The root of the tree to be copied.
+ * @param newTreePtr  A container for the root of a copy of treePtr.
+ * @pre newTreePtr is NULL.
+ * @post newTreePtr points to the root of a structural copy of the tree whose
+ *       root is pointed to by treePtr.
+ * @throw bad_alloc if memory could not be allocated; newTreePtr then points
+ *        to the part copied so far, which destroyTree() can free.
+ */
+    static void copyTree(const Node *treePtr, Node *& newTreePtr);
+
+/**---------------------- destroyTree() ---------------------------------------
+ * Deallocates memory for a tree, with the nodes still to be freed kept on an
+ * explicit stack.
+ * @param treePtr  Pointer to the root of the tree to be deallocated.
+ * @pre None.
+ * @post treePtr points to an empty tree; the items it held are deleted.
+ */
+    static void destroyTree(Node *& treePtr);
+
+}; // end BTree
+
+
+#endif	/* _BTREE_H */
@@ -10,74 +10,40 @@
 
 // presumably bintree.h includes nodedata.h so the include is not needed here
 #include "bintree.h"
-#include <fstream>
+#include "pipeline.h"
+#include "treeloader.h"
 #include <iostream>
 using namespace std;
 
-const int ARRAYSIZE = 100;
-
 //global function prototypes
-void buildTree(BinTree&, ifstream&);
-void initArray(NodeData* []);
+void buildTree(BinTree&, TreeLoader&);
+void testTree(BinTree&, const BinTree&, BinTree&);
+int runPipeline(const char*);
+
+int main(int argc, char *argv[]) {
+   // with -p, records are built in parallel and tested as they arrive
+   if (argc > 1 && string(argv[1]) == "-p") {
+      return runPipeline("data2.txt");
+   }
 
-int main() {
    // create file object infile and open it
    // for testing, call your data file something appropriate, e.g., data2.txt
-   ifstream infile("data2.txt");
-   if (!infile) {
+   // the loader reads the file in large chunks rather than through >>
+   TreeLoader infile("data2.txt");
+   if (!infile.isOpen()) {
       cerr << "File could not be opened." << endl;
       return 1;
    }
 
-   // the NodeData class must have a constructor that takes a string
-   NodeData notND("not");
-   NodeData andND("and");
-   NodeData sssND("sss");
-   NodeData eND("e");
-   NodeData mND("m");
-   NodeData tND("t");
-
-   BinTree T, T2, dup;
-   NodeData* ndArray[ARRAYSIZE];
-   initArray(ndArray);
+   BinTree T, dup;
    cout << "Initial data:" << endl << "  ";
    buildTree(T, infile);              // builds and displays initial data
    cout << endl;
    BinTree first(T);                  // test copy constructor
    dup = dup = T;                     // test operator=, self-assignment
-   while(!infile.eof()) {
-      cout << "Tree Inorder:" << endl << T;             // operator<< does endl
-      T.displaySideways();
-
-      // test retrieve
-      NodeData* p;                    // pointer of retrieved object
-      bool found;                     // whether or not object was found in tree
-      found = T.retrieve(andND, p);
-      cout << "Retrieve --> and:  " << (found ? "found":"not found") << endl;
-      found = T.retrieve(notND, p);
-      cout << "Retrieve --> not:  " << (found ? "found":"not found") << endl;
-      found = T.retrieve(sssND, p);
-      cout << "Retrieve --> sss:  " << (found ? "found":"not found") << endl;
-
-      // test getDepth
-      cout << "Depth    --> and:  " << T.getDepth(andND) << endl;
-      cout << "Depth    --> not:  " << T.getDepth(notND) << endl;
-      cout << "Depth    --> sss:  " << T.getDepth(sssND) << endl;
-
-      // test ==, and !=
-      T2 = T;
-      cout << "T == T2?     " << (T == T2 ? "equal" : "not equal") << endl;
-      cout << "T != first?  " << (T != first ? "not equal" : "equal") << endl;
-      cout << "T == dup?    " << (T == dup ? "equal" : "not equal") << endl;
-      dup = T;
-
-      // somewhat test bstreeToArray and arrayToBSTree
-      T.bstreeToArray(ndArray);
-      T.arrayToBSTree(ndArray);
-      T.displaySideways();
-
+   while(!infile.atEnd()) {
+      testTree(T, first, dup);
       T.makeEmpty();                  // empty out the tree
-      initArray(ndArray);             // empty out the array
 
       cout << "---------------------------------------------------------------"
            << endl;
@@ -89,6 +55,89 @@ int main() {
    return 0;
 }
 
+//------------------------------- testTree -----------------------------------
+// Displays a tree built from one record, and tests retrieve, getDepth, ==,
+// !=, and the array round trip on it. first is the tree of the first record
+// and dup the tree of the previous one, which becomes a copy of T.
+
+void testTree(BinTree& T, const BinTree& first, BinTree& dup) {
+   // the NodeData class must have a constructor that takes a string
+   NodeData notND("not");
+   NodeData andND("and");
+   NodeData sssND("sss");
+
+   BinTree T2;
+
+   cout << "Tree Inorder:" << endl << T;             // operator<< does endl
+   T.displaySideways();
+
+   // test retrieve
+   NodeData* p;                    // pointer of retrieved object
+   bool found;                     // whether or not object was found in tree
+   found = T.retrieve(andND, p);
+   cout << "Retrieve --> and:  " << (found ? "found":"not found") << endl;
+   found = T.retrieve(notND, p);
+   cout << "Retrieve --> not:  " << (found ? "found":"not found") << endl;
+   found = T.retrieve(sssND, p);
+   cout << "Retrieve --> sss:  " << (found ? "found":"not found") << endl;
+
+   // test getDepth
+   cout << "Depth    --> and:  " << T.getDepth(andND) << endl;
+   cout << "Depth    --> not:  " << T.getDepth(notND) << endl;
+   cout << "Depth    --> sss:  " << T.getDepth(sssND) << endl;
+
+   // test ==, and !=
+   T2 = T;
+   cout << "T == T2?     " << (T == T2 ? "equal" : "not equal") << endl;
+   cout << "T != first?  " << (T != first ? "not equal" : "equal") << endl;
+   cout << "T == dup?    " << (T == dup ? "equal" : "not equal") << endl;
+   dup = T;
+
+   // somewhat test bstreeToArray and arrayToBSTree
+   int count = T.size();           // array sized to fit the tree exactly
+   NodeData** ndArray = new NodeData*[count];
+   count = T.bstreeToArray(ndArray, count);
+   T.arrayToBSTree(ndArray, count);
+   T.displaySideways();
+   delete [] ndArray;              // elements are NULL; tree owns data
+}
+
+//------------------------------- runPipeline --------------------------------
+// Produces the same output as main, but the trees of all records are built
+// on the shared TaskPool while earlier ones are being tested. Records are
+// consumed in file order, so first and dup see the same trees they would.
+
+int runPipeline(const char* fileName) {
+   Pipeline records(fileName);
+   if (!records.isOpen()) {
+      cerr << "File could not be opened." << endl;
+      return 1;
+   }
+
+   BinTree first, dup;
+   records.run([&](BinTree& T, const Pipeline::Record& record) {
+      if (record.index > 0) {
+         cout << "---------------------------------------------------------------"
+              << endl;
+      }
+      cout << "Initial data:" << endl << "  ";
+      for (size_t i = 0; i < record.tokens.size(); ++i) {
+         cout << record.tokens[i] << ' ';
+      }
+      cout << (record.ended ? "$$ " : " ") << endl;
+
+      if (record.index == 0) {
+         first = T;
+         dup = dup = T;
+      }
+      if (!record.last) {
+         testTree(T, first, dup);
+      }
+   });
+
+   return 0;
+}
+
 //------------------------------- buildTree ----------------------------------
 // you comment
 
@@ -97,27 +146,10 @@ int main() {
 // specific to the client problem, it's best that building a tree is not a
 // member function. It's a global function.
 
-void buildTree(BinTree& T, ifstream& infile) {
-   string s;
-
-   for (;;) {
-      infile >> s;
-      cout << s << ' ';
-      if (s == "$$") break;                // at end of one line
-      if (infile.eof()) break;             // no more lines of data
-      NodeData* ptr = new NodeData(s);     // NodeData constructor takes string
-      // would do a setData if there were more than a string
-
-      bool success = T.insert(ptr);
-      if (!success)
-         delete ptr;                       // duplicate case, not inserted
-   }
-}
-
-//------------------------------- initArray ----------------------------------
-// initialize the array of NodeData* to NULL pointers
+void buildTree(BinTree& T, TreeLoader& infile) {
+   // each token is echoed with a space after it, and a NodeData is made
+   // straight from the loader's buffer, so no string is built first
+   // would do a setData if there were more than a string
 
-void initArray(NodeData* ndArray[]) {
-   for(int i = 0; i < ARRAYSIZE; i++)
-      ndArray[i] = NULL;
+   infile.loadRecord(T, TreeLoader::INSERT, &cout);   // duplicates dropped
 }
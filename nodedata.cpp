@@ -1,13 +1,23 @@
 #include "nodedata.h"
+#include <functional>
+#include <utility>
 
 //------------------- constructors/destructor  -------------------------------
-NodeData::NodeData() { data = ""; }                         // default
+NodeData::NodeData() : data() { }                           // default
 
 NodeData::~NodeData() { }            // needed so strings are deleted properly
 
-NodeData::NodeData(const NodeData& nd) { data = nd.data; }  // copy
+NodeData::NodeData(const NodeData& nd) : data(nd.data) { }  // copy
 
-NodeData::NodeData(const string& s) { data = s; }    // cast string to NodeData
+NodeData::NodeData(NodeData&& nd) noexcept : data(std::move(nd.data)) { }
+
+NodeData::NodeData(const string& s) : data(s) { }    // cast string to NodeData
+
+NodeData::NodeData(string&& s) : data(std::move(s)) { }     // no copy made
+
+NodeData::NodeData(string_view s) : data(s) { }
+
+NodeData::NodeData(const char* s) : data(s) { }
 
 //------------------------- operator= ----------------------------------------
 NodeData& NodeData::operator=(const NodeData& rhs) {
@@ -17,6 +27,44 @@ NodeData& NodeData::operator=(const NodeData& rhs) {
    return *this;
 }
 
+NodeData& NodeData::operator=(NodeData&& rhs) noexcept {
+   if (this != &rhs) {
+      data = std::move(rhs.data);
+   }
+   return *this;
+}
+
+//------------------------------ compare -------------------------------------
+// one string comparison answers both == and <
+
+int NodeData::compare(const NodeData& rhs) const {
+   return data.compare(rhs.data);
+}
+
+//------------------------------- hash ---------------------------------------
+size_t NodeData::hash() const {
+   return std::hash<string>()(data);
+}
+
+//------------------------------- view ---------------------------------------
+string_view NodeData::view() const {
+   return data;
+}
+
+//------------------------------ prefix --------------------------------------
+// bytes are taken as unsigned, as string::compare orders them
+
+uint64_t NodeData::prefix() const {
+   uint64_t key = 0;
+   for (size_t i = 0; i < 8; i++) {
+      key <<= 8;
+      if (i < data.size()) {
+         key |= static_cast<unsigned char>(data[i]);
+      }
+   }
+   return key;
+}
+
 //------------------------- operator==,!= ------------------------------------
 bool NodeData::operator==(const NodeData& rhs) const {
    return data == rhs.data;
@@ -1,6 +1,8 @@
 #ifndef NODEDATA_H
 #define NODEDATA_H
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <iostream>
 #include <fstream>
 using namespace std;
@@ -15,13 +17,31 @@ public:
    NodeData();          // default constructor, data is set to an empty string
    ~NodeData();
    NodeData(const string &);      // data is set equal to parameter
+   NodeData(string &&);           // data takes over the parameter's buffer
+   NodeData(string_view);         // data is set equal to parameter
+   NodeData(const char *);        // data is set equal to parameter
    NodeData(const NodeData &);    // copy constructor
+   NodeData(NodeData &&) noexcept;   // move constructor, leaves source empty
    NodeData& operator=(const NodeData &);
+   NodeData& operator=(NodeData &&) noexcept;
 
    // set class data from data file
    // returns true if the data is set, false when bad data, i.e., is eof
    bool setData(istream&);
 
+   // three-way comparison: <0 if less than, 0 if equal, >0 if greater than
+   int compare(const NodeData &) const;
+
+   // hash of the data; equal objects have equal hashes
+   size_t hash() const;
+
+   // characters of the data, valid until this object is changed
+   string_view view() const;
+
+   // first 8 bytes of the data as a big-endian integer, zero padded, so
+   // prefixes that differ are ordered as compare() orders their objects
+   uint64_t prefix() const;
+
    bool operator==(const NodeData &) const;
    bool operator!=(const NodeData &) const;
    bool operator<(const NodeData &) const;
@@ -0,0 +1,149 @@
+/*
+ * @file    nodepool.cpp
+ * @brief   This class is a slab allocator for objects of one fixed size. Slots
+ *          are carved in order from large blocks, and released slots are kept
+ *          on a free list for reuse, so most allocations never reach the
+ *          system allocator. All blocks may be released at once, regardless of
+ *          how many slots were handed out. The pool does not construct or
+ *          destroy the objects placed in its slots.
+ * @author  Brendan Sweeney, SID 1161836
+ * @date    October 14, 2026
+ */
+
+#include <new>              // for operator new and bad_alloc
+
+#include "nodepool.h"
+
+using namespace std;
+
+// every slot is padded to this many bytes, which is at least the alignment of
+// any fundamental type
+static const size_t SLOT_ALIGN = 16;
+
+// the first slot of each block starts on a cache line, so slots whose size is
+// a multiple of this never straddle two lines
+static const size_t CACHE_LINE = 64;
+
+
+/**---------------------- Constructor -----------------------------------------
+ * Creates an empty pool that hands out slots of at least slotSize bytes.
+ * @param slotSize  The size of the objects to be stored in this pool.
+ * @param slotsPerBlock  The number of slots to carve from each block.
+ * @pre slotSize and slotsPerBlock are greater than 0.
+ * @post An empty pool exists; no memory has been allocated.
+ */
+NodePool::NodePool(size_t slotSize, size_t slotsPerBlock)
+    : blocks(NULL), freeList(NULL), cursor(NULL), limit(NULL),
+      slotSize((slotSize + SLOT_ALIGN - 1) / SLOT_ALIGN * SLOT_ALIGN),
+      slotsPerBlock(slotsPerBlock), blockTotal(0)
+{
+} // end constructor
+
+/**---------------------- Destructor ------------------------------------------
+ * Releases every block held by this pool.
+ * @pre No slot from this pool is still in use.
+ * @post All memory allocated by this pool is returned to the system.
+ */
+NodePool::~NodePool()
+{
+    clear();
+} // end destructor
+
+/**---------------------- allocate() ------------------------------------------
+ * Hands out one uninitialized slot, reusing a released slot if one exists.
+ * @pre None.
+ * @post A new block may have been allocated.
+ * @return A pointer to a slot of at least the size given at construction,
+ *         suitably aligned for any object; slots of 64 bytes are aligned on
+ *         cache lines.
+ * @throw bad_alloc if a new block is needed and could not be allocated.
+ */
+void *NodePool::allocate(void)
+{
+    void *slot;
+
+    if (freeList != NULL)       // reuse the most recently released slot
+    {
+        slot = freeList;
+        freeList = freeList->next;
+    }
+    else
+    {
+        if (cursor == limit)    // newest block is used up
+        {
+            grow();
+        } // end if (cursor == limit)
+
+        slot = cursor;
+        cursor += slotSize;
+    } // end if (freeList != NULL)
+
+    return slot;
+} // end allocate()
+
+/**---------------------- release() -------------------------------------------
+ * Returns one slot to this pool for reuse.
+ * @param slot  A slot obtained from allocate(), whose object was destroyed.
+ * @pre slot came from this pool and has not been released since.
+ * @post slot will be handed out again by a later allocate().
+ */
+void NodePool::release(void *slot)
+{
+    FreeSlot *freed = static_cast<FreeSlot*>(slot);
+
+    freed->next = freeList;
+    freeList = freed;
+} // end release(void*)
+
+/**---------------------- clear() ---------------------------------------------
+ * Releases every block held by this pool at once, in O(blocks).
+ * @pre No slot from this pool is still in use.
+ * @post This pool is empty; all of its memory is returned to the system.
+ */
+void NodePool::clear(void)
+{
+    while (blocks != NULL)
+    {
+        Block *next = blocks->next;
+
+        ::operator delete(blocks);
+        blocks = next;
+    } // end while (blocks != NULL)
+
+    freeList = NULL;
+    cursor = limit = NULL;
+    blockTotal = 0;
+} // end clear()
+
+/**---------------------- blockCount() ----------------------------------------
+ * Determines how many blocks this pool currently holds.
+ * @pre None.
+ * @post This pool remains unchanged.
+ * @return The number of blocks allocated since the last clear().
+ */
+size_t NodePool::blockCount(void) const
+{
+    return blockTotal;
+} // end blockCount()
+
+/**---------------------- grow() ----------------------------------------------
+ * Allocates a new block and makes its slots available to allocate().
+ * @pre None.
+ * @post cursor points to the first slot of a new block.
+ * @throw bad_alloc if the block could not be allocated.
+ */
+void NodePool::grow(void)
+{
+    // room for the header, then padding up to the next cache line
+    char  *raw = static_cast<char*>(
+                     ::operator new(CACHE_LINE + slotSize * slotsPerBlock));
+    Block *block = reinterpret_cast<Block*>(raw);
+    size_t first = reinterpret_cast<size_t>(raw + sizeof(Block));
+
+    first = (first + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+    block->next = blocks;
+    blocks = block;
+    cursor = reinterpret_cast<char*>(first);
+    limit = cursor + slotSize * slotsPerBlock;
+    ++blockTotal;
+} // end grow()
@@ -0,0 +1,108 @@
+/*
+ * @file    nodepool.h
+ * @brief   This class is a slab allocator for objects of one fixed size. Slots
+ *          are carved in order from large blocks, and released slots are kept
+ *          on a free list for reuse, so most allocations never reach the
+ *          system allocator. All blocks may be released at once, regardless of
+ *          how many slots were handed out. The pool does not construct or
+ *          destroy the objects placed in its slots.
+ * @author  Brendan Sweeney, SID 1161836
+ * @date    October 14, 2026
+ */
+
+#ifndef _NODEPOOL_H
+#define	_NODEPOOL_H
+
+#include <cstddef>          // definition of size_t
+
+
+class NodePool
+{
+public:
+
+/**---------------------- Constructor -----------------------------------------
+ * Creates an empty pool that hands out slots of at least slotSize bytes.
+ * @param slotSize  The size of the objects to be stored in this pool.
+ * @param slotsPerBlock  The number of slots to carve from each block.
+ * @pre slotSize and slotsPerBlock are greater than 0.
+ * @post An empty pool exists; no memory has been allocated.
+ */
+    NodePool(size_t slotSize, size_t slotsPerBlock = 1024);
+
+/**---------------------- Destructor ------------------------------------------
+ * Releases every block held by this pool.
+ * @pre No slot from this pool is still in use.
+ * @post All memory allocated by this pool is returned to the system.
+ */
+    ~NodePool();
+
+/**---------------------- allocate() ------------------------------------------
+ * Hands out one uninitialized slot, reusing a released slot if one exists.
+ * @pre None.
+ * @post A new block may have been allocated.
+ * @return A pointer to a slot of at least the size given at construction,
+ *         suitably aligned for any object; slots of 64 bytes are aligned on
+ *         cache lines.
+ * @throw bad_alloc if a new block is needed and could not be allocated.
+ */
+    void *allocate(void);
+
+/**---------------------- release() -------------------------------------------
+ * Returns one slot to this pool for reuse.
+ * @param slot  A slot obtained from allocate(), whose object was destroyed.
+ * @pre slot came from this pool and has not been released since.
+ * @post slot will be handed out again by a later allocate().
+ */
+    void release(void *slot);
+
+/**---------------------- clear() ---------------------------------------------
+ * Releases every block held by this pool at once, in O(blocks).
+ * @pre No slot from this pool is still in use.
+ * @post This pool is empty; all of its memory is returned to the system.
+ */
+    void clear(void);
+
+/**---------------------- blockCount() ----------------------------------------
+ * Determines how many blocks this pool currently holds.
+ * @pre None.
+ * @post This pool remains unchanged.
+ * @return The number of blocks allocated since the last clear().
+ */
+    size_t blockCount(void) const;
+
+private:
+
+    struct Block
+    {
+        Block *next;        // Pointer to the previously allocated block
+    }; // end Block
+
+    struct FreeSlot
+    {
+        FreeSlot *next;     // Pointer to the next released slot
+    }; // end FreeSlot
+
+    Block    *blocks;       // Most recently allocated block
+    FreeSlot *freeList;     // Released slots, most recent first
+    char     *cursor;       // Next unused slot in the newest block
+    char     *limit;        // End of the newest block
+    size_t    slotSize;     // Size of each slot, rounded for alignment
+    size_t    slotsPerBlock;    // Number of slots carved from each block
+    size_t    blockTotal;   // Number of blocks currently held
+
+    // pools own raw memory and are not copied
+    NodePool(const NodePool&);
+    NodePool& operator=(const NodePool&);
+
+/**---------------------- grow() ----------------------------------------------
+ * Allocates a new block and makes its slots available to allocate().
+ * @pre None.
+ * @post cursor points to the first slot of a new block.
+ * @throw bad_alloc if the block could not be allocated.
+ */
+    void grow(void);
+
+}; // end NodePool
+
+
+#endif	/* _NODEPOOL_H */
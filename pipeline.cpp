@@ -0,0 +1,289 @@
+/*
+ * @file    pipeline.cpp
+ * @brief   This class loads a file of "$$" terminated records into one
+ *          BinTree per record, with the stages of the work overlapped. A
+ *          splitter thread reads the tokens of each record with a
+ *          TreeLoader, the threads of the shared TaskPool build the trees,
+ *          and the calling thread consumes them. Records pass between the
+ *          stages through a fixed ring of slots, so a fast stage waits for a
+ *          slow one rather than filling memory, and each tree is consumed in
+ *          the order of its record in the file, however the builds finish.
+ * @author  Brendan Sweeney, SID 1161836
+ * @date    October 14, 2026
+ */
+
+#include <iostream>         // for cerr
+#include <new>              // for bad_alloc
+#include <thread>           // for thread
+
+#include "pipeline.h"
+
+using namespace std;
+
+
+/**---------------------- Constructor -----------------------------------------
+ * Opens a file from which to load trees. Nothing is read until run().
+ * @param fileName  The name of the file to be read.
+ * @param options  The Option flags with which each tree is constructed.
+ * @param mode  Whether to insert each token or build each tree from them.
+ * @param window  The number of records that may be in the pipeline at
+ *        once; 0 for four per worker of the shared TaskPool.
+ * @pre window is not negative.
+ * @post If the file could be opened, the pipeline is ready to run;
+ *       otherwise, isOpen() is false.
+ */
+Pipeline::Pipeline(const char *fileName, int options, TreeLoader::Mode mode,
+                   int window)
+    : loader(fileName), buildMode(mode)
+{
+    if (window == 0)
+    {
+        window = 4 * TaskPool::shared().workerCount();
+    } // end if (window == 0)
+
+    for (int i = 0; i < window; ++i)
+    {
+        slots.push_back(new Slot(options));
+    } // end for (int i = 0)
+} // end constructor(const char*, int, TreeLoader::Mode, int)
+
+/**---------------------- Destructor ------------------------------------------
+ * Deallocates the slots of a pipeline before it is released.
+ * @pre run() is not running.
+ * @post The file is closed and every tree is freed.
+ */
+Pipeline::~Pipeline()
+{
+    for (size_t i = 0; i < slots.size(); ++i)
+    {
+        delete slots[i];
+    } // end for (size_t i = 0)
+} // end destructor
+
+/**---------------------- isOpen() --------------------------------------------
+ * Determines whether the file of a pipeline could be opened.
+ * @pre None.
+ * @post This pipeline remains unchanged.
+ * @return true if the file was opened; false, otherwise.
+ */
+bool Pipeline::isOpen(void) const
+{
+    return loader.isOpen();
+} // end isOpen()
+
+/**---------------------- run() -----------------------------------------------
+ * Loads every record of the file into a tree and passes each tree, with its
+ * record, to consume, on the calling thread and in file order. As with
+ * TreeLoader::loadRecord(), the whitespace after the last "$$" makes one more,
+ * empty record, which ends the file. A tree may be changed by consume; it is
+ * emptied by the builder that next uses its slot, or by the destructor.
+ * @param consume  The function to be called on each tree.
+ * @pre The file has not already been run.
+ * @post Every record has been consumed, and the file has been read.
+ * @return The number of records consumed.
+ */
+int Pipeline::run(const Consumer& consume)
+{
+    int             next = 0;       // Index of the next record to consume
+    int             total = -1;     // Records read; -1 until the file ends
+    bool            more = isOpen();
+    TaskPool::Group group;
+    thread          splitter;
+
+    if (more)
+    {
+        splitter = thread(&Pipeline::split, this, ref(group), ref(total));
+    } // end if (more)
+
+    while (more)
+    {
+        Slot& slot = *slots[next % slots.size()];
+
+        {
+            unique_lock<mutex> guard(lock);
+
+            built.wait(guard, [&] {
+                return slot.state == BUILT || (total >= 0 && next >= total);
+            });
+            more = (slot.state == BUILT);
+        }
+
+        if (more)
+        {
+            consume(slot.tree, slot.record);
+            slot.record.tokens.clear();
+            slot.chars.clear();
+            slot.ends.clear();
+            ++next;
+
+            {
+                lock_guard<mutex> guard(lock);
+
+                slot.state = FREE;
+            }
+
+            freed.notify_one();
+        } // end if (more)
+    } // end while (more)
+
+    if (splitter.joinable())
+    {
+        splitter.join();
+    } // end if (splitter.joinable())
+
+    TaskPool::shared().wait(group);     // last builds may still be signalling
+    return next;
+} // end run(const Consumer&)
+
+/**---------------------- split() ---------------------------------------------
+ * Reads records into the slots of the ring, in turn, and spawns a build for
+ * each into group, until the file ends.
+ * @param group  The group to which builds are spawned.
+ * @param total  A container for the number of records read.
+ * @pre Each slot is FREE or will be freed by the consumer.
+ * @post Every record of the file has been read and its build spawned.
+ */
+void Pipeline::split(TaskPool::Group& group, int& total)
+{
+    int  index = 0;
+    bool more = true;
+
+    while (more)
+    {
+        Slot& slot = *slots[index % slots.size()];
+
+        {
+            unique_lock<mutex> guard(lock);
+
+            freed.wait(guard, [&] { return slot.state == FREE; });
+        }
+
+        slot.record.index = index;
+
+        try
+        {
+            splitRecord(slot);
+        } // end try
+        catch (bad_alloc e)
+        {
+            cerr << "Could not allocate memory for record: "
+                 << "split() failed." << endl;
+            slot.record.last = true;    // the file is cut short here
+        } // end catch (bad_alloc e)
+
+        more = !slot.record.last;
+        ++index;
+
+        {
+            lock_guard<mutex> guard(lock);
+
+            slot.state = SPLIT;
+        }
+
+        TaskPool::shared().spawn(group, [this, &slot] { build(slot); });
+    } // end while (more)
+
+    {
+        lock_guard<mutex> guard(lock);
+
+        total = index;
+    }
+
+    built.notify_one();
+} // end split(TaskPool::Group&, int&)
+
+/**---------------------- splitRecord() ---------------------------------------
+ * Reads the tokens of the next record into a slot.
+ * @param slot  The slot to hold the record.
+ * @pre The slot is owned by the splitter, and its record is empty.
+ * @post The slot holds the record's tokens, and the loader is after it.
+ * @throw bad_alloc if memory could not be allocated for the tokens.
+ */
+void Pipeline::splitRecord(Slot& slot)
+{
+    string_view token;
+    size_t      begin = 0;
+
+    slot.record.ended = false;
+
+    while (!slot.record.ended && loader.nextToken(token))
+    {
+        if (token == "$$")
+        {
+            slot.record.ended = true;
+        } // end if (token == "$$")
+        else
+        {
+            slot.chars.append(token);
+            slot.ends.push_back(slot.chars.size());
+        } // end else
+    } // end while (!slot.record.ended && loader.nextToken(token))
+
+    slot.record.last = loader.atEnd();
+
+    // chars is complete, so views of it stay valid
+    slot.record.tokens.reserve(slot.ends.size());
+
+    for (size_t i = 0; i < slot.ends.size(); ++i)
+    {
+        slot.record.tokens.push_back(
+            string_view(slot.chars).substr(begin, slot.ends[i] - begin));
+        begin = slot.ends[i];
+    } // end for (size_t i = 0)
+} // end splitRecord(Slot&)
+
+/**---------------------- build() ---------------------------------------------
+ * Builds the tree of a slot from its tokens, then hands it to the consumer.
+ * @param slot  The slot whose tree is to be built.
+ * @pre The slot is SPLIT.
+ * @post The slot is BUILT, and its tree holds only the distinct tokens.
+ */
+void Pipeline::build(Slot& slot)
+{
+    const vector<string_view>& tokens = slot.record.tokens;
+    vector<NodeData*>          items;   // tokens collected in BUILD mode
+
+    // the last record's tree is freed here, in parallel, rather than by the
+    // consumer, which is the one stage that runs in order
+    slot.tree.makeEmpty();
+
+    try
+    {
+        if (buildMode == TreeLoader::BUILD)
+        {
+            items.reserve(tokens.size());
+
+            for (size_t i = 0; i < tokens.size(); ++i)
+            {
+                items.push_back(new NodeData(tokens[i]));
+            } // end for (size_t i = 0)
+
+            slot.tree.build(items.data(), static_cast<int>(items.size()));
+        } // end if (buildMode == TreeLoader::BUILD)
+        else
+        {
+            for (size_t i = 0; i < tokens.size(); ++i)
+            {
+                slot.tree.insert(NodeData(tokens[i]));
+            } // end for (size_t i = 0)
+        } // end else
+    } // end try
+    catch (bad_alloc e)
+    {
+        for (size_t i = 0; i < items.size(); ++i)
+        {
+            delete items[i];
+        } // end for (size_t i = 0)
+
+        cerr << "Could not allocate memory for tree: "
+             << "build() failed." << endl;
+    } // end catch (bad_alloc e)
+
+    {
+        lock_guard<mutex> guard(lock);
+
+        slot.state = BUILT;
+    }
+
+    built.notify_one();
+} // end build(Slot&)
@@ -0,0 +1,154 @@
+/*
+ * @file    pipeline.h
+ * @brief   This class loads a file of "$$" terminated records into one
+ *          BinTree per record, with the stages of the work overlapped. A
+ *          splitter thread reads the tokens of each record with a
+ *          TreeLoader, the threads of the shared TaskPool build the trees,
+ *          and the calling thread consumes them. Records pass between the
+ *          stages through a fixed ring of slots, so a fast stage waits for a
+ *          slow one rather than filling memory, and each tree is consumed in
+ *          the order of its record in the file, however the builds finish.
+ * @author  Brendan Sweeney, SID 1161836
+ * @date    October 14, 2026
+ */
+
+#ifndef _PIPELINE_H
+#define	_PIPELINE_H
+
+#include <condition_variable>   // stages wait on these
+#include <functional>           // for function
+#include <mutex>                // for mutex
+#include <string>               // characters of a record
+#include <string_view>          // tokens of a record
+#include <vector>               // tokens and slots
+
+#include "bintree.h"
+#include "taskpool.h"
+#include "treeloader.h"
+
+
+class Pipeline
+{
+public:
+
+    // a record of the file, as it is handed to the consumer
+    struct Record
+    {
+        int                 index;  // Position in the file, from 0
+        vector<string_view> tokens; // Tokens before the "$$", as read
+        bool                ended;  // Whether "$$" ended it, not end of file
+        bool                last;   // Whether the file ends after it
+    }; // end Record
+
+    // called on each built tree in file order; it must not throw
+    typedef std::function<void(BinTree& tree, const Record& record)> Consumer;
+
+/**---------------------- Constructor -----------------------------------------
+ * Opens a file from which to load trees. Nothing is read until run().
+ * @param fileName  The name of the file to be read.
+ * @param options  The Option flags with which each tree is constructed.
+ * @param mode  Whether to insert each token or build each tree from them.
+ * @param window  The number of records that may be in the pipeline at
+ *        once; 0 for four per worker of the shared TaskPool.
+ * @pre window is not negative.
+ * @post If the file could be opened, the pipeline is ready to run;
+ *       otherwise, isOpen() is false.
+ */
+    explicit Pipeline(const char *fileName, int options = BinTree::PLAIN,
+                      TreeLoader::Mode mode = TreeLoader::INSERT,
+                      int window = 0);
+
+/**---------------------- Destructor ------------------------------------------
+ * Deallocates the slots of a pipeline before it is released.
+ * @pre run() is not running.
+ * @post The file is closed and every tree is freed.
+ */
+    ~Pipeline();
+
+/**---------------------- isOpen() --------------------------------------------
+ * Determines whether the file of a pipeline could be opened.
+ * @pre None.
+ * @post This pipeline remains unchanged.
+ * @return true if the file was opened; false, otherwise.
+ */
+    bool isOpen(void) const;
+
+/**---------------------- run() -----------------------------------------------
+ * Loads every record of the file into a tree and passes each tree, with its
+ * record, to consume, on the calling thread and in file order. As with
+ * TreeLoader::loadRecord(), the whitespace after the last "$$" makes one more,
+ * empty record, which ends the file. A tree may be changed by consume; it is
+ * emptied by the builder that next uses its slot, or by the destructor.
+ * @param consume  The function to be called on each tree.
+ * @pre The file has not already been run.
+ * @post Every record has been consumed, and the file has been read.
+ * @return The number of records consumed.
+ */
+    int run(const Consumer& consume);
+
+private:
+
+    // where a slot is in the pipeline
+    enum State
+    {
+        FREE,               // waiting for the splitter
+        SPLIT,              // holding tokens, waiting for a builder
+        BUILT               // holding a tree, waiting for the consumer
+    }; // end State
+
+    // one record on its way through the pipeline
+    struct Slot
+    {
+        Record         record;  // The record, viewing chars
+        string         chars;   // Characters of the tokens, end to end
+        vector<size_t> ends;    // Index in chars after each token
+        BinTree        tree;    // The tree built from the tokens
+        State          state;   // Which stage owns the slot
+
+        explicit Slot(int options) : tree(options), state(FREE)
+        {
+        } // end constructor
+    }; // end Slot
+
+    TreeLoader              loader;     // Tokenizer for the file
+    TreeLoader::Mode        buildMode;  // How tokens are put in each tree
+    vector<Slot*>           slots;      // Ring buffer of records
+    std::mutex              lock;       // Guards the state of each slot
+    std::condition_variable built;      // Signalled when a slot is BUILT
+    std::condition_variable freed;      // Signalled when a slot is FREE
+
+    // a pipeline owns its file and slots
+    Pipeline(const Pipeline&);
+    Pipeline& operator=(const Pipeline&);
+
+/**---------------------- split() ---------------------------------------------
+ * Reads records into the slots of the ring, in turn, and spawns a build for
+ * each into group, until the file ends.
+ * @param group  The group to which builds are spawned.
+ * @param total  A container for the number of records read.
+ * @pre Each slot is FREE or will be freed by the consumer.
+ * @post Every record of the file has been read and its build spawned.
+ */
+    void split(TaskPool::Group& group, int& total);
+
+/**---------------------- splitRecord() ---------------------------------------
+ * Reads the tokens of the next record into a slot.
+ * @param slot  The slot to hold the record.
+ * @pre The slot is owned by the splitter, and its record is empty.
+ * @post The slot holds the record's tokens, and the loader is after it.
+ * @throw bad_alloc if memory could not be allocated for the tokens.
+ */
+    void splitRecord(Slot& slot);
+
+/**---------------------- build() ---------------------------------------------
+ * Builds the tree of a slot from its tokens, then hands it to the consumer.
+ * @param slot  The slot whose tree is to be built.
+ * @pre The slot is SPLIT.
+ * @post The slot is BUILT, and its tree holds only the distinct tokens.
+ */
+    void build(Slot& slot);
+
+}; // end Pipeline
+
+
+#endif	/* _PIPELINE_H */
@@ -0,0 +1,646 @@
+/*
+ * @file    radixtree.cpp
+ * @brief   This class represents a radix tree (compressed trie) of NodeData
+ *          strings, offering the interface of BinTree for inserting,
+ *          retrieving, writing, and comparing trees. Each edge is labelled
+ *          with a run of characters, so a prefix shared by many items is
+ *          stored once, on the edge above all of them, and a search costs
+ *          one step per edge of the key rather than a string comparison per
+ *          level. Since no item is stored whole, retrieve() hands out a copy,
+ *          and an inserted NodeData* is deleted once its characters are in
+ *          the tree, as in an INLINE BinTree.
+ * @author  Brendan Sweeney, SID 1161836
+ * @date    October 14, 2026
+ */
+
+#include <cstddef>          // definition of NULL
+#include <new>              // for bad_alloc
+#include <utility>          // for pair
+#include <vector>           // explicit stacks for traversals
+
+#include "radixtree.h"
+
+using namespace std;
+
+
+/**---------------------- Default Constructor ---------------------------------
+ * Creates an empty tree.
+ * @pre None.
+ * @post An empty radix tree exists.
+ */
+RadixTree::RadixTree() : root(NULL), nodeCount(0)
+{
+} // end default constructor
+
+/**---------------------- Copy Constructor ------------------------------------
+ * Copies the tree orig into a new tree, node by node.
+ * @param orig  The tree to be copied.
+ * @pre There is sufficient memory to allocate a copy of orig.
+ * @post A radix tree exists that holds the same items as orig; orig remains
+ *       unchanged.
+ */
+RadixTree::RadixTree(const RadixTree& orig) : root(NULL), nodeCount(0)
+{
+    try
+    {
+        copyTree(orig.root, root);
+        nodeCount = orig.nodeCount;
+    }
+    catch (bad_alloc e)
+    {
+        cerr << "Could not allocate memory: copyTree() failed.";
+        destroyTree(root);      // a partial copy holds the wrong items
+    } // end try
+} // end copy constructor
+
+/**---------------------- Destructor ------------------------------------------
+ * Deallocates memory for a tree before it is released.
+ * @pre None.
+ * @post This tree is empty before it is released.
+ */
+RadixTree::~RadixTree()
+{
+    makeEmpty();
+} // end destructor
+
+/**---------------------- isEmpty() -------------------------------------------
+ * Determines whether a radix tree is empty.
+ * @pre None.
+ * @post This tree remains unchanged.
+ * @return true if the tree is empty; false, otherwise.
+ */
+bool RadixTree::isEmpty(void) const
+{
+    return (nodeCount == 0);
+} // end isEmpty()
+
+/**---------------------- makeEmpty() -----------------------------------------
+ * Deallocates memory for a tree.
+ * @pre None.
+ * @post This tree is now empty.
+ */
+void RadixTree::makeEmpty(void)
+{
+    destroyTree(root);
+    nodeCount = 0;
+} // end makeEmpty()
+
+/**---------------------- = Assignment Operator -------------------------------
+ * Copies the contents of rhs into this tree. Any contents of this tree are
+ * removed beforehand.
+ * @param rhs  The right-hand tree to be copied.
+ * @pre There is sufficient memory to allocate a copy of rhs.
+ * @post This tree holds the same items as rhs; rhs remains unchanged.
+ * @return This radix tree, which is equivalent to rhs.
+ */
+RadixTree& RadixTree::operator=(const RadixTree& rhs)
+{
+    if (this != &rhs)
+    {
+        makeEmpty();                // deallocate left-hand side
+
+        try
+        {
+            copyTree(rhs.root, root);
+            nodeCount = rhs.nodeCount;
+        }
+        catch (bad_alloc e)
+        {
+            cerr << "Could not allocate memory: copyTree() failed.";
+            destroyTree(root);      // a partial copy holds the wrong items
+        } // end try
+    } // end if (this != &rhs)
+
+    return *this;
+} // end operator=(RadixTree&)
+
+/**---------------------- copyTree() ------------------------------------------
+ * Copies the tree rooted at treePtr into a tree rooted at newTreePtr. Each
+ * stack entry pairs a node to be copied with the link that will point to its
+ * copy.
+ * @param treePtr  The root of the tree to be copied.
+ * @param newTreePtr  A container for the root of a copy of treePtr.
+ * @pre newTreePtr is NULL.
+ * @post newTreePtr points to the root of a copy of the tree rooted at treePtr.
+ * @throw bad_alloc if memory could not be allocated; newTreePtr then points
+ *        to the part copied so far, which destroyTree() can free.
+ */
+void RadixTree::copyTree(const Node *treePtr, Node *& newTreePtr)
+{
+    vector< pair<const Node*, Node**> > pending;
+
+    if (treePtr != NULL)
+    {
+        pending.push_back(make_pair(treePtr, &newTreePtr));
+    } // end if (treePtr != NULL)
+
+    while (!pending.empty())
+    {
+        const Node *orig = pending.back().first;
+        Node      **link = pending.back().second;
+
+        pending.pop_back();
+        *link = new Node(orig->label);
+        (*link)->terminal = orig->terminal;
+
+        // children stay NULL until copied, so a failure leaves them skipped
+        (*link)->children.assign(orig->children.size(), NULL);
+        (*link)->firsts = orig->firsts;
+
+        for (size_t i = orig->children.size(); i > 0; --i)
+        {
+            pending.push_back(make_pair(orig->children[i - 1],
+                                        &(*link)->children[i - 1]));
+        } // end for (size_t i = orig->children.size())
+    } // end while (!pending.empty())
+} // end copyTree(Node*, Node*&)
+
+/**---------------------- destroyTree() ---------------------------------------
+ * Deallocates memory for a tree, with the nodes still to be freed kept on an
+ * explicit stack.
+ * @param treePtr  Pointer to the root of the tree to be deallocated.
+ * @pre None.
+ * @post treePtr points to an empty tree.
+ */
+void RadixTree::destroyTree(Node *& treePtr)
+{
+    vector<Node*> pending;
+
+    if (treePtr != NULL)
+    {
+        pending.push_back(treePtr);
+    } // end if (treePtr != NULL)
+
+    while (!pending.empty())
+    {
+        Node *current = pending.back();
+
+        pending.pop_back();
+
+        for (size_t i = 0; i < current->children.size(); ++i)
+        {
+            if (current->children[i] != NULL)
+            {
+                pending.push_back(current->children[i]);
+            } // end if (current->children[i] != NULL)
+        } // end for (size_t i = 0)
+
+        delete current;
+    } // end while (!pending.empty())
+
+    treePtr = NULL;
+} // end destroyTree(Node*&)
+
+/**---------------------- == Equality Operator --------------------------------
+ * Compares this radix tree with another for equality. The shape of a radix
+ * tree depends only on its items, so trees are equal if and only if they
+ * hold the same items, and they are compared edge by edge.
+ * @param rhs  The right-hand tree to be compared.
+ * @pre None.
+ * @post Both radix trees remain unchanged.
+ * @return true if both trees hold the same items; false, otherwise.
+ */
+bool RadixTree::operator==(const RadixTree& rhs) const
+{
+    vector< pair<const Node*, const Node*> > pending;
+    bool same = (nodeCount == rhs.nodeCount);
+
+    // an empty tree may or may not have kept its root
+    if (same && nodeCount > 0)
+    {
+        pending.push_back(make_pair(root, rhs.root));
+    } // end if (same && nodeCount > 0)
+
+    while (same && !pending.empty())
+    {
+        const Node *lhsPtr = pending.back().first;
+        const Node *rhsPtr = pending.back().second;
+
+        pending.pop_back();
+        same = (lhsPtr->terminal == rhsPtr->terminal &&
+                lhsPtr->label == rhsPtr->label &&
+                lhsPtr->firsts == rhsPtr->firsts);
+
+        for (size_t i = 0; i < lhsPtr->children.size() && same; ++i)
+        {
+            pending.push_back(make_pair(lhsPtr->children[i],
+                                        rhsPtr->children[i]));
+        } // end for (size_t i = 0)
+    } // end while (same && !pending.empty())
+
+    return same;
+} // end operator==(RadixTree&)
+
+/**---------------------- != Inequality Operator ------------------------------
+ * Compares this radix tree with another for inequality.
+ * @param rhs  The right-hand tree to be compared.
+ * @pre None.
+ * @post Both radix trees remain unchanged.
+ * @return false if both trees hold the same items; true, otherwise.
+ */
+bool RadixTree::operator!=(const RadixTree& rhs) const
+{
+    return !(*this == rhs);
+} // end operator!=(RadixTree&)
+
+/**---------------------- << Stream Out Operator ------------------------------
+ * Writes the contents of a tree to the provided ostream, in sorted order,
+ * space separated on a single line.
+ * @param output  The ostream to which to write the tree's contents.
+ * @param source  The tree whose contents are to be written.
+ * @pre The ostream, output, is writable.
+ * @post The ostream, output, contains a string representing the contents of
+ *       the tree, in sorted order; the tree remains unchanged.
+ * @return A reference to the provided ostream, with the contents of the tree
+ *         appended to it.
+ */
+ostream& operator<<(ostream& output, const RadixTree& source)
+{
+    // each entry is a node and the number of its children already written
+    vector< pair<const RadixTree::Node*, size_t> > ancestors;
+    string spelled;                 // labels from the root to the top entry
+
+    if (source.root != NULL)
+    {
+        ancestors.push_back(make_pair(source.root, 0));
+        spelled = source.root->label;
+
+        if (source.root->terminal)
+        {
+            output << ' ' << NodeData(spelled);
+        } // end if (source.root->terminal)
+    } // end if (source.root != NULL)
+
+    // an item precedes every longer item below it, so preorder is sorted
+    while (!ancestors.empty())
+    {
+        const RadixTree::Node *treePtr = ancestors.back().first;
+        size_t                 next = ancestors.back().second;
+
+        if (next < treePtr->children.size())    // descend to the next child
+        {
+            const RadixTree::Node *child = treePtr->children[next];
+
+            ++ancestors.back().second;
+            ancestors.push_back(make_pair(child, 0));
+            spelled += child->label;
+
+            if (child->terminal)
+            {
+                output << ' ' << NodeData(spelled);
+            } // end if (child->terminal)
+        }
+        else                                    // every child written
+        {
+            spelled.resize(spelled.size() - treePtr->label.size());
+            ancestors.pop_back();
+        } // end if (next < treePtr->children.size())
+    } // end while (!ancestors.empty())
+
+    output << endl;
+
+    return output;
+} // end operator<<(ostream&, RadixTree&)
+
+/**---------------------- insert() --------------------------------------------
+ * Inserts an item into a radix tree, taking ownership of newItem if it is
+ * inserted. Its characters are then stored along the edges of the tree, and
+ * newItem is deleted.
+ * @param newItem  An object to be added to the tree.
+ * @pre NodeData provides the view() method.
+ * @post The value of newItem is in the tree.
+ * @return true if newItem could be inserted in the tree; false if newItem
+ *         already existed in the tree or memory could not be allocated.
+ */
+bool RadixTree::insert(NodeData *newItem)
+{
+    bool success = insertKey(newItem->view());
+
+    if (success)
+    {
+        delete newItem;         // characters were copied into the edges
+    } // end if (success)
+
+    return success;
+} // end insert(NodeData*)
+
+/**---------------------- insert() --------------------------------------------
+ * Inserts the value of an item into a radix tree. Only the characters beyond
+ * the longest prefix already in the tree are stored, so moving newItem gains
+ * nothing; it is accepted for compatibility with BinTree and left unchanged.
+ * @param newItem  An object whose value is to be added to the tree.
+ * @pre NodeData provides the view() method.
+ * @post The value of newItem is in the tree.
+ * @return true if newItem could be inserted in the tree; false if newItem
+ *         already existed in the tree or memory could not be allocated.
+ */
+bool RadixTree::insert(NodeData&& newItem)
+{
+    return insertKey(newItem.view());
+} // end insert(NodeData&&)
+
+/**---------------------- insert() --------------------------------------------
+ * Inserts the value of an item into a radix tree; the caller keeps ownership
+ * of newItem. A new edge is labelled with the characters beyond the longest
+ * prefix already in the tree, and an edge that diverges from newItem partway
+ * along is split in two.
+ * @param newItem  An object whose value is to be added to the tree.
+ * @pre NodeData provides the view() method.
+ * @post The value of newItem is in the tree.
+ * @return true if newItem could be inserted in the tree; false if newItem
+ *         already existed in the tree or memory could not be allocated.
+ */
+bool RadixTree::insert(const NodeData& newItem)
+{
+    return insertKey(newItem.view());
+} // end insert(NodeData&)
+
+/**---------------------- insertKey() -----------------------------------------
+ * Inserts a key into a radix tree. The search follows edges while they match
+ * the key, then every node the insert needs is allocated before the tree is
+ * changed, so a failure leaves the tree as it was.
+ * @param key  The characters of the item to be inserted.
+ * @pre None.
+ * @post key is spelled out by a path ending at a terminal node.
+ * @return true if the item is successfully inserted; false if the item already
+ *         exists in this tree or memory could not be allocated.
+ */
+bool RadixTree::insertKey(string_view key)
+{
+    Node  *treePtr;
+    Node  *child = NULL;        // child whose label diverges from key
+    Node  *middle = NULL;       // new node where child's label is split
+    Node  *leaf = NULL;         // new node ending key
+    size_t position = 0;        // characters of key matched so far
+    size_t common = 0;          // characters of child's label matched
+    size_t slot = 0;            // position of child among its siblings
+    bool   descending = true;
+    bool   success = true;
+
+    try
+    {
+        if (root == NULL)
+        {
+            root = new Node(string_view());
+        } // end if (root == NULL)
+    }
+    catch (bad_alloc e)
+    {
+        cerr << "Could not allocate memory for " << key
+             << ": insert() failed.";
+        success = false;
+    } // end try
+
+    treePtr = root;
+
+    // follow whole edges while they match the key
+    while (success && descending)
+    {
+        child = NULL;
+        common = 0;
+
+        if (position < key.size())
+        {
+            slot = childSlot(treePtr, key[position]);
+
+            if (slot < treePtr->firsts.size()
+                    && treePtr->firsts[slot] == key[position])
+            {
+                child = treePtr->children[slot];
+            } // end if (slot < treePtr->firsts.size() && ...)
+        } // end if (position < key.size())
+
+        if (child != NULL)
+        {
+            while (common < child->label.size()
+                       && position + common < key.size()
+                       && child->label[common] == key[position + common])
+            {
+                ++common;
+            } // end while (common < child->label.size() && ...)
+        } // end if (child != NULL)
+
+        if (child != NULL && common == child->label.size())
+        {
+            treePtr = child;
+            position += common;
+        }
+        else
+        {
+            descending = false;
+        } // end if (child != NULL && common == child->label.size())
+    } // end while (success && descending)
+
+    if (success && child == NULL && position == key.size())
+    {
+        success = !treePtr->terminal;       // duplicates are not allowed
+        treePtr->terminal = true;
+    }
+    else if (success)
+    {
+        // allocate everything before linking anything
+        try
+        {
+            if (child != NULL)
+            {
+                middle = new Node(key.substr(position, common));
+                middle->children.reserve(2);
+                middle->firsts.reserve(2);
+            }
+            else
+            {
+                treePtr->children.reserve(treePtr->children.size() + 1);
+                treePtr->firsts.reserve(treePtr->firsts.size() + 1);
+            } // end if (child != NULL)
+
+            if (position + common < key.size())
+            {
+                leaf = new Node(key.substr(position + common));
+                leaf->terminal = true;
+            } // end if (position + common < key.size())
+        }
+        catch (bad_alloc e)
+        {
+            cerr << "Could not allocate memory for " << key
+                 << ": insert() failed.";
+            delete middle;
+            success = false;
+        } // end try
+
+        if (success && middle != NULL)      // split child's edge at common
+        {
+            child->label.erase(0, common);
+            middle->children.push_back(child);
+            middle->firsts.push_back(child->label[0]);
+            middle->terminal = (leaf == NULL);
+            treePtr->children[slot] = middle;
+            treePtr = middle;
+        } // end if (success && middle != NULL)
+
+        if (success && leaf != NULL)
+        {
+            slot = childSlot(treePtr, leaf->label[0]);
+            treePtr->children.insert(treePtr->children.begin() + slot, leaf);
+            treePtr->firsts.insert(slot, 1, leaf->label[0]);
+        } // end if (success && leaf != NULL)
+    } // end if (success && child == NULL && ...)
+
+    if (success)
+    {
+        ++nodeCount;
+    } // end if (success)
+
+    return success;
+} // end insertKey(string_view)
+
+/**---------------------- childSlot() -----------------------------------------
+ * Determines where a child beginning with a character is, or would go, among
+ * the children of a node. Characters are ordered as unsigned, as
+ * string::compare orders them.
+ * @param treePtr  The node to search.
+ * @param first  The first character of the child's label.
+ * @pre treePtr is not NULL.
+ * @post The node remains unchanged.
+ * @return The number of children whose labels begin with a smaller
+ *         character.
+ */
+size_t RadixTree::childSlot(const Node *treePtr, char first)
+{
+    unsigned char target = static_cast<unsigned char>(first);
+    size_t        low = 0;
+    size_t        high = treePtr->firsts.size();
+
+    // binary search; at most 8 steps, since there are at most 256 children
+    while (low < high)
+    {
+        size_t middle = (low + high) / 2;
+
+        if (static_cast<unsigned char>(treePtr->firsts[middle]) < target)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        } // end if (static_cast<unsigned char>(...) < target)
+    } // end while (low < high)
+
+    return low;
+} // end childSlot(Node*, char)
+
+/**---------------------- retrieve() ------------------------------------------
+ * Retrieves a copy of a given item from a radix tree, in time proportional to
+ * the length of the item.
+ * @param searchItem  The item to be located.
+ * @param dataItem  A container for a copy of the found item.
+ * @pre NodeData provides the view() method.
+ * @post If the retrieval was successful, dataItem is equal to the retrieved
+ *       item; this tree remains unchanged.
+ * @return true if searchItem matches an item in the tree; false if searchItem
+ *         could not be found.
+ */
+bool RadixTree::retrieve(const NodeData& searchItem, NodeData& dataItem) const
+{
+    bool success = contains(searchItem);
+
+    if (success)
+    {
+        dataItem = searchItem;  // the item found spells searchItem exactly
+    } // end if (success)
+
+    return success;
+} // end retrieve(NodeData&, NodeData&)
+
+/**---------------------- contains() ------------------------------------------
+ * Determines whether an item is in a radix tree, without copying it.
+ * @param searchItem  The item to be located.
+ * @pre NodeData provides the view() method.
+ * @post This tree remains unchanged.
+ * @return true if searchItem matches an item in the tree; false, otherwise.
+ */
+bool RadixTree::contains(const NodeData& searchItem) const
+{
+    int level;
+    const Node *treePtr = locate(searchItem.view(), level);
+
+    return (treePtr != NULL && treePtr->terminal);
+} // end contains(NodeData&)
+
+/**---------------------- getDepth() ------------------------------------------
+ * Determines the depth of the node that ends an item in a radix tree: the
+ * number of edges followed to spell it, plus one for the root. The empty
+ * string ends at the root, which is at depth 1.
+ * @param searchItem  The item to locate in the tree.
+ * @pre NodeData provides the view() method.
+ * @post This tree remains unchanged.
+ * @return The depth of the node ending searchItem, if found; 0, otherwise.
+ */
+int RadixTree::getDepth(const NodeData& searchItem) const
+{
+    int level;
+    const Node *treePtr = locate(searchItem.view(), level);
+
+    if (treePtr == NULL || !treePtr->terminal)
+    {
+        level = 0;
+    } // end if (treePtr == NULL || !treePtr->terminal)
+
+    return level;
+} // end getDepth(NodeData&)
+
+/**---------------------- locate() --------------------------------------------
+ * Finds the node at which a key is spelled out.
+ * @param key  The characters to follow from the root.
+ * @param level  A container for the depth of that node, where the root is at
+ *        depth 1.
+ * @pre None.
+ * @post This tree remains unchanged.
+ * @return The node reached after the last character of key, whether or not
+ *         it is terminal; NULL if the tree has no such node.
+ */
+const RadixTree::Node *RadixTree::locate(string_view key, int& level) const
+{
+    const Node *treePtr = root;
+    size_t      position = 0;
+
+    level = 1;
+
+    // each step matches a whole edge label against the key
+    while (treePtr != NULL && position < key.size())
+    {
+        size_t      slot = childSlot(treePtr, key[position]);
+        const Node *child = NULL;
+
+        if (slot < treePtr->firsts.size()
+                && treePtr->firsts[slot] == key[position])
+        {
+            child = treePtr->children[slot];
+        } // end if (slot < treePtr->firsts.size() && ...)
+
+        if (child != NULL
+                && key.substr(position, child->label.size()) == child->label)
+        {
+            position += child->label.size();
+            ++level;
+        }
+        else
+        {
+            child = NULL;       // key leaves the tree partway along an edge
+        } // end if (child != NULL && ...)
+
+        treePtr = child;
+    } // end while (treePtr != NULL && position < key.size())
+
+    return treePtr;
+} // end locate(string_view, int&)
+
+/**---------------------- size() ----------------------------------------------
+ * Determines the number of items in a radix tree.
+ * @pre None.
+ * @post This tree remains unchanged.
+ * @return The number of items in this tree.
+ */
+int RadixTree::size(void) const
+{
+    return nodeCount;
+} // end size()
@@ -0,0 +1,268 @@
+/*
+ * @file    radixtree.h
+ * @brief   This class represents a radix tree (compressed trie) of NodeData
+ *          strings, offering the interface of BinTree for inserting,
+ *          retrieving, writing, and comparing trees. Each edge is labelled
+ *          with a run of characters, so a prefix shared by many items is
+ *          stored once, on the edge above all of them, and a search costs
+ *          one step per edge of the key rather than a string comparison per
+ *          level. Since no item is stored whole, retrieve() hands out a copy,
+ *          and an inserted NodeData* is deleted once its characters are in
+ *          the tree, as in an INLINE BinTree.
+ * @author  Brendan Sweeney, SID 1161836
+ * @date    October 14, 2026
+ */
+
+#ifndef _RADIXTREE_H
+#define	_RADIXTREE_H
+
+#include <string>           // edge labels
+#include <string_view>      // keys being searched for
+#include <vector>           // children of a node
+
+#include "nodedata.h"
+
+
+class RadixTree
+{
+/**---------------------- << Stream Out Operator ------------------------------
+ * Writes the contents of a tree to the provided ostream, in sorted order,
+ * space separated on a single line.
+ * @param output  The ostream to which to write the tree's contents.
+ * @param source  The tree whose contents are to be written.
+ * @pre The ostream, output, is writable.
+ * @post The ostream, output, contains a string representing the contents of
+ *       the tree, in sorted order; the tree remains unchanged.
+ * @return A reference to the provided ostream, with the contents of the tree
+ *         appended to it.
+ */
+    friend ostream& operator<<(ostream& output, const RadixTree& source);
+
+public:
+
+/**---------------------- Default Constructor ---------------------------------
+ * Creates an empty tree.
+ * @pre None.
+ * @post An empty radix tree exists.
+ */
+    RadixTree();
+
+/**---------------------- Copy Constructor ------------------------------------
+ * Copies the tree orig into a new tree, node by node.
+ * @param orig  The tree to be copied.
+ * @pre There is sufficient memory to allocate a copy of orig.
+ * @post A radix tree exists that holds the same items as orig; orig remains
+ *       unchanged.
+ */
+    RadixTree(const RadixTree& orig);
+
+/**---------------------- Destructor ------------------------------------------
+ * Deallocates memory for a tree before it is released.
+ * @pre None.
+ * @post This tree is empty before it is released.
+ */
+    ~RadixTree();
+
+/**---------------------- isEmpty() -------------------------------------------
+ * Determines whether a radix tree is empty.
+ * @pre None.
+ * @post This tree remains unchanged.
+ * @return true if the tree is empty; false, otherwise.
+ */
+    bool isEmpty(void) const;
+
+/**---------------------- makeEmpty() -----------------------------------------
+ * Deallocates memory for a tree.
+ * @pre None.
+ * @post This tree is now empty.
+ */
+    void makeEmpty(void);
+
+/**---------------------- = Assignment Operator -------------------------------
+ * Copies the contents of rhs into this tree. Any contents of this tree are
+ * removed beforehand.
+ * @param rhs  The right-hand tree to be copied.
+ * @pre There is sufficient memory to allocate a copy of rhs.
+ * @post This tree holds the same items as rhs; rhs remains unchanged.
+ * @return This radix tree, which is equivalent to rhs.
+ */
+    RadixTree& operator=(const RadixTree& rhs);
+
+/**---------------------- == Equality Operator --------------------------------
+ * Compares this radix tree with another for equality. The shape of a radix
+ * tree depends only on its items, so trees are equal if and only if they
+ * hold the same items, and they are compared edge by edge.
+ * @param rhs  The right-hand tree to be compared.
+ * @pre None.
+ * @post Both radix trees remain unchanged.
+ * @return true if both trees hold the same items; false, otherwise.
+ */
+    bool operator==(const RadixTree& rhs) const;
+
+/**---------------------- != Inequality Operator ------------------------------
+ * Compares this radix tree with another for inequality.
+ * @param rhs  The right-hand tree to be compared.
+ * @pre None.
+ * @post Both radix trees remain unchanged.
+ * @return false if both trees hold the same items; true, otherwise.
+ */
+    bool operator!=(const RadixTree& rhs) const;
+
+/**---------------------- insert() --------------------------------------------
+ * Inserts an item into a radix tree, taking ownership of newItem if it is
+ * inserted. Its characters are then stored along the edges of the tree, and
+ * newItem is deleted.
+ * @param newItem  An object to be added to the tree.
+ * @pre NodeData provides the view() method.
+ * @post The value of newItem is in the tree.
+ * @return true if newItem could be inserted in the tree; false if newItem
+ *         already existed in the tree or memory could not be allocated.
+ */
+    bool insert(NodeData *newItem);
+
+/**---------------------- insert() --------------------------------------------
+ * Inserts the value of an item into a radix tree. Only the characters beyond
+ * the longest prefix already in the tree are stored, so moving newItem gains
+ * nothing; it is accepted for compatibility with BinTree and left unchanged.
+ * @param newItem  An object whose value is to be added to the tree.
+ * @pre NodeData provides the view() method.
+ * @post The value of newItem is in the tree.
+ * @return true if newItem could be inserted in the tree; false if newItem
+ *         already existed in the tree or memory could not be allocated.
+ */
+    bool insert(NodeData&& newItem);
+
+/**---------------------- insert() --------------------------------------------
+ * Inserts the value of an item into a radix tree; the caller keeps ownership
+ * of newItem. A new edge is labelled with the characters beyond the longest
+ * prefix already in the tree, and an edge that diverges from newItem partway
+ * along is split in two.
+ * @param newItem  An object whose value is to be added to the tree.
+ * @pre NodeData provides the view() method.
+ * @post The value of newItem is in the tree.
+ * @return true if newItem could be inserted in the tree; false if newItem
+ *         already existed in the tree or memory could not be allocated.
+ */
+    bool insert(const NodeData& newItem);
+
+/**---------------------- retrieve() ------------------------------------------
+ * Retrieves a copy of a given item from a radix tree, in time proportional to
+ * the length of the item.
+ * @param searchItem  The item to be located.
+ * @param dataItem  A container for a copy of the found item.
+ * @pre NodeData provides the view() method.
+ * @post If the retrieval was successful, dataItem is equal to the retrieved
+ *       item; this tree remains unchanged.
+ * @return true if searchItem matches an item in the tree; false if searchItem
+ *         could not be found.
+ */
+    bool retrieve(const NodeData& searchItem, NodeData& dataItem) const;
+
+/**---------------------- contains() ------------------------------------------
+ * Determines whether an item is in a radix tree, without copying it.
+ * @param searchItem  The item to be located.
+ * @pre NodeData provides the view() method.
+ * @post This tree remains unchanged.
+ * @return true if searchItem matches an item in the tree; false, otherwise.
+ */
+    bool contains(const NodeData& searchItem) const;
+
+/**---------------------- getDepth() ------------------------------------------
+ * Determines the depth of the node that ends an item in a radix tree: the
+ * number of edges followed to spell it, plus one for the root. The empty
+ * string ends at the root, which is at depth 1.
+ * @param searchItem  The item to locate in the tree.
+ * @pre NodeData provides the view() method.
+ * @post This tree remains unchanged.
+ * @return The depth of the node ending searchItem, if found; 0, otherwise.
+ */
+    int getDepth(const NodeData& searchItem) const;
+
+/**---------------------- size() ----------------------------------------------
+ * Determines the number of items in a radix tree.
+ * @pre None.
+ * @post This tree remains unchanged.
+ * @return The number of items in this tree.
+ */
+    int size(void) const;
+
+private:
+
+    struct Node
+    {
+        string        label;    // Characters on the edge from the parent
+        string        firsts;   // First character of each child's label
+        vector<Node*> children; // Subtrees, in ascending order of firsts
+        bool          terminal; // Whether the path to here spells an item
+
+        Node(string_view text) : label(text), terminal(false)
+        {
+        } // end constructor
+    }; // end Node
+
+    Node *root;             // Node with an empty label; NULL if none yet
+    int   nodeCount;        // Number of items in this tree
+
+/**---------------------- childSlot() -----------------------------------------
+ * Determines where a child beginning with a character is, or would go, among
+ * the children of a node. Characters are ordered as unsigned, as
+ * string::compare orders them.
+ * @param treePtr  The node to search.
+ * @param first  The first character of the child's label.
+ * @pre treePtr is not NULL.
+ * @post The node remains unchanged.
+ * @return The number of children whose labels begin with a smaller
+ *         character.
+ */
+    static size_t childSlot(const Node *treePtr, char first);
+
+/**---------------------- locate() --------------------------------------------
+ * Finds the node at which a key is spelled out.
+ * @param key  The characters to follow from the root.
+ * @param level  A container for the depth of that node, where the root is at
+ *        depth 1.
+ * @pre None.
+ * @post This tree remains unchanged.
+ * @return The node reached after the last character of key, whether or not
+ *         it is terminal; NULL if the tree has no such node.
+ */
+    const Node *locate(string_view key, int& level) const;
+
+/**---------------------- insertKey() -----------------------------------------
+ * Inserts a key into a radix tree. The search follows edges while they match
+ * the key, then every node the insert needs is allocated before the tree is
+ * changed, so a failure leaves the tree as it was.
+ * @param key  The characters of the item to be inserted.
+ * @pre None.
+ * @post key is spelled out by a path ending at a terminal node.
+ * @return true if the item is successfully inserted; false if the item already
+ *         exists in this tree or memory could not be allocated.
+ */
+    bool insertKey(string_view key);
+
+/**---------------------- copyTree() ------------------------------------------
+ * Copies the tree rooted at treePtr into a tree rooted at newTreePtr. Each
+ * stack entry pairs a node to be copied with the link that will point to its
+ * copy.
+ * @param treePtr  The root of the tree to be copied.
+ * @param newTreePtr  A container for the root of a copy of treePtr.
+ * @pre newTreePtr is NULL.
+ * @post newTreePtr points to the root of a copy of the tree rooted at treePtr.
+ * @throw bad_alloc if memory could not be allocated; newTreePtr then points
+ *        to the part copied so far, which destroyTree() can free.
+ */
+    static void copyTree(const Node *treePtr, Node *& newTreePtr);
+
+/**---------------------- destroyTree() ---------------------------------------
+ * Deallocates memory for a tree, with the nodes still to be freed kept on an
+ * explicit stack.
+ * @param treePtr  Pointer to the root of the tree to be deallocated.
+ * @pre None.
+ * @post treePtr points to an empty tree.
+ */
+    static void destroyTree(Node *& treePtr);
+
+}; // end RadixTree
+
+
+#endif	/* _RADIXTREE_H */
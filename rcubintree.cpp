@@ -0,0 +1,368 @@
+/*
+ * @file    rcubintree.cpp
+ * @brief   This class is a BinTree whose lookups are wait-free, in the style
+ *          of read-copy-update. Readers follow a published snapshot of the
+ *          tree without taking any lock. A writer never changes a node that
+ *          a snapshot can reach: it inserts into a SHARED master tree, which
+ *          copies only the nodes on the insertion path, then publishes a new
+ *          snapshot with a single atomic store. Old snapshots are reclaimed
+ *          by epochs: each reader announces the epoch in which it entered,
+ *          and a snapshot retired in an earlier epoch than every announced
+ *          one can no longer be seen, so it is deleted. Writers are
+ *          serialized with a mutex; readers must register for a slot first.
+ * @author  Brendan Sweeney, SID 1161836
+ * @date    October 14, 2026
+ */
+
+#include <utility>          // for move and make_pair
+
+#include "rcubintree.h"
+
+using namespace std;
+
+
+/**---------------------- Option Constructor ----------------------------------
+ * Creates an empty tree which behaves according to the provided options. The
+ * tree is always SHARED, since snapshots are taken after every write.
+ * @param options  A bitwise or of BinTree::Option values.
+ * @pre None.
+ * @post An empty binary search tree exists, with an empty snapshot published.
+ */
+RcuBinTree::RcuBinTree(int options)
+    : current(NULL), epoch(1), count(0), master(options | BinTree::SHARED)
+{
+    for (int i = 0; i < MAX_READERS; ++i)
+    {
+        slots[i].epoch.store(0);
+        slots[i].claimed.store(false);
+    } // end for (int i = 0)
+
+    current.store(new BinTree(master));
+} // end constructor(int)
+
+/**---------------------- Destructor ------------------------------------------
+ * Deallocates the tree and every snapshot of it.
+ * @pre No reader is inside retrieve() or getDepth().
+ * @post All memory held by this tree is released.
+ */
+RcuBinTree::~RcuBinTree()
+{
+    for (size_t i = 0; i < retired.size(); ++i)
+    {
+        delete retired[i].first;
+    } // end for (size_t i = 0)
+
+    delete current.load();
+} // end destructor
+
+/**---------------------- registerReader() ------------------------------------
+ * Claims a reader slot for the calling thread. Each thread that reads from
+ * this tree must hold a slot of its own, which is passed to every lookup.
+ * @pre None.
+ * @post One more slot is claimed, if any was free.
+ * @return The index of the claimed slot; -1 if all MAX_READERS are claimed.
+ */
+int RcuBinTree::registerReader(void)
+{
+    int reader = -1;
+
+    for (int i = 0; i < MAX_READERS && reader < 0; ++i)
+    {
+        bool unclaimed = false;
+
+        if (slots[i].claimed.compare_exchange_strong(unclaimed, true))
+        {
+            reader = i;
+        } // end if (slots[i].claimed.compare_exchange_strong(...))
+    } // end for (int i = 0)
+
+    return reader;
+} // end registerReader()
+
+/**---------------------- unregisterReader() ----------------------------------
+ * Releases a reader slot, so that another thread may claim it.
+ * @param reader  A slot returned by registerReader().
+ * @pre reader is claimed by the calling thread, which is not inside a lookup.
+ * @post The slot is free.
+ */
+void RcuBinTree::unregisterReader(int reader)
+{
+    slots[reader].epoch.store(0);
+    slots[reader].claimed.store(false, memory_order_release);
+} // end unregisterReader(int)
+
+/**---------------------- retrieve() ------------------------------------------
+ * Retrieves a copy of a given item from the latest published snapshot. The
+ * search takes no lock and never waits for a writer.
+ * @param reader  The slot of the calling thread.
+ * @param searchItem  The item to be located.
+ * @param dataItem  A container for a copy of the found item.
+ * @pre reader is claimed by the calling thread; NodeData provides the
+ *      compare() method.
+ * @post If the retrieval was successful, dataItem is equal to the retrieved
+ *       item; this tree remains unchanged.
+ * @return true if searchItem matches an item in the tree; false if searchItem
+ *         could not be found.
+ */
+bool RcuBinTree::retrieve(int reader, const NodeData& searchItem,
+                                      NodeData& dataItem) const
+{
+    const BinTree *snapshot = enter(reader);
+    NodeData      *found;
+    bool           success = snapshot->retrieve(searchItem, found);
+
+    if (success)
+    {
+        dataItem = *found;          // copied before the snapshot may go
+    } // end if (success)
+
+    leave(reader);
+
+    return success;
+} // end retrieve(int, NodeData&, NodeData&)
+
+/**---------------------- getDepth() ------------------------------------------
+ * Determines the depth of a node in the latest published snapshot, without
+ * taking a lock.
+ * @param reader  The slot of the calling thread.
+ * @param searchItem  The item to locate in the tree.
+ * @pre reader is claimed by the calling thread; NodeData provides the
+ *      compare() method.
+ * @post This tree remains unchanged.
+ * @return The depth of the node containing searchItem, if found, where the
+ *         root is at depth 1; 0, otherwise.
+ */
+int RcuBinTree::getDepth(int reader, const NodeData& searchItem) const
+{
+    int level = enter(reader)->getDepth(searchItem);
+
+    leave(reader);
+
+    return level;
+} // end getDepth(int, NodeData&)
+
+/**---------------------- size() ----------------------------------------------
+ * Determines the number of items in the latest published snapshot.
+ * @pre None.
+ * @post This tree remains unchanged.
+ * @return The number of items in the tree.
+ */
+int RcuBinTree::size(void) const
+{
+    return count.load(memory_order_acquire);
+} // end size()
+
+/**---------------------- insert() --------------------------------------------
+ * Inserts an item into the tree, taking ownership of newItem if it is
+ * inserted, and publishes the result to readers.
+ * @param newItem  An object to be added to the tree.
+ * @pre NodeData provides the compare() method.
+ * @post newItem is in its proper position in the tree, which readers see.
+ * @return true if newItem could be inserted in the tree; false if newItem
+ *         already existed in the tree.
+ */
+bool RcuBinTree::insert(NodeData *newItem)
+{
+    lock_guard<mutex> guard(writing);
+    bool              success = master.insert(newItem);
+
+    if (success)
+    {
+        publish();
+    } // end if (success)
+
+    return success;
+} // end insert(NodeData*)
+
+/**---------------------- insert() --------------------------------------------
+ * Inserts an item into the tree by moving its value, and publishes the result
+ * to readers.
+ * @param newItem  An object whose value is to be added to the tree.
+ * @pre NodeData provides the compare() method.
+ * @post The former value of newItem is in its proper position in the tree,
+ *       and newItem is empty; if the insertion failed, newItem is unchanged.
+ * @return true if newItem could be inserted in the tree; false if newItem
+ *         already existed in the tree.
+ */
+bool RcuBinTree::insert(NodeData&& newItem)
+{
+    lock_guard<mutex> guard(writing);
+    bool              success = master.insert(std::move(newItem));
+
+    if (success)
+    {
+        publish();
+    } // end if (success)
+
+    return success;
+} // end insert(NodeData&&)
+
+/**---------------------- insert() --------------------------------------------
+ * Inserts a copy of an item into the tree, and publishes the result to
+ * readers.
+ * @param newItem  The item whose value is to be added to the tree.
+ * @pre NodeData provides the compare() method.
+ * @post A copy of newItem is in its proper position in the tree; newItem
+ *       remains unchanged.
+ * @return true if newItem could be inserted in the tree; false if newItem
+ *         already existed in the tree.
+ */
+bool RcuBinTree::insert(const NodeData& newItem)
+{
+    lock_guard<mutex> guard(writing);
+    bool              success = master.insert(newItem);
+
+    if (success)
+    {
+        publish();
+    } // end if (success)
+
+    return success;
+} // end insert(NodeData&)
+
+/**---------------------- remove() --------------------------------------------
+ * Removes an item from the tree, and publishes the result to readers. Only
+ * the nodes on the path to the item and its successor are copied.
+ * @param oldItem  An object equal to the item to be removed.
+ * @pre NodeData provides the compare() method.
+ * @post No item equal to oldItem is in the tree, which readers see.
+ * @return true if oldItem was found and removed; false, otherwise.
+ */
+bool RcuBinTree::remove(const NodeData& oldItem)
+{
+    lock_guard<mutex> guard(writing);
+    bool              success = master.remove(oldItem);
+
+    if (success)
+    {
+        publish();
+    } // end if (success)
+
+    return success;
+} // end remove(NodeData&)
+
+/**---------------------- makeEmpty() -----------------------------------------
+ * Empties the tree, and publishes the empty tree to readers. Items are
+ * deleted once no reader can see them.
+ * @pre None.
+ * @post This tree is now empty.
+ */
+void RcuBinTree::makeEmpty(void)
+{
+    lock_guard<mutex> guard(writing);
+
+    master.makeEmpty();             // readers' nodes are held by snapshots
+    publish();
+} // end makeEmpty()
+
+/**---------------------- rebalance() -----------------------------------------
+ * Rebalances a copy of the tree and publishes it to readers. Every node is
+ * copied, since readers may still be following the old ones.
+ * @pre None.
+ * @post This tree holds the same items as before, with minimal height.
+ */
+void RcuBinTree::rebalance(void)
+{
+    lock_guard<mutex> guard(writing);
+
+    master.rebalance();             // copies every node still shared
+    publish();
+} // end rebalance()
+
+/**---------------------- reclaim() -------------------------------------------
+ * Deletes every retired snapshot that no reader can still be following.
+ * Writes reclaim on their own; this is for a writer that has gone quiet.
+ * @pre None.
+ * @post Snapshots retired before the epoch of every active reader are
+ *       deleted.
+ * @return The number of retired snapshots that are still pending.
+ */
+int RcuBinTree::reclaim(void)
+{
+    lock_guard<mutex> guard(writing);
+
+    reclaimRetired();
+
+    return static_cast<int>(retired.size());
+} // end reclaim()
+
+/**---------------------- enter() ---------------------------------------------
+ * Announces that a reader is following the current snapshot, and finds it.
+ * @param reader  The slot of the calling thread.
+ * @pre reader is claimed by the calling thread, which is not inside a lookup.
+ * @post The snapshot returned will not be deleted until leave(reader).
+ * @return The latest published snapshot.
+ */
+const BinTree *RcuBinTree::enter(int reader) const
+{
+    // the announcement must be visible before the snapshot is read, or a
+    // writer could retire and delete it in between; both are seq_cst
+    slots[reader].epoch.store(epoch.load());
+
+    return current.load();
+} // end enter(int)
+
+/**---------------------- leave() ---------------------------------------------
+ * Announces that a reader is no longer following any snapshot.
+ * @param reader  The slot of the calling thread.
+ * @pre enter(reader) was called by the calling thread.
+ * @post The slot of reader no longer holds back reclamation.
+ */
+void RcuBinTree::leave(int reader) const
+{
+    slots[reader].epoch.store(0, memory_order_release);
+} // end leave(int)
+
+/**---------------------- publish() -------------------------------------------
+ * Makes the master tree visible to readers as a new snapshot, then retires
+ * the old snapshot and reclaims what it can.
+ * @pre The calling thread holds writing.
+ * @post Readers entering from now on see the master tree as it is now.
+ */
+void RcuBinTree::publish(void)
+{
+    const BinTree *fresh = new BinTree(master);     // O(1); nodes shared
+    const BinTree *stale = current.exchange(fresh);
+
+    // readers announcing a later epoch entered after the exchange
+    retired.push_back(make_pair(stale, epoch.fetch_add(1)));
+    count.store(fresh->size(), memory_order_release);
+    reclaimRetired();
+} // end publish()
+
+/**---------------------- reclaimRetired() ------------------------------------
+ * Deletes every retired snapshot that no reader can still be following.
+ * @pre The calling thread holds writing.
+ * @post Snapshots retired before the epoch of every active reader are
+ *       deleted.
+ */
+void RcuBinTree::reclaimRetired(void)
+{
+    unsigned long oldest = epoch.load();    // no reader is older than now
+    size_t        kept = 0;
+
+    for (int i = 0; i < MAX_READERS; ++i)
+    {
+        unsigned long announced = slots[i].epoch.load();
+
+        if (announced != 0 && announced < oldest)
+        {
+            oldest = announced;
+        } // end if (announced != 0 && announced < oldest)
+    } // end for (int i = 0)
+
+    // a snapshot retired during epoch e may be seen by readers of epoch e
+    for (size_t i = 0; i < retired.size(); ++i)
+    {
+        if (retired[i].second < oldest)
+        {
+            delete retired[i].first;
+        }
+        else
+        {
+            retired[kept++] = retired[i];
+        } // end if (retired[i].second < oldest)
+    } // end for (size_t i = 0)
+
+    retired.resize(kept);
+} // end reclaimRetired()
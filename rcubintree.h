@@ -0,0 +1,235 @@
+/*
+ * @file    rcubintree.h
+ * @brief   This class is a BinTree whose lookups are wait-free, in the style
+ *          of read-copy-update. Readers follow a published snapshot of the
+ *          tree without taking any lock. A writer never changes a node that
+ *          a snapshot can reach: it inserts into a SHARED master tree, which
+ *          copies only the nodes on the insertion path, then publishes a new
+ *          snapshot with a single atomic store. Old snapshots are reclaimed
+ *          by epochs: each reader announces the epoch in which it entered,
+ *          and a snapshot retired in an earlier epoch than every announced
+ *          one can no longer be seen, so it is deleted. Writers are
+ *          serialized with a mutex; readers must register for a slot first.
+ * @author  Brendan Sweeney, SID 1161836
+ * @date    October 14, 2026
+ */
+
+#ifndef _RCUBINTREE_H
+#define	_RCUBINTREE_H
+
+#include <atomic>           // for atomic, used for publication and epochs
+#include <mutex>            // for mutex, which serializes writers
+#include <utility>          // for pair
+#include <vector>           // list of retired snapshots
+
+#include "bintree.h"
+
+
+class RcuBinTree
+{
+public:
+
+    // number of threads that may be registered as readers at once
+    static const int MAX_READERS = 64;
+
+/**---------------------- Option Constructor ----------------------------------
+ * Creates an empty tree which behaves according to the provided options. The
+ * tree is always SHARED, since snapshots are taken after every write.
+ * @param options  A bitwise or of BinTree::Option values.
+ * @pre None.
+ * @post An empty binary search tree exists, with an empty snapshot published.
+ */
+    explicit RcuBinTree(int options = BinTree::PLAIN);
+
+/**---------------------- Destructor ------------------------------------------
+ * Deallocates the tree and every snapshot of it.
+ * @pre No reader is inside retrieve() or getDepth().
+ * @post All memory held by this tree is released.
+ */
+    ~RcuBinTree();
+
+/**---------------------- registerReader() ------------------------------------
+ * Claims a reader slot for the calling thread. Each thread that reads from
+ * this tree must hold a slot of its own, which is passed to every lookup.
+ * @pre None.
+ * @post One more slot is claimed, if any was free.
+ * @return The index of the claimed slot; -1 if all MAX_READERS are claimed.
+ */
+    int registerReader(void);
+
+/**---------------------- unregisterReader() ----------------------------------
+ * Releases a reader slot, so that another thread may claim it.
+ * @param reader  A slot returned by registerReader().
+ * @pre reader is claimed by the calling thread, which is not inside a lookup.
+ * @post The slot is free.
+ */
+    void unregisterReader(int reader);
+
+/**---------------------- retrieve() ------------------------------------------
+ * Retrieves a copy of a given item from the latest published snapshot. The
+ * search takes no lock and never waits for a writer.
+ * @param reader  The slot of the calling thread.
+ * @param searchItem  The item to be located.
+ * @param dataItem  A container for a copy of the found item.
+ * @pre reader is claimed by the calling thread; NodeData provides the
+ *      compare() method.
+ * @post If the retrieval was successful, dataItem is equal to the retrieved
+ *       item; this tree remains unchanged.
+ * @return true if searchItem matches an item in the tree; false if searchItem
+ *         could not be found.
+ */
+    bool retrieve(int reader, const NodeData& searchItem,
+                              NodeData& dataItem) const;
+
+/**---------------------- getDepth() ------------------------------------------
+ * Determines the depth of a node in the latest published snapshot, without
+ * taking a lock.
+ * @param reader  The slot of the calling thread.
+ * @param searchItem  The item to locate in the tree.
+ * @pre reader is claimed by the calling thread; NodeData provides the
+ *      compare() method.
+ * @post This tree remains unchanged.
+ * @return The depth of the node containing searchItem, if found, where the
+ *         root is at depth 1; 0, otherwise.
+ */
+    int getDepth(int reader, const NodeData& searchItem) const;
+
+/**---------------------- size() ----------------------------------------------
+ * Determines the number of items in the latest published snapshot.
+ * @pre None.
+ * @post This tree remains unchanged.
+ * @return The number of items in the tree.
+ */
+    int size(void) const;
+
+/**---------------------- insert() --------------------------------------------
+ * Inserts an item into the tree, taking ownership of newItem if it is
+ * inserted, and publishes the result to readers.
+ * @param newItem  An object to be added to the tree.
+ * @pre NodeData provides the compare() method.
+ * @post newItem is in its proper position in the tree, which readers see.
+ * @return true if newItem could be inserted in the tree; false if newItem
+ *         already existed in the tree.
+ */
+    bool insert(NodeData *newItem);
+
+/**---------------------- insert() --------------------------------------------
+ * Inserts an item into the tree by moving its value, and publishes the result
+ * to readers.
+ * @param newItem  An object whose value is to be added to the tree.
+ * @pre NodeData provides the compare() method.
+ * @post The former value of newItem is in its proper position in the tree,
+ *       and newItem is empty; if the insertion failed, newItem is unchanged.
+ * @return true if newItem could be inserted in the tree; false if newItem
+ *         already existed in the tree.
+ */
+    bool insert(NodeData&& newItem);
+
+/**---------------------- insert() --------------------------------------------
+ * Inserts a copy of an item into the tree, and publishes the result to
+ * readers.
+ * @param newItem  The item whose value is to be added to the tree.
+ * @pre NodeData provides the compare() method.
+ * @post A copy of newItem is in its proper position in the tree; newItem
+ *       remains unchanged.
+ * @return true if newItem could be inserted in the tree; false if newItem
+ *         already existed in the tree.
+ */
+    bool insert(const NodeData& newItem);
+
+/**---------------------- remove() --------------------------------------------
+ * Removes an item from the tree, and publishes the result to readers. Only
+ * the nodes on the path to the item and its successor are copied.
+ * @param oldItem  An object equal to the item to be removed.
+ * @pre NodeData provides the compare() method.
+ * @post No item equal to oldItem is in the tree, which readers see.
+ * @return true if oldItem was found and removed; false, otherwise.
+ */
+    bool remove(const NodeData& oldItem);
+
+/**---------------------- makeEmpty() -----------------------------------------
+ * Empties the tree, and publishes the empty tree to readers. Items are
+ * deleted once no reader can see them.
+ * @pre None.
+ * @post This tree is now empty.
+ */
+    void makeEmpty(void);
+
+/**---------------------- rebalance() -----------------------------------------
+ * Rebalances a copy of the tree and publishes it to readers. Every node is
+ * copied, since readers may still be following the old ones.
+ * @pre None.
+ * @post This tree holds the same items as before, with minimal height.
+ */
+    void rebalance(void);
+
+/**---------------------- reclaim() -------------------------------------------
+ * Deletes every retired snapshot that no reader can still be following.
+ * Writes reclaim on their own; this is for a writer that has gone quiet.
+ * @pre None.
+ * @post Snapshots retired before the epoch of every active reader are
+ *       deleted.
+ * @return The number of retired snapshots that are still pending.
+ */
+    int reclaim(void);
+
+private:
+
+    // an epoch announced by one reader, alone on its cache line so readers
+    // never contend with one another
+    struct alignas(64) Slot
+    {
+        atomic<unsigned long> epoch;    // Epoch of entry; 0 if not reading
+        atomic<bool>          claimed;  // Whether a thread holds this slot
+    }; // end Slot
+
+    mutable Slot    slots[MAX_READERS]; // Announcements of the readers
+    atomic<const BinTree*> current;     // Snapshot that readers follow
+    atomic<unsigned long>  epoch;       // Epoch in which readers now enter
+    atomic<int>     count;              // Number of items in current
+    mutex           writing;            // Held by the one active writer
+    BinTree         master;             // The tree writers change
+    vector< pair<const BinTree*, unsigned long> > retired;
+                                        // Snapshots and their last epochs
+
+    // the slots and snapshots cannot be shared with a copy
+    RcuBinTree(const RcuBinTree&);
+    RcuBinTree& operator=(const RcuBinTree&);
+
+/**---------------------- enter() ---------------------------------------------
+ * Announces that a reader is following the current snapshot, and finds it.
+ * @param reader  The slot of the calling thread.
+ * @pre reader is claimed by the calling thread, which is not inside a lookup.
+ * @post The snapshot returned will not be deleted until leave(reader).
+ * @return The latest published snapshot.
+ */
+    const BinTree *enter(int reader) const;
+
+/**---------------------- leave() ---------------------------------------------
+ * Announces that a reader is no longer following any snapshot.
+ * @param reader  The slot of the calling thread.
+ * @pre enter(reader) was called by the calling thread.
+ * @post The slot of reader no longer holds back reclamation.
+ */
+    void leave(int reader) const;
+
+/**---------------------- publish() -------------------------------------------
+ * Makes the master tree visible to readers as a new snapshot, then retires
+ * the old snapshot and reclaims what it can.
+ * @pre The calling thread holds writing.
+ * @post Readers entering from now on see the master tree as it is now.
+ */
+    void publish(void);
+
+/**---------------------- reclaimRetired() ------------------------------------
+ * Deletes every retired snapshot that no reader can still be following.
+ * @pre The calling thread holds writing.
+ * @post Snapshots retired before the epoch of every active reader are
+ *       deleted.
+ */
+    void reclaimRetired(void);
+
+}; // end RcuBinTree
+
+
+#endif	/* _RCUBINTREE_H */
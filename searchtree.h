@@ -0,0 +1,1191 @@
+/*
+ * @file    searchtree.h
+ * @brief   This class template represents a binary search tree of keys of any
+ *          type, ordered by a comparator and held in nodes drawn from an
+ *          allocator, which are all fixed when the template is instantiated.
+ *          Each key is stored in its node, and every comparison is a call the
+ *          compiler can see, so searches of integer or fixed-width keys are
+ *          as cheap as the keys are. Where a key type has a three-way
+ *          comparison, KeyOrder may be specialized to use it; it is
+ *          specialized here for NodeData ordered by less, so SearchTree
+ *          <NodeData> compares each node once, as BinTree does. A tree may
+ *          be PLAIN, in which case its shape follows the order of insertion,
+ *          or BALANCED, in which case it is kept height balanced (AVL) on
+ *          every insert, along the same path of rotations as BinTree; either
+ *          is balanced when built from a sorted array with arrayToBSTree().
+ *          SearchTree holds only the core of BinTree: it has no remove() or
+ *          removeIf(), so a tree is only emptied as a whole, and none of the
+ *          POOLED, INLINE, SHARED, PARALLEL, LAZY or CACHED modes (an
+ *          allocator takes the place of a pool), no build() from unsorted
+ *          items, rebalance(), freeze(), save() or load(), no iterators,
+ *          rank(), select(), bounds or retrieveMany(), and no getStats().
+ *          Keys that need those are held as NodeData in a BinTree.
+ * @author  Brendan Sweeney, SID 1161836
+ * @date    October 14, 2026
+ */
+
+#ifndef _SEARCHTREE_H
+#define	_SEARCHTREE_H
+
+#include <functional>       // for less
+#include <iostream>         // for cerr
+#include <memory>           // for allocator, allocator_traits
+#include <new>              // for bad_alloc
+#include <utility>          // for pair, move
+#include <vector>           // explicit stacks, and arrays of keys
+
+#include "nodedata.h"
+
+
+/**---------------------- KeyOrder --------------------------------------------
+ * Orders two keys, as compare() of NodeData does, from the comparator of a
+ * tree. The general case asks the comparator up to twice; a specialization
+ * may answer in one comparison.
+ */
+template <class Key, class Compare>
+struct KeyOrder
+{
+    static int compare(const Compare& less, const Key& lhs, const Key& rhs)
+    {
+        return less(lhs, rhs) ? -1 : (less(rhs, lhs) ? 1 : 0);
+    } // end compare()
+}; // end KeyOrder
+
+// NodeData ordered by less has a three-way comparison of its own
+template <>
+struct KeyOrder<NodeData, std::less<NodeData> >
+{
+    static int compare(const std::less<NodeData>&, const NodeData& lhs,
+                       const NodeData& rhs)
+    {
+        return lhs.compare(rhs);
+    } // end compare()
+}; // end KeyOrder<NodeData, less<NodeData> >
+
+
+template <class Key, class Compare = std::less<Key>,
+          class Alloc = std::allocator<Key> >
+class SearchTree
+{
+/**---------------------- << Stream Out Operator ------------------------------
+ * Writes the contents of a tree to the provided ostream, in sorted order,
+ * each item preceded by a space, on a single line.
+ * @param output  The ostream to which to write the tree's contents.
+ * @param source  The tree whose contents are to be written.
+ * @pre The ostream, output, is writable; Key provides <<.
+ * @post The ostream, output, contains a string representing the contents of
+ *       the tree, in sorted order; the tree remains unchanged.
+ * @return A reference to the provided ostream, with the contents of the tree
+ *         appended to it.
+ */
+    friend ostream& operator<<(ostream& output, const SearchTree& source)
+    {
+        source.forEach([&output](const Key& item) { output << ' ' << item; });
+        output << endl;
+        return output;
+    } // end operator<<(ostream&, const SearchTree&)
+
+public:
+
+/**---------------------- Option ----------------------------------------------
+ * Construction options for a tree, with the values of the BinTree options of
+ * the same names. PLAIN trees insert without rebalancing, so sorted input
+ * makes a list of them; BALANCED trees are kept height balanced (AVL) on
+ * every insert, so their height stays within 1.44 log2(n).
+ */
+    enum Option
+    {
+        PLAIN    = 0,       // unbalanced insertion
+        BALANCED = 1        // AVL rebalancing on insertion
+    }; // end Option
+
+/**---------------------- Default Constructor ---------------------------------
+ * Creates an empty, unbalanced tree.
+ * @param less  The comparator by which keys are ordered.
+ * @param alloc  The allocator from which nodes are drawn.
+ * @pre None.
+ * @post An empty, unbalanced binary search tree exists.
+ */
+    explicit SearchTree(const Compare& less = Compare(),
+                        const Alloc& alloc = Alloc());
+
+/**---------------------- Option Constructor ----------------------------------
+ * Creates an empty tree which behaves according to the provided options.
+ * @param options  A bitwise or of Option values.
+ * @param less  The comparator by which keys are ordered.
+ * @param alloc  The allocator from which nodes are drawn.
+ * @pre None.
+ * @post An empty binary search tree exists; if options includes BALANCED, the
+ *       tree will remain height balanced as keys are inserted.
+ */
+    explicit SearchTree(int options, const Compare& less = Compare(),
+                        const Alloc& alloc = Alloc());
+
+/**---------------------- Copy Constructor ------------------------------------
+ * Copies the tree orig into a new tree, with a copy of each of its keys and
+ * the same options.
+ * @param orig  The tree to be copied.
+ * @pre There is sufficient memory to allocate a copy of orig.
+ * @post A binary search tree exists that is a structural copy of the tree
+ *       orig; orig remains unchanged.
+ */
+    SearchTree(const SearchTree& orig);
+
+/**---------------------- Destructor ------------------------------------------
+ * Deallocates memory for a tree before it is released.
+ * @pre None.
+ * @post This tree is empty before it is released.
+ */
+    ~SearchTree();
+
+/**---------------------- isEmpty() -------------------------------------------
+ * Determines whether a binary search tree is empty.
+ * @pre None.
+ * @post This tree remains unchanged.
+ * @return true if the tree is empty; false, otherwise.
+ */
+    bool isEmpty(void) const;
+
+/**---------------------- makeEmpty() -----------------------------------------
+ * Deallocates memory for a tree, without a stack: left children are rotated
+ * up until the smallest node is the root, which is released in turn.
+ * @pre None.
+ * @post This tree is empty.
+ */
+    void makeEmpty(void);
+
+/**---------------------- = Assignment Operator -------------------------------
+ * Copies the contents of rhs into this tree. Any contents of this tree are
+ * removed beforehand, and this tree takes on the options of rhs.
+ * @param rhs  The right-hand tree to be copied.
+ * @pre There is sufficient memory to allocate a copy of rhs.
+ * @post This tree is a structural copy of rhs; rhs remains unchanged.
+ * @return This binary search tree, which is equivalent to rhs.
+ */
+    SearchTree& operator=(const SearchTree& rhs);
+
+/**---------------------- == Equality Operator --------------------------------
+ * Compares this binary search tree with another for equality. Equality means
+ * that both trees contain the same keys and have the same structure.
+ * @param rhs  The right-hand tree to be compared.
+ * @pre None.
+ * @post Both binary search trees remain unchanged.
+ * @return true if both trees have identical structures and content; false,
+ *         otherwise.
+ */
+    bool operator==(const SearchTree& rhs) const;
+
+/**---------------------- != Inequality Operator ------------------------------
+ * Compares this binary search tree with another for inequality.
+ * @param rhs  The right-hand tree to be compared.
+ * @pre None.
+ * @post Both binary search trees remain unchanged.
+ * @return false if both trees have identical structures and content; true,
+ *         otherwise.
+ */
+    bool operator!=(const SearchTree& rhs) const;
+
+/**---------------------- insert() --------------------------------------------
+ * Inserts a copy of a key into a binary search tree, unless it already holds
+ * an equal key. A BALANCED tree is rebalanced on the way back up the path.
+ * @param newItem  The key to be inserted.
+ * @pre None.
+ * @post If newItem was not in this tree, a copy of it is.
+ * @return true if the key was inserted; false if it was already in this tree
+ *         or memory could not be allocated.
+ */
+    bool insert(const Key& newItem);
+
+/**---------------------- insert() --------------------------------------------
+ * Inserts a key into a binary search tree by moving it into a new node,
+ * unless the tree already holds an equal key. A BALANCED tree is rebalanced
+ * on the way back up the path.
+ * @param newItem  The key to be inserted.
+ * @pre None.
+ * @post If newItem was not in this tree, it has been moved into it;
+ *       otherwise, newItem remains unchanged.
+ * @return true if the key was inserted; false if it was already in this tree
+ *         or memory could not be allocated.
+ */
+    bool insert(Key&& newItem);
+
+/**---------------------- retrieve() ------------------------------------------
+ * Locates the key in a tree equal to a given key.
+ * @param searchItem  The key to be located.
+ * @param dataItem  A container for a pointer to the found key.
+ * @pre None.
+ * @post If the key was found, dataItem points to it; otherwise, dataItem is
+ *       NULL. This tree remains unchanged.
+ * @return true if searchItem matches a key in the tree; false, otherwise.
+ */
+    bool retrieve(const Key& searchItem, const Key *& dataItem) const;
+
+/**---------------------- getDepth() ------------------------------------------
+ * Determines the depth of a key in a tree by following its comparison path.
+ * @param searchItem  The key to locate in the tree.
+ * @pre None.
+ * @post This tree remains unchanged.
+ * @return The depth of the node holding searchItem, where the root is at
+ *         depth 1, if found; 0, otherwise.
+ */
+    int getDepth(const Key& searchItem) const;
+
+/**---------------------- getHeight() -----------------------------------------
+ * Determines the height of a binary search tree from the height stored in its
+ * root. An empty tree has a height of 0 and a tree with only a root has a
+ * height of 1.
+ * @pre None.
+ * @post This tree remains unchanged.
+ * @return The number of nodes on the longest path from the root to a leaf.
+ */
+    int getHeight(void) const;
+
+/**---------------------- size() ----------------------------------------------
+ * Determines the number of keys in a binary search tree.
+ * @pre None.
+ * @post This tree remains unchanged.
+ * @return The number of keys in this tree.
+ */
+    int size(void) const;
+
+/**---------------------- forEach() -------------------------------------------
+ * Visits every key of the tree in sorted order.
+ * @param visit  A function or function object taking a const Key&.
+ * @pre visit does not change this tree.
+ * @post visit has been called once for each key in the tree, in sorted
+ *       order; this tree remains unchanged.
+ */
+    template <class Visitor>
+    void forEach(Visitor visit) const;
+
+/**---------------------- bstreeToArray() -------------------------------------
+ * Moves the keys of this tree to the end of a growable buffer, in sorted
+ * order. The tree is left empty.
+ * @param target  The buffer to which to append the keys of this tree.
+ * @pre None.
+ * @post target ends with every key found in this tree, in sorted order;
+ *       this tree is empty.
+ * @return The number of keys appended to target.
+ */
+    int bstreeToArray(vector<Key>& target);
+
+/**---------------------- arrayToBSTree() -------------------------------------
+ * Populates this tree from a buffer of sorted keys, moving each into a node.
+ * Any contents of this tree are removed beforehand. The new tree is balanced
+ * by linking the middle key of each segment of the buffer as the root of its
+ * subtree.
+ * @param source  The keys from which to populate this tree.
+ * @pre source is sorted in ascending order and holds no equal keys.
+ * @post This tree is balanced and holds every key that was in source, unless
+ *       memory ran out, in which case it holds those linked so far; source
+ *       is empty.
+ * @return The number of keys in this tree.
+ */
+    int arrayToBSTree(vector<Key>& source);
+
+private:
+
+    // inserts no deeper than this record their path without allocating memory
+    static const int PATH_LIMIT = 64;
+
+    // each key lives in its node
+    struct Node
+    {
+        Key   data;             // The key held by this node
+        Node *left;             // Pointer to left child
+        Node *right;            // Pointer to right child
+        int   height;           // Height of the subtree rooted at this node
+
+        template <class Item>
+        explicit Node(Item&& item)
+            : data(std::forward<Item>(item)), left(NULL), right(NULL),
+              height(1)
+        {
+        } // end constructor
+    }; // end Node
+
+    typedef typename std::allocator_traits<Alloc>::template rebind_alloc<Node>
+            NodeAlloc;
+    typedef std::allocator_traits<NodeAlloc> NodeTraits;
+
+    Node     *root;             // Pointer to root node of this tree
+    int       options;          // Bitwise or of Option values
+    int       nodeCount;        // Number of keys in this tree
+    Compare   less;             // Order of the keys
+    NodeAlloc alloc;            // Source of the nodes
+
+/**---------------------- order() ---------------------------------------------
+ * Orders two keys by the comparator of the tree.
+ * @param lhs  The key on the left of the comparison.
+ * @param rhs  The key on the right of the comparison.
+ * @pre None.
+ * @post This tree remains unchanged.
+ * @return <0 if lhs is less than rhs; 0 if they are equal; >0 otherwise.
+ */
+    int order(const Key& lhs, const Key& rhs) const;
+
+/**---------------------- makeNode() ------------------------------------------
+ * Allocates a node from the allocator of the tree and constructs its key.
+ * @param item  The key, or the value from which to construct it.
+ * @pre None.
+ * @post A node holding item exists, with no children.
+ * @return A pointer to the new node.
+ * @throw bad_alloc if memory could not be allocated, or whatever the
+ *        constructor of Key throws; nothing is allocated then.
+ */
+    template <class Item>
+    Node* makeNode(Item&& item);
+
+/**---------------------- freeNode() ------------------------------------------
+ * Destroys the key of a node and returns the node to the allocator.
+ * @param treePtr  The node to be released.
+ * @pre treePtr was allocated by makeNode() of this tree.
+ * @post The node is released.
+ */
+    void freeNode(Node *treePtr);
+
+/**---------------------- insertItem() ----------------------------------------
+ * Links a new node holding newItem at the end of its comparison path,
+ * recording the links followed so that the path may be fixed up without
+ * recursion: heights are updated, and a BALANCED tree rebalanced, from the
+ * new leaf up until a subtree is no taller than it was.
+ * @param newItem  The key to be inserted.
+ * @pre None.
+ * @post If newItem was not in this tree, a node holding it is; stored heights
+ *       are current.
+ * @return true if the key was inserted; false otherwise.
+ */
+    template <class Item>
+    bool insertItem(Item&& newItem);
+
+/**---------------------- heightOf() ------------------------------------------
+ * Determines the height of a subtree from the height stored in its root.
+ * @param treePtr  The root of the subtree to measure; may be NULL.
+ * @pre Heights stored in the subtree are current.
+ * @post The subtree remains unchanged.
+ * @return The height of the subtree rooted at treePtr; 0 if it is empty.
+ */
+    static int heightOf(const Node *treePtr);
+
+/**---------------------- refresh() -------------------------------------------
+ * Recomputes the height stored in a node from those of its children.
+ * @param treePtr  The node to update.
+ * @pre treePtr is not NULL; the heights of both children are current.
+ * @post The height stored in treePtr is current.
+ */
+    static void refresh(Node *treePtr);
+
+/**---------------------- rotateLeft() ----------------------------------------
+ * Rotates a subtree to the left, so that the right child of treePtr becomes
+ * the root of the subtree.
+ * @param treePtr  The root of the subtree to rotate.
+ * @pre treePtr and its right child are not NULL.
+ * @post treePtr points to the former right child, which now holds the former
+ *       root as its left child; stored heights are current.
+ */
+    static void rotateLeft(Node *& treePtr);
+
+/**---------------------- rotateRight() ---------------------------------------
+ * Rotates a subtree to the right, so that the left child of treePtr becomes
+ * the root of the subtree.
+ * @param treePtr  The root of the subtree to rotate.
+ * @pre treePtr and its left child are not NULL.
+ * @post treePtr points to the former left child, which now holds the former
+ *       root as its right child; stored heights are current.
+ */
+    static void rotateRight(Node *& treePtr);
+
+/**---------------------- restoreBalance() ------------------------------------
+ * Restores the AVL property at the root of a subtree whose children differ in
+ * height by at most two, using a single or double rotation.
+ * @param treePtr  The root of the subtree to balance.
+ * @pre treePtr is not NULL; both subtrees of treePtr are AVL balanced.
+ * @post The subtree rooted at treePtr is AVL balanced; stored heights are
+ *       current.
+ */
+    static void restoreBalance(Node *& treePtr);
+
+/**---------------------- copyTree() ------------------------------------------
+ * Copies the nodes of another tree into this empty one, keeping the pending
+ * links on an explicit stack.
+ * @param source  The root of the tree to be copied.
+ * @pre This tree is empty.
+ * @post This tree is a structural copy of source, or, if memory ran out,
+ *       empty.
+ */
+    void copyTree(const Node *source);
+
+/**---------------------- buildHelper() ---------------------------------------
+ * Links the middle key of a segment of a sorted buffer, then the middles of
+ * the segments on either side of it as its children.
+ * @param source  The sorted keys.
+ * @param first  The index of the first key of the segment.
+ * @param last  The index after the last key of the segment.
+ * @param link  The link at which to place the root of the segment.
+ * @pre link is NULL; first <= last.
+ * @post The keys of the segment are moved into a balanced subtree at link;
+ *       stored heights are current.
+ * @throw bad_alloc if memory could not be allocated; the nodes linked so
+ *        far remain linked.
+ */
+    void buildHelper(vector<Key>& source, size_t first, size_t last,
+                     Node *& link);
+
+}; // end SearchTree
+
+// the tree of NodeData, comparing each node once
+typedef SearchTree<NodeData> NodeDataTree;
+
+
+/**---------------------- Default Constructor ---------------------------------
+ * Creates an empty tree.
+ * @param less  The comparator by which keys are ordered.
+ * @param alloc  The allocator from which nodes are drawn.
+ * @pre None.
+ * @post An empty binary search tree exists.
+ */
+template <class Key, class Compare, class Alloc>
+SearchTree<Key, Compare, Alloc>::SearchTree(const Compare& less,
+                                            const Alloc& alloc)
+    : root(NULL), options(PLAIN), nodeCount(0), less(less), alloc(alloc)
+{
+} // end default constructor
+
+/**---------------------- Option Constructor ----------------------------------
+ * Creates an empty tree which behaves according to the provided options.
+ * @param options  A bitwise or of Option values.
+ * @param less  The comparator by which keys are ordered.
+ * @param alloc  The allocator from which nodes are drawn.
+ * @pre None.
+ * @post An empty binary search tree exists; if options includes BALANCED, the
+ *       tree will remain height balanced as keys are inserted.
+ */
+template <class Key, class Compare, class Alloc>
+SearchTree<Key, Compare, Alloc>::SearchTree(int options, const Compare& less,
+                                            const Alloc& alloc)
+    : root(NULL), options(options), nodeCount(0), less(less), alloc(alloc)
+{
+} // end constructor(int)
+
+/**---------------------- Copy Constructor ------------------------------------
+ * Copies the tree orig into a new tree, with a copy of each of its keys and
+ * the same options.
+ * @param orig  The tree to be copied.
+ * @pre There is sufficient memory to allocate a copy of orig.
+ * @post A binary search tree exists that is a structural copy of the tree
+ *       orig; orig remains unchanged.
+ */
+template <class Key, class Compare, class Alloc>
+SearchTree<Key, Compare, Alloc>::SearchTree(const SearchTree& orig)
+    : root(NULL), options(orig.options), nodeCount(0), less(orig.less),
+      alloc(NodeTraits::select_on_container_copy_construction(orig.alloc))
+{
+    copyTree(orig.root);
+} // end copy constructor
+
+/**---------------------- Destructor ------------------------------------------
+ * Deallocates memory for a tree before it is released.
+ * @pre None.
+ * @post This tree is empty before it is released.
+ */
+template <class Key, class Compare, class Alloc>
+SearchTree<Key, Compare, Alloc>::~SearchTree()
+{
+    makeEmpty();
+} // end destructor
+
+/**---------------------- isEmpty() -------------------------------------------
+ * Determines whether a binary search tree is empty.
+ * @pre None.
+ * @post This tree remains unchanged.
+ * @return true if the tree is empty; false, otherwise.
+ */
+template <class Key, class Compare, class Alloc>
+bool SearchTree<Key, Compare, Alloc>::isEmpty(void) const
+{
+    return root == NULL;
+} // end isEmpty()
+
+/**---------------------- makeEmpty() -----------------------------------------
+ * Deallocates memory for a tree, without a stack: left children are rotated
+ * up until the smallest node is the root, which is released in turn.
+ * @pre None.
+ * @post This tree is empty.
+ */
+template <class Key, class Compare, class Alloc>
+void SearchTree<Key, Compare, Alloc>::makeEmpty(void)
+{
+    while (root != NULL)
+    {
+        Node *treePtr = root;
+
+        if (treePtr->left != NULL)
+        {
+            root = treePtr->left;           // rotate right at the root
+            treePtr->left = root->right;
+            root->right = treePtr;
+        } // end if (treePtr->left != NULL)
+        else
+        {
+            root = treePtr->right;
+            freeNode(treePtr);
+        } // end else
+    } // end while (root != NULL)
+
+    nodeCount = 0;
+} // end makeEmpty()
+
+/**---------------------- = Assignment Operator -------------------------------
+ * Copies the contents of rhs into this tree. Any contents of this tree are
+ * removed beforehand, and this tree takes on the options of rhs.
+ * @param rhs  The right-hand tree to be copied.
+ * @pre There is sufficient memory to allocate a copy of rhs.
+ * @post This tree is a structural copy of rhs; rhs remains unchanged.
+ * @return This binary search tree, which is equivalent to rhs.
+ */
+template <class Key, class Compare, class Alloc>
+SearchTree<Key, Compare, Alloc>&
+SearchTree<Key, Compare, Alloc>::operator=(const SearchTree& rhs)
+{
+    if (this != &rhs)
+    {
+        makeEmpty();
+        options = rhs.options;
+        less = rhs.less;
+        copyTree(rhs.root);
+    } // end if (this != &rhs)
+
+    return *this;
+} // end operator=(const SearchTree&)
+
+/**---------------------- == Equality Operator --------------------------------
+ * Compares this binary search tree with another for equality. Equality means
+ * that both trees contain the same keys and have the same structure.
+ * @param rhs  The right-hand tree to be compared.
+ * @pre None.
+ * @post Both binary search trees remain unchanged.
+ * @return true if both trees have identical structures and content; false,
+ *         otherwise.
+ */
+template <class Key, class Compare, class Alloc>
+bool SearchTree<Key, Compare, Alloc>::operator==(const SearchTree& rhs) const
+{
+    vector<pair<const Node*, const Node*> > pending;    // pairs to compare
+    bool same = (nodeCount == rhs.nodeCount);
+
+    pending.push_back(make_pair(root, rhs.root));
+
+    while (same && !pending.empty())
+    {
+        const Node *lhsPtr = pending.back().first;
+        const Node *rhsPtr = pending.back().second;
+
+        pending.pop_back();
+
+        if (lhsPtr == NULL || rhsPtr == NULL)
+        {
+            same = (lhsPtr == rhsPtr);
+        } // end if (lhsPtr == NULL || rhsPtr == NULL)
+        else
+        {
+            same = (order(lhsPtr->data, rhsPtr->data) == 0);
+            pending.push_back(make_pair(lhsPtr->right, rhsPtr->right));
+            pending.push_back(make_pair(lhsPtr->left, rhsPtr->left));
+        } // end else
+    } // end while (same && !pending.empty())
+
+    return same;
+} // end operator==(const SearchTree&)
+
+/**---------------------- != Inequality Operator ------------------------------
+ * Compares this binary search tree with another for inequality.
+ * @param rhs  The right-hand tree to be compared.
+ * @pre None.
+ * @post Both binary search trees remain unchanged.
+ * @return false if both trees have identical structures and content; true,
+ *         otherwise.
+ */
+template <class Key, class Compare, class Alloc>
+bool SearchTree<Key, Compare, Alloc>::operator!=(const SearchTree& rhs) const
+{
+    return !(*this == rhs);
+} // end operator!=(const SearchTree&)
+
+/**---------------------- insert() --------------------------------------------
+ * Inserts a copy of a key into a binary search tree, unless it already holds
+ * an equal key. A BALANCED tree is rebalanced on the way back up the path.
+ * @param newItem  The key to be inserted.
+ * @pre None.
+ * @post If newItem was not in this tree, a copy of it is.
+ * @return true if the key was inserted; false if it was already in this tree
+ *         or memory could not be allocated.
+ */
+template <class Key, class Compare, class Alloc>
+bool SearchTree<Key, Compare, Alloc>::insert(const Key& newItem)
+{
+    return insertItem(newItem);
+} // end insert(const Key&)
+
+/**---------------------- insert() --------------------------------------------
+ * Inserts a key into a binary search tree by moving it into a new node,
+ * unless the tree already holds an equal key. A BALANCED tree is rebalanced
+ * on the way back up the path.
+ * @param newItem  The key to be inserted.
+ * @pre None.
+ * @post If newItem was not in this tree, it has been moved into it;
+ *       otherwise, newItem remains unchanged.
+ * @return true if the key was inserted; false if it was already in this tree
+ *         or memory could not be allocated.
+ */
+template <class Key, class Compare, class Alloc>
+bool SearchTree<Key, Compare, Alloc>::insert(Key&& newItem)
+{
+    return insertItem(std::move(newItem));
+} // end insert(Key&&)
+
+/**---------------------- retrieve() ------------------------------------------
+ * Locates the key in a tree equal to a given key.
+ * @param searchItem  The key to be located.
+ * @param dataItem  A container for a pointer to the found key.
+ * @pre None.
+ * @post If the key was found, dataItem points to it; otherwise, dataItem is
+ *       NULL. This tree remains unchanged.
+ * @return true if searchItem matches a key in the tree; false, otherwise.
+ */
+template <class Key, class Compare, class Alloc>
+bool SearchTree<Key, Compare, Alloc>::retrieve(const Key& searchItem,
+                                               const Key *& dataItem) const
+{
+    const Node *treePtr = root;
+
+    dataItem = NULL;
+
+    while (treePtr != NULL && dataItem == NULL)
+    {
+        int direction = order(searchItem, treePtr->data);
+
+        if (direction < 0)
+        {
+            treePtr = treePtr->left;
+        } // end if (direction < 0)
+        else if (direction > 0)
+        {
+            treePtr = treePtr->right;
+        } // end else if (direction > 0)
+        else
+        {
+            dataItem = &treePtr->data;
+        } // end else
+    } // end while (treePtr != NULL && dataItem == NULL)
+
+    return dataItem != NULL;
+} // end retrieve(const Key&, const Key*&)
+
+/**---------------------- getDepth() ------------------------------------------
+ * Determines the depth of a key in a tree by following its comparison path.
+ * @param searchItem  The key to locate in the tree.
+ * @pre None.
+ * @post This tree remains unchanged.
+ * @return The depth of the node holding searchItem, where the root is at
+ *         depth 1, if found; 0, otherwise.
+ */
+template <class Key, class Compare, class Alloc>
+int SearchTree<Key, Compare, Alloc>::getDepth(const Key& searchItem) const
+{
+    const Node *treePtr = root;
+    int         level = 0;
+    int         depth = 0;
+
+    while (treePtr != NULL && level == 0)
+    {
+        int direction = order(searchItem, treePtr->data);
+
+        ++depth;
+
+        if (direction < 0)
+        {
+            treePtr = treePtr->left;
+        } // end if (direction < 0)
+        else if (direction > 0)
+        {
+            treePtr = treePtr->right;
+        } // end else if (direction > 0)
+        else
+        {
+            level = depth;
+        } // end else
+    } // end while (treePtr != NULL && level == 0)
+
+    return level;
+} // end getDepth(const Key&)
+
+/**---------------------- getHeight() -----------------------------------------
+ * Determines the height of a binary search tree from the height stored in its
+ * root. An empty tree has a height of 0 and a tree with only a root has a
+ * height of 1.
+ * @pre None.
+ * @post This tree remains unchanged.
+ * @return The number of nodes on the longest path from the root to a leaf.
+ */
+template <class Key, class Compare, class Alloc>
+int SearchTree<Key, Compare, Alloc>::getHeight(void) const
+{
+    return heightOf(root);
+} // end getHeight()
+
+/**---------------------- size() ----------------------------------------------
+ * Determines the number of keys in a binary search tree.
+ * @pre None.
+ * @post This tree remains unchanged.
+ * @return The number of keys in this tree.
+ */
+template <class Key, class Compare, class Alloc>
+int SearchTree<Key, Compare, Alloc>::size(void) const
+{
+    return nodeCount;
+} // end size()
+
+/**---------------------- forEach() -------------------------------------------
+ * Visits every key of the tree in sorted order.
+ * @param visit  A function or function object taking a const Key&.
+ * @pre visit does not change this tree.
+ * @post visit has been called once for each key in the tree, in sorted
+ *       order; this tree remains unchanged.
+ */
+template <class Key, class Compare, class Alloc>
+template <class Visitor>
+void SearchTree<Key, Compare, Alloc>::forEach(Visitor visit) const
+{
+    vector<const Node*> pending;    // ancestors whose keys are still to come
+    const Node         *treePtr = root;
+
+    while (treePtr != NULL || !pending.empty())
+    {
+        if (treePtr != NULL)
+        {
+            pending.push_back(treePtr);
+            treePtr = treePtr->left;
+        } // end if (treePtr != NULL)
+        else
+        {
+            treePtr = pending.back();
+            pending.pop_back();
+            visit(treePtr->data);
+            treePtr = treePtr->right;
+        } // end else
+    } // end while (treePtr != NULL || !pending.empty())
+} // end forEach(Visitor)
+
+/**---------------------- bstreeToArray() -------------------------------------
+ * Moves the keys of this tree to the end of a growable buffer, in sorted
+ * order. The tree is left empty.
+ * @param target  The buffer to which to append the keys of this tree.
+ * @pre None.
+ * @post target ends with every key found in this tree, in sorted order;
+ *       this tree is empty.
+ * @return The number of keys appended to target.
+ */
+template <class Key, class Compare, class Alloc>
+int SearchTree<Key, Compare, Alloc>::bstreeToArray(vector<Key>& target)
+{
+    int count = nodeCount;
+
+    target.reserve(target.size() + nodeCount);
+
+    // makeEmpty() releases the nodes in sorted order, moving each key first
+    while (root != NULL)
+    {
+        Node *treePtr = root;
+
+        if (treePtr->left != NULL)
+        {
+            root = treePtr->left;           // rotate right at the root
+            treePtr->left = root->right;
+            root->right = treePtr;
+        } // end if (treePtr->left != NULL)
+        else
+        {
+            root = treePtr->right;
+            target.push_back(std::move(treePtr->data));
+            freeNode(treePtr);
+        } // end else
+    } // end while (root != NULL)
+
+    nodeCount = 0;
+    return count;
+} // end bstreeToArray(vector<Key>&)
+
+/**---------------------- arrayToBSTree() -------------------------------------
+ * Populates this tree from a buffer of sorted keys, moving each into a node.
+ * Any contents of this tree are removed beforehand. The new tree is balanced
+ * by linking the middle key of each segment of the buffer as the root of its
+ * subtree.
+ * @param source  The keys from which to populate this tree.
+ * @pre source is sorted in ascending order and holds no equal keys.
+ * @post This tree is balanced and holds every key that was in source, unless
+ *       memory ran out, in which case it holds those linked so far; source
+ *       is empty.
+ * @return The number of keys in this tree.
+ */
+template <class Key, class Compare, class Alloc>
+int SearchTree<Key, Compare, Alloc>::arrayToBSTree(vector<Key>& source)
+{
+    makeEmpty();
+
+    try
+    {
+        buildHelper(source, 0, source.size(), root);
+    }
+    catch (bad_alloc e)
+    {
+        cerr << "Could not allocate memory for tree: "
+             << "arrayToBSTree() failed." << endl;
+    } // end try
+
+    source.clear();
+    return nodeCount;
+} // end arrayToBSTree(vector<Key>&)
+
+/**---------------------- order() ---------------------------------------------
+ * Orders two keys by the comparator of the tree.
+ * @param lhs  The key on the left of the comparison.
+ * @param rhs  The key on the right of the comparison.
+ * @pre None.
+ * @post This tree remains unchanged.
+ * @return <0 if lhs is less than rhs; 0 if they are equal; >0 otherwise.
+ */
+template <class Key, class Compare, class Alloc>
+inline int SearchTree<Key, Compare, Alloc>::order(const Key& lhs,
+                                                  const Key& rhs) const
+{
+    return KeyOrder<Key, Compare>::compare(less, lhs, rhs);
+} // end order(const Key&, const Key&)
+
+/**---------------------- makeNode() ------------------------------------------
+ * Allocates a node from the allocator of the tree and constructs its key.
+ * @param item  The key, or the value from which to construct it.
+ * @pre None.
+ * @post A node holding item exists, with no children.
+ * @return A pointer to the new node.
+ * @throw bad_alloc if memory could not be allocated, or whatever the
+ *        constructor of Key throws; nothing is allocated then.
+ */
+template <class Key, class Compare, class Alloc>
+template <class Item>
+typename SearchTree<Key, Compare, Alloc>::Node*
+SearchTree<Key, Compare, Alloc>::makeNode(Item&& item)
+{
+    Node *treePtr = NodeTraits::allocate(alloc, 1);
+
+    try
+    {
+        NodeTraits::construct(alloc, treePtr, std::forward<Item>(item));
+    }
+    catch (...)
+    {
+        NodeTraits::deallocate(alloc, treePtr, 1);
+        throw;
+    } // end try
+
+    return treePtr;
+} // end makeNode(Item&&)
+
+/**---------------------- freeNode() ------------------------------------------
+ * Destroys the key of a node and returns the node to the allocator.
+ * @param treePtr  The node to be released.
+ * @pre treePtr was allocated by makeNode() of this tree.
+ * @post The node is released.
+ */
+template <class Key, class Compare, class Alloc>
+void SearchTree<Key, Compare, Alloc>::freeNode(Node *treePtr)
+{
+    NodeTraits::destroy(alloc, treePtr);
+    NodeTraits::deallocate(alloc, treePtr, 1);
+} // end freeNode(Node*)
+
+/**---------------------- insertItem() ----------------------------------------
+ * Links a new node holding newItem at the end of its comparison path,
+ * recording the links followed so that the path may be fixed up without
+ * recursion: heights are updated, and a BALANCED tree rebalanced, from the
+ * new leaf up until a subtree is no taller than it was.
+ * @param newItem  The key to be inserted.
+ * @pre None.
+ * @post If newItem was not in this tree, a node holding it is; stored heights
+ *       are current.
+ * @return true if the key was inserted; false otherwise.
+ */
+template <class Key, class Compare, class Alloc>
+template <class Item>
+bool SearchTree<Key, Compare, Alloc>::insertItem(Item&& newItem)
+{
+    Node **local[PATH_LIMIT];       // links followed from root, if few enough
+    vector<Node**> spill;           // links followed, for a deeper tree
+    Node ***path = local;
+    int     length = 0;
+    Node  **link = &root;           // Link at which newItem belongs
+    bool    success = true;
+
+    try
+    {
+        // a new leaf can be no deeper than one below the current height
+        if (heightOf(root) > PATH_LIMIT)
+        {
+            spill.resize(heightOf(root));
+            path = &spill[0];
+        } // end if (heightOf(root) > PATH_LIMIT)
+    }
+    catch (bad_alloc e)
+    {
+        cerr << "Could not allocate memory for path: "
+             << "insert() failed." << endl;
+        success = false;
+    } // end try
+
+    while (*link != NULL && success)
+    {
+        int direction = order(newItem, (*link)->data);
+
+        if (direction < 0)
+        {
+            path[length++] = link;
+            link = &(*link)->left;
+        } // end if (direction < 0)
+        else if (direction > 0)
+        {
+            path[length++] = link;
+            link = &(*link)->right;
+        } // end else if (direction > 0)
+        else
+        {
+            success = false;        // duplicate items are not inserted
+        } // end else
+    } // end while (*link != NULL && success)
+
+    if (success)
+    {
+        try
+        {
+            *link = makeNode(std::forward<Item>(newItem));
+            ++nodeCount;
+        }
+        catch (bad_alloc e)
+        {
+            cerr << "Could not allocate memory for node: "
+                 << "insert() failed." << endl;
+            success = false;
+        } // end try
+    } // end if (success)
+
+    // fix up the path back to the root; once a subtree is no taller than it
+    // was, which a rotation after an insert always leaves it, nor are those
+    // above it, since nodes store nothing else
+    while (success && length > 0)
+    {
+        Node *& ancestor = *path[--length];
+        int     before = ancestor->height;
+
+        if (options & BALANCED)
+        {
+            restoreBalance(ancestor);
+        }
+        else
+        {
+            refresh(ancestor);
+        } // end if (options & BALANCED)
+
+        if (ancestor->height == before)
+        {
+            length = 0;
+        } // end if (ancestor->height == before)
+    } // end while (success && length > 0)
+
+    return success;
+} // end insertItem(Item&&)
+
+/**---------------------- heightOf() ------------------------------------------
+ * Determines the height of a subtree from the height stored in its root.
+ * @param treePtr  The root of the subtree to measure; may be NULL.
+ * @pre Heights stored in the subtree are current.
+ * @post The subtree remains unchanged.
+ * @return The height of the subtree rooted at treePtr; 0 if it is empty.
+ */
+template <class Key, class Compare, class Alloc>
+inline int SearchTree<Key, Compare, Alloc>::heightOf(const Node *treePtr)
+{
+    return (treePtr == NULL ? 0 : treePtr->height);
+} // end heightOf(const Node*)
+
+/**---------------------- refresh() -------------------------------------------
+ * Recomputes the height stored in a node from those of its children.
+ * @param treePtr  The node to update.
+ * @pre treePtr is not NULL; the heights of both children are current.
+ * @post The height stored in treePtr is current.
+ */
+template <class Key, class Compare, class Alloc>
+inline void SearchTree<Key, Compare, Alloc>::refresh(Node *treePtr)
+{
+    int leftHeight  = heightOf(treePtr->left);
+    int rightHeight = heightOf(treePtr->right);
+
+    treePtr->height = 1 + (leftHeight > rightHeight ? leftHeight
+                                                    : rightHeight);
+} // end refresh(Node*)
+
+/**---------------------- rotateLeft() ----------------------------------------
+ * Rotates a subtree to the left, so that the right child of treePtr becomes
+ * the root of the subtree.
+ * @param treePtr  The root of the subtree to rotate.
+ * @pre treePtr and its right child are not NULL.
+ * @post treePtr points to the former right child, which now holds the former
+ *       root as its left child; stored heights are current.
+ */
+template <class Key, class Compare, class Alloc>
+void SearchTree<Key, Compare, Alloc>::rotateLeft(Node *& treePtr)
+{
+    Node *pivot = treePtr->right;
+
+    treePtr->right = pivot->left;
+    pivot->left = treePtr;
+    refresh(treePtr);       // old root is now below pivot
+    refresh(pivot);
+    treePtr = pivot;
+} // end rotateLeft(Node*&)
+
+/**---------------------- rotateRight() ---------------------------------------
+ * Rotates a subtree to the right, so that the left child of treePtr becomes
+ * the root of the subtree.
+ * @param treePtr  The root of the subtree to rotate.
+ * @pre treePtr and its left child are not NULL.
+ * @post treePtr points to the former left child, which now holds the former
+ *       root as its right child; stored heights are current.
+ */
+template <class Key, class Compare, class Alloc>
+void SearchTree<Key, Compare, Alloc>::rotateRight(Node *& treePtr)
+{
+    Node *pivot = treePtr->left;
+
+    treePtr->left = pivot->right;
+    pivot->right = treePtr;
+    refresh(treePtr);       // old root is now below pivot
+    refresh(pivot);
+    treePtr = pivot;
+} // end rotateRight(Node*&)
+
+/**---------------------- restoreBalance() ------------------------------------
+ * Restores the AVL property at the root of a subtree whose children differ in
+ * height by at most two, using a single or double rotation.
+ * @param treePtr  The root of the subtree to balance.
+ * @pre treePtr is not NULL; both subtrees of treePtr are AVL balanced.
+ * @post The subtree rooted at treePtr is AVL balanced; stored heights are
+ *       current.
+ */
+template <class Key, class Compare, class Alloc>
+void SearchTree<Key, Compare, Alloc>::restoreBalance(Node *& treePtr)
+{
+    int balance = heightOf(treePtr->left) - heightOf(treePtr->right);
+
+    if (balance > 1)                // left side too tall
+    {
+        if (heightOf(treePtr->left->left) < heightOf(treePtr->left->right))
+        {
+            rotateLeft(treePtr->left);      // left-right case
+        } // end if (heightOf(treePtr->left->left) < ...)
+
+        rotateRight(treePtr);
+    }
+    else if (balance < -1)          // right side too tall
+    {
+        if (heightOf(treePtr->right->right) < heightOf(treePtr->right->left))
+        {
+            rotateRight(treePtr->right);    // right-left case
+        } // end if (heightOf(treePtr->right->right) < ...)
+
+        rotateLeft(treePtr);
+    }
+    else
+    {
+        refresh(treePtr);           // already balanced; update height only
+    } // end if (balance > 1)
+} // end restoreBalance(Node*&)
+
+/**---------------------- copyTree() ------------------------------------------
+ * Copies the nodes of another tree into this empty one, keeping the pending
+ * links on an explicit stack.
+ * @param source  The root of the tree to be copied.
+ * @pre This tree is empty.
+ * @post This tree is a structural copy of source, or, if memory ran out,
+ *       empty.
+ */
+template <class Key, class Compare, class Alloc>
+void SearchTree<Key, Compare, Alloc>::copyTree(const Node *source)
+{
+    vector<pair<const Node*, Node**> > pending;     // nodes and their links
+
+    try
+    {
+        if (source != NULL)
+        {
+            pending.push_back(make_pair(source, &root));
+        } // end if (source != NULL)
+
+        while (!pending.empty())
+        {
+            const Node *treePtr = pending.back().first;
+            Node      **link = pending.back().second;
+
+            pending.pop_back();
+            *link = makeNode(treePtr->data);
+            (*link)->height = treePtr->height;
+            ++nodeCount;
+
+            if (treePtr->right != NULL)
+            {
+                pending.push_back(make_pair(treePtr->right, &(*link)->right));
+            } // end if (treePtr->right != NULL)
+
+            if (treePtr->left != NULL)
+            {
+                pending.push_back(make_pair(treePtr->left, &(*link)->left));
+            } // end if (treePtr->left != NULL)
+        } // end while (!pending.empty())
+    }
+    catch (bad_alloc e)
+    {
+        makeEmpty();
+        cerr << "Could not allocate memory for tree: "
+             << "copyTree() failed." << endl;
+    } // end try
+} // end copyTree(const Node*)
+
+/**---------------------- buildHelper() ---------------------------------------
+ * Links the middle key of a segment of a sorted buffer, then the middles of
+ * the segments on either side of it as its children.
+ * @param source  The sorted keys.
+ * @param first  The index of the first key of the segment.
+ * @param last  The index after the last key of the segment.
+ * @param link  The link at which to place the root of the segment.
+ * @pre link is NULL; first <= last.
+ * @post The keys of the segment are moved into a balanced subtree at link;
+ *       stored heights are current.
+ * @throw bad_alloc if memory could not be allocated; the nodes linked so
+ *        far remain linked.
+ */
+template <class Key, class Compare, class Alloc>
+void SearchTree<Key, Compare, Alloc>::buildHelper(vector<Key>& source,
+                                                  size_t first, size_t last,
+                                                  Node *& link)
+{
+    if (first < last)
+    {
+        size_t middle = first + (last - first) / 2;
+
+        link = makeNode(std::move(source[middle]));
+        ++nodeCount;
+        buildHelper(source, first, middle, link->left);
+        buildHelper(source, middle + 1, last, link->right);
+        refresh(link);
+    } // end if (first < last)
+} // end buildHelper(vector<Key>&, size_t, size_t, Node*&)
+
+
+#endif	/* _SEARCHTREE_H */
@@ -0,0 +1,269 @@
+/*
+ * @file    sharedbintree.h
+ * @brief   This class is a BinTree that may be used by many threads at once.
+ *          Queries take a shared lock, so any number of readers proceed in
+ *          parallel, while operations that change the tree take an exclusive
+ *          lock and wait for the readers to finish. Since no pointer into the
+ *          tree may outlive a lock, items are handed out by value, and
+ *          iteration is done by visiting each item while the lock is held.
+ * @author  Brendan Sweeney, SID 1161836
+ * @date    October 14, 2026
+ */
+
+#ifndef _SHAREDBINTREE_H
+#define	_SHAREDBINTREE_H
+
+#include <mutex>            // for unique_lock
+#include <shared_mutex>     // for shared_mutex and shared_lock
+#include <vector>           // buffers for bstreeToArray()
+
+#include "bintree.h"
+
+
+class SharedBinTree
+{
+/**---------------------- << Stream Out Operator ------------------------------
+ * Writes the contents of a tree to the provided ostream, in sorted order,
+ * space separated on a single line, under a shared lock.
+ * @param output  The ostream to which to write the tree's contents.
+ * @param source  The tree whose contents are to be written.
+ * @pre The ostream, output, is writable.
+ * @post The ostream, output, contains a string representing the contents of
+ *       the tree, in sorted order; the tree remains unchanged.
+ * @return A reference to the provided ostream, with the contents of the tree
+ *         appended to it.
+ */
+    friend ostream& operator<<(ostream& output, const SharedBinTree& source);
+
+public:
+
+/**---------------------- Default Constructor ---------------------------------
+ * Creates an empty tree.
+ * @pre None.
+ * @post An empty, unbalanced binary search tree exists.
+ */
+    SharedBinTree();
+
+/**---------------------- Option Constructor ----------------------------------
+ * Creates an empty tree which behaves according to the provided options.
+ * @param options  A bitwise or of BinTree::Option values.
+ * @pre None.
+ * @post An empty binary search tree exists, which behaves as a BinTree
+ *       constructed with options would.
+ */
+    explicit SharedBinTree(int options);
+
+/**---------------------- isEmpty() -------------------------------------------
+ * Determines whether the tree is empty, under a shared lock.
+ * @pre None.
+ * @post This tree remains unchanged.
+ * @return true if the tree is empty; false, otherwise.
+ */
+    bool isEmpty(void) const;
+
+/**---------------------- makeEmpty() -----------------------------------------
+ * Deallocates memory for the tree, under an exclusive lock.
+ * @pre None.
+ * @post This tree is now empty.
+ */
+    void makeEmpty(void);
+
+/**---------------------- insert() --------------------------------------------
+ * Inserts an item into the tree, under an exclusive lock, taking ownership of
+ * newItem if it is inserted.
+ * @param newItem  An object to be added to the tree.
+ * @pre NodeData provides the compare() method.
+ * @post newItem is in its proper position in the tree.
+ * @return true if newItem could be inserted in the tree; false if newItem
+ *         already existed in the tree.
+ */
+    bool insert(NodeData *newItem);
+
+/**---------------------- insert() --------------------------------------------
+ * Inserts an item into the tree by moving its value, under an exclusive lock.
+ * @param newItem  An object whose value is to be added to the tree.
+ * @pre NodeData provides the compare() method.
+ * @post The former value of newItem is in its proper position in the tree,
+ *       and newItem is empty; if the insertion failed, newItem is unchanged.
+ * @return true if newItem could be inserted in the tree; false if newItem
+ *         already existed in the tree.
+ */
+    bool insert(NodeData&& newItem);
+
+/**---------------------- insert() --------------------------------------------
+ * Inserts a copy of an item into the tree, under an exclusive lock.
+ * @param newItem  The item whose value is to be added to the tree.
+ * @pre NodeData provides the compare() method.
+ * @post A copy of newItem is in its proper position in the tree; newItem
+ *       remains unchanged.
+ * @return true if newItem could be inserted in the tree; false if newItem
+ *         already existed in the tree.
+ */
+    bool insert(const NodeData& newItem);
+
+/**---------------------- remove() --------------------------------------------
+ * Removes an item from the tree, under an exclusive lock.
+ * @param oldItem  An object equal to the item to be removed.
+ * @pre NodeData provides the compare() method.
+ * @post No item equal to oldItem is in the tree.
+ * @return true if oldItem was found and removed; false, otherwise.
+ */
+    bool remove(const NodeData& oldItem);
+
+/**---------------------- retrieve() ------------------------------------------
+ * Retrieves a copy of a given item from the tree, under a shared lock. The
+ * item is copied because a pointer into the tree would not be safe to use
+ * once the lock is released.
+ * @param searchItem  The item to be located.
+ * @param dataItem  A container for a copy of the found item.
+ * @pre NodeData provides the compare() method.
+ * @post If the retrieval was successful, dataItem is equal to the retrieved
+ *       item; this tree remains unchanged.
+ * @return true if searchItem matches an item in the tree; false if searchItem
+ *         could not be found.
+ */
+    bool retrieve(const NodeData& searchItem, NodeData& dataItem) const;
+
+/**---------------------- rank() ----------------------------------------------
+ * Determines how many items of the tree are less than a key, under a shared
+ * lock.
+ * @param searchItem  The key to compare items with.
+ * @pre NodeData provides the compare() method.
+ * @post This tree remains unchanged.
+ * @return The number of items less than searchItem, from 0 to size().
+ */
+    int rank(const NodeData& searchItem) const;
+
+/**---------------------- select() --------------------------------------------
+ * Retrieves a copy of the item at a position in sorted order, under a shared
+ * lock. The item is copied for the reason retrieve() copies it.
+ * @param index  The position of the item, where the smallest is at 0.
+ * @param dataItem  A container for a copy of the item.
+ * @pre None.
+ * @post If index is from 0 to size() - 1, dataItem is equal to the item with
+ *       index smaller items; this tree remains unchanged.
+ * @return true if there is an item at index; false, otherwise.
+ */
+    bool select(int index, NodeData& dataItem) const;
+
+/**---------------------- displaySideways() -----------------------------------
+ * Displays the tree sideways, under a shared lock.
+ * @pre None.
+ * @post The tree is written to cout in sideways format; it remains unchanged.
+ */
+    void displaySideways(void) const;
+
+/**---------------------- getDepth() ------------------------------------------
+ * Determines the depth of a node in the tree, under a shared lock.
+ * @param searchItem  The item to locate in the tree.
+ * @pre NodeData provides the compare() method.
+ * @post This tree remains unchanged.
+ * @return The depth of the node containing searchItem, if found, where the
+ *         root is at depth 1; 0, otherwise.
+ */
+    int getDepth(const NodeData& searchItem) const;
+
+/**---------------------- getHeight() -----------------------------------------
+ * Determines the height of the tree, under a shared lock.
+ * @pre None.
+ * @post This tree remains unchanged.
+ * @return The number of nodes on the longest path from the root to a leaf.
+ */
+    int getHeight(void) const;
+
+/**---------------------- size() ----------------------------------------------
+ * Determines the number of items in the tree, under a shared lock.
+ * @pre None.
+ * @post This tree remains unchanged.
+ * @return The number of items in this tree.
+ */
+    int size(void) const;
+
+/**---------------------- forEach() -------------------------------------------
+ * Visits every item of the tree in sorted order, under a shared lock which is
+ * held until the last item has been visited. The visitor must not use this
+ * tree, or it may deadlock while a writer is waiting.
+ * @param visit  A function or function object taking a const NodeData&.
+ * @pre None.
+ * @post visit has been called once for each item in the tree, in sorted
+ *       order; this tree remains unchanged.
+ */
+    template <class Visitor>
+    void forEach(Visitor visit) const
+    {
+        shared_lock<shared_mutex> guard(lock);
+
+        for (BinTree::const_iterator it = tree.begin(); it != tree.end(); ++it)
+        {
+            visit(*it);
+        } // end for (BinTree::const_iterator it = tree.begin())
+    } // end forEach(Visitor)
+
+/**---------------------- rebalance() -----------------------------------------
+ * Rebalances the tree in place, under an exclusive lock.
+ * @pre None.
+ * @post This tree holds the same items as before, with minimal height.
+ */
+    void rebalance(void);
+
+/**---------------------- bstreeToArray() -------------------------------------
+ * Appends the NodeData* from the tree to a growable buffer, in sorted order,
+ * under an exclusive lock. The tree is left empty.
+ * @param target  The buffer to which to append the NodeData* from this tree.
+ * @pre None.
+ * @post target ends with every element found in this tree, in sorted order;
+ *       this tree is empty.
+ * @return The number of elements appended to target.
+ */
+    int bstreeToArray(vector<NodeData*>& target);
+
+/**---------------------- arrayToBSTree() -------------------------------------
+ * Populates the tree from an array of sorted NodeData*, terminated by the
+ * first NULL element, under an exclusive lock. Any contents of the tree are
+ * removed beforehand.
+ * @param source[]  The array from which to populate this tree.
+ * @pre source[] is sorted in ascending order and has a NULL element after the
+ *      last item.
+ * @post This tree is balanced and contains all NodeData* that were contained
+ *       in source[]; all elements of source[] are now NULL.
+ */
+    void arrayToBSTree(NodeData* source[]);
+
+/**---------------------- arrayToBSTree() -------------------------------------
+ * Populates the tree from an array of sorted NodeData* of known length, under
+ * an exclusive lock. Any contents of the tree are removed beforehand.
+ * @param source[]  The array from which to populate this tree.
+ * @param count  The number of elements in source[].
+ * @pre source[] holds count distinct, non-NULL pointers.
+ * @post This tree is balanced and contains all NodeData* that were contained
+ *       in source[]; all elements of source[] are now NULL.
+ * @return The number of items in this tree.
+ */
+    int arrayToBSTree(NodeData* source[], int count);
+
+/**---------------------- build() ---------------------------------------------
+ * Populates the tree from an array of NodeData*, sorted or not, taking
+ * ownership of them, under an exclusive lock. Any contents of the tree are
+ * removed beforehand.
+ * @param source[]  The array from which to populate this tree.
+ * @param count  The number of elements in source[].
+ * @pre source[] holds count distinct, non-NULL pointers.
+ * @post This tree is balanced and holds one item for every distinct value in
+ *       source[]; every element of source[] is NULL.
+ * @return The number of items in this tree.
+ */
+    int build(NodeData *source[], int count);
+
+private:
+
+    mutable shared_mutex lock;  // Shared by readers; exclusive to writers
+    BinTree tree;               // The tree being guarded
+
+    // a lock cannot be copied, and a copy would need one of its own
+    SharedBinTree(const SharedBinTree&);
+    SharedBinTree& operator=(const SharedBinTree&);
+
+}; // end SharedBinTree
+
+
+#endif	/* _SHAREDBINTREE_H */
@@ -0,0 +1,527 @@
+/*
+ * @file    snapshot.cpp
+ * @brief   This class serves read-only searches from a file written by
+ *          BinTree::save(), without loading it into a tree. The file is
+ *          mapped into memory where the system supports it, or read whole
+ *          otherwise, and searched in place. A snapshot file holds a header,
+ *          the keys in sorted order, each prefixed by its length, and,
+ *          optionally, the offsets of the keys in Eytzinger order (the layout
+ *          of a frozen BinTree), which is searched without branching. Without
+ *          that section, an array of offsets in sorted order is built when
+ *          the file is opened, and searched by bisection. Every key and
+ *          layout offset is checked when the file is opened, so a damaged
+ *          file is refused rather than read past its end.
+ * @author  Brendan Sweeney, SID 1161836
+ * @date    October 14, 2026
+ */
+
+#include <cstdio>           // for fopen and fread, when not mapping
+#include <cstring>          // for memcmp and memcpy
+#include <iostream>         // for cerr
+#include <new>              // for bad_alloc
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>          // for open
+#include <sys/mman.h>       // for mmap
+#include <sys/stat.h>       // for fstat
+#include <unistd.h>         // for close
+#define SNAPSHOT_MMAP 1
+#endif
+
+#include "snapshot.h"
+
+using namespace std;
+
+
+/**---------------------- << Stream Out Operator ------------------------------
+ * Writes the contents of a snapshot to the provided ostream, in sorted order,
+ * space separated on a single line, as a BinTree holding them would.
+ * @param output  The ostream to which to write the snapshot's contents.
+ * @param source  The snapshot whose contents are to be written.
+ * @pre The ostream, output, is writable.
+ * @post The ostream, output, contains a string representing the contents of
+ *       the snapshot, in sorted order; the snapshot remains unchanged.
+ * @return A reference to the provided ostream, with the contents of the
+ *         snapshot appended to it.
+ */
+ostream& operator<<(ostream& output, const TreeSnapshot& source)
+{
+    for (TreeSnapshot::const_iterator it = source.begin(); it != source.end();
+                                      ++it)
+    {
+        output << ' ' << *it;
+    } // end for (TreeSnapshot::const_iterator it = source.begin())
+
+    output << endl;
+    return output;
+} // end operator<<
+
+/**---------------------- operator*() -----------------------------------------
+ * Reads the key at the position of an iterator.
+ * @pre The iterator is not at end().
+ * @post The iterator remains unchanged.
+ * @return A view of the key's characters, within the file.
+ */
+string_view TreeSnapshot::const_iterator::operator*() const
+{
+    uint32_t size;
+
+    memcpy(&size, cursor, sizeof(size));
+    return string_view(cursor + sizeof(size), size);
+} // end operator*()
+
+/**---------------------- operator++() ----------------------------------------
+ * Advances an iterator to the next key, which follows the current one.
+ * @pre The iterator is not at end().
+ * @post The iterator is at the next larger key, or at end().
+ * @return This iterator, after it is advanced.
+ */
+TreeSnapshot::const_iterator& TreeSnapshot::const_iterator::operator++()
+{
+    uint32_t size;
+
+    memcpy(&size, cursor, sizeof(size));
+    cursor += sizeof(size) + size;
+    return *this;
+} // end operator++()
+
+/**---------------------- operator++(int) -------------------------------------
+ * Advances an iterator to the next key, returning its former position.
+ * @pre The iterator is not at end().
+ * @post The iterator is at the next larger key, or at end().
+ * @return A copy of this iterator, before it was advanced.
+ */
+TreeSnapshot::const_iterator TreeSnapshot::const_iterator::operator++(int)
+{
+    const_iterator previous(*this);
+
+    ++(*this);
+    return previous;
+} // end operator++(int)
+
+
+/**---------------------- Constructor -----------------------------------------
+ * Opens a snapshot file and checks its header. The keys are not read.
+ * @param fileName  The name of a file written by BinTree::save().
+ * @pre None.
+ * @post If the file could be opened and its header describes a snapshot
+ *       that fits within it, isOpen() is true; otherwise, the snapshot is
+ *       empty.
+ */
+TreeSnapshot::TreeSnapshot(const char *fileName)
+    : base(NULL), length(0), mapped(false), layout(NULL), count(0)
+{
+#ifdef SNAPSHOT_MMAP
+    int file = ::open(fileName, O_RDONLY);
+    struct stat status;
+
+    if (file >= 0 && fstat(file, &status) == 0 && status.st_size > 0)
+    {
+        void *memory = mmap(NULL, status.st_size, PROT_READ, MAP_PRIVATE,
+                            file, 0);
+
+        if (memory != MAP_FAILED)
+        {
+            base = static_cast<const char*>(memory);
+            length = status.st_size;
+            mapped = true;
+        } // end if (memory != MAP_FAILED)
+    } // end if (file >= 0 && ...)
+
+    if (file >= 0)
+    {
+        close(file);                // the mapping keeps the file open
+    } // end if (file >= 0)
+#endif
+
+    if (base == NULL)
+    {
+        FILE *input = fopen(fileName, "rb");
+
+        if (input != NULL)
+        {
+            try
+            {
+                char   chunk[1 << 16];
+                size_t got;
+
+                while ((got = fread(chunk, 1, sizeof(chunk), input)) > 0)
+                {
+                    contents.insert(contents.end(), chunk, chunk + got);
+                } // end while ((got = fread(...)) > 0)
+            } // end try
+            catch (bad_alloc e)
+            {
+                contents.clear();
+                cerr << "Could not allocate memory for snapshot: "
+                     << "TreeSnapshot() failed." << endl;
+            } // end catch (bad_alloc e)
+
+            fclose(input);
+        } // end if (input != NULL)
+
+        if (!contents.empty())
+        {
+            base = contents.data();
+            length = contents.size();
+        } // end if (!contents.empty())
+    } // end if (base == NULL)
+
+    if (base != NULL && !open())
+    {
+#ifdef SNAPSHOT_MMAP
+        if (mapped)
+        {
+            munmap(const_cast<char*>(base), length);
+        } // end if (mapped)
+#endif
+
+        base = NULL;
+        length = 0;
+        mapped = false;
+        layout = NULL;
+        vector<char>().swap(contents);
+        vector<uint64_t>().swap(sorted);
+    } // end if (base != NULL && !open())
+} // end constructor(const char*)
+
+/**---------------------- Destructor ------------------------------------------
+ * Releases the file of a snapshot before it is released.
+ * @pre None.
+ * @post The file is unmapped, or its copy is freed.
+ */
+TreeSnapshot::~TreeSnapshot()
+{
+#ifdef SNAPSHOT_MMAP
+    if (mapped)
+    {
+        munmap(const_cast<char*>(base), length);
+    } // end if (mapped)
+#endif
+} // end destructor
+
+/**---------------------- isOpen() --------------------------------------------
+ * Determines whether a snapshot file could be opened.
+ * @pre None.
+ * @post This snapshot remains unchanged.
+ * @return true if the file was opened and is a snapshot; false, otherwise.
+ */
+bool TreeSnapshot::isOpen(void) const
+{
+    return base != NULL;
+} // end isOpen()
+
+/**---------------------- hasLayout() -----------------------------------------
+ * Determines whether a snapshot file holds the Eytzinger layout of its keys.
+ * @pre None.
+ * @post This snapshot remains unchanged.
+ * @return true if searches use the layout saved in the file; false if they
+ *         bisect offsets built when it was opened.
+ */
+bool TreeSnapshot::hasLayout(void) const
+{
+    return layout != NULL;
+} // end hasLayout()
+
+/**---------------------- size() ----------------------------------------------
+ * Determines the number of items in a snapshot.
+ * @pre None.
+ * @post This snapshot remains unchanged.
+ * @return The number of items in this snapshot.
+ */
+int TreeSnapshot::size(void) const
+{
+    return static_cast<int>(count);
+} // end size()
+
+/**---------------------- contains() ------------------------------------------
+ * Determines whether an item is in a snapshot, without copying it.
+ * @param searchItem  The item to be located.
+ * @pre NodeData provides the view() method.
+ * @post This snapshot remains unchanged.
+ * @return true if searchItem matches an item in the snapshot; false,
+ *         otherwise.
+ */
+bool TreeSnapshot::contains(const NodeData& searchItem) const
+{
+    int level;
+
+    return locate(searchItem.view(), level) != 0;
+} // end contains(const NodeData&)
+
+/**---------------------- retrieve() ------------------------------------------
+ * Retrieves a copy of a given item from a snapshot.
+ * @param searchItem  The item to be located.
+ * @param dataItem  A container for a copy of the found item.
+ * @pre NodeData provides the view() method.
+ * @post If the retrieval was successful, dataItem is equal to the retrieved
+ *       item; this snapshot remains unchanged.
+ * @return true if searchItem matches an item in the snapshot; false if
+ *         searchItem could not be found.
+ */
+bool TreeSnapshot::retrieve(const NodeData& searchItem,
+                            NodeData& dataItem) const
+{
+    int      level;
+    uint64_t offset = locate(searchItem.view(), level);
+
+    if (offset != 0)
+    {
+        dataItem = NodeData(keyAt(offset));
+    } // end if (offset != 0)
+
+    return offset != 0;
+} // end retrieve(const NodeData&, NodeData&)
+
+/**---------------------- getDepth() ------------------------------------------
+ * Determines the depth of an item in the implicit tree that a search of a
+ * snapshot walks: the frozen tree, if the layout was saved, or else the tree
+ * of midpoints taken by bisection.
+ * @param searchItem  The item to locate.
+ * @pre NodeData provides the view() method.
+ * @post This snapshot remains unchanged.
+ * @return The depth of searchItem, where the root is at depth 1, if found;
+ *         0, otherwise.
+ */
+int TreeSnapshot::getDepth(const NodeData& searchItem) const
+{
+    int level = 0;
+
+    if (locate(searchItem.view(), level) == 0)
+    {
+        level = 0;
+    } // end if (locate(searchItem.view(), level) == 0)
+
+    return level;
+} // end getDepth(const NodeData&)
+
+/**---------------------- begin() ---------------------------------------------
+ * Locates the smallest item in a snapshot.
+ * @pre None.
+ * @post This snapshot remains unchanged.
+ * @return An iterator at the smallest item; end() if this snapshot is empty.
+ */
+TreeSnapshot::const_iterator TreeSnapshot::begin(void) const
+{
+    const SnapshotHeader *header
+        = reinterpret_cast<const SnapshotHeader*>(base);
+
+    return const_iterator(base != NULL ? base + header->keysOffset : NULL);
+} // end begin()
+
+/**---------------------- end() -----------------------------------------------
+ * Provides the position one past the largest item in a snapshot.
+ * @pre None.
+ * @post This snapshot remains unchanged.
+ * @return An iterator that may not be dereferenced.
+ */
+TreeSnapshot::const_iterator TreeSnapshot::end(void) const
+{
+    const SnapshotHeader *header
+        = reinterpret_cast<const SnapshotHeader*>(base);
+
+    return const_iterator(base != NULL
+                          ? base + header->keysOffset + header->keysBytes
+                          : NULL);
+} // end end()
+
+/**---------------------- keyAt() ---------------------------------------------
+ * Reads the key at an offset in the file.
+ * @param offset  The offset of the key's length prefix.
+ * @pre offset is the offset of a key of this snapshot.
+ * @post This snapshot remains unchanged.
+ * @return A view of the key's characters, within the file.
+ */
+string_view TreeSnapshot::keyAt(uint64_t offset) const
+{
+    return *const_iterator(base + offset);
+} // end keyAt(uint64_t)
+
+/**---------------------- locate() --------------------------------------------
+ * Finds the offset of an item in a snapshot, through the layout if it was
+ * saved, or else by bisecting the sorted offsets.
+ * @param key  The characters of the item to be located.
+ * @param level  A container for the depth at which the item was found.
+ * @pre None.
+ * @post This snapshot remains unchanged.
+ * @return The offset of the matching key; 0 if there is none.
+ */
+uint64_t TreeSnapshot::locate(string_view key, int& level) const
+{
+    uint64_t offset = 0;
+
+    level = 0;
+
+    if (layout != NULL)
+    {
+        size_t index = 1;
+
+        // descend as BinTree::frozenIndex() does, adding each comparison
+        while (index <= count)
+        {
+            index = 2 * index + (keyAt(layout[index]).compare(key) < 0);
+        } // end while (index <= count)
+
+        while (index & 1)
+        {
+            index >>= 1;
+        } // end while (index & 1)
+
+        index >>= 1;
+
+        if (index != 0 && keyAt(layout[index]) == key)
+        {
+            offset = layout[index];
+
+            for (size_t rest = index; rest != 0; rest >>= 1)
+            {
+                ++level;
+            } // end for (size_t rest = index)
+        } // end if (index != 0 && ...)
+    }
+    else
+    {
+        size_t low = 0;
+        size_t high = count;        // one past the last candidate
+
+        while (offset == 0 && low < high)
+        {
+            size_t middle = low + (high - low) / 2;
+            int    order = keyAt(sorted[middle]).compare(key);
+
+            ++level;
+
+            if (order == 0)
+            {
+                offset = sorted[middle];
+            }
+            else if (order < 0)
+            {
+                low = middle + 1;
+            }
+            else
+            {
+                high = middle;
+            } // end if (order == 0)
+        } // end while (offset == 0 && low < high)
+    } // end if (layout != NULL)
+
+    return offset;
+} // end locate(string_view, int&)
+
+/**---------------------- keyFits() -------------------------------------------
+ * Determines whether a key at an offset in the file, with its length prefix,
+ * lies wholly within the keys section, so that it may be read.
+ * @param offset  The offset of the key's length prefix.
+ * @pre The header of the file has been checked to fit within it.
+ * @post This snapshot remains unchanged.
+ * @return true if the prefix and the key both end within the keys section;
+ *         false, otherwise.
+ */
+bool TreeSnapshot::keyFits(uint64_t offset) const
+{
+    const SnapshotHeader *header
+        = reinterpret_cast<const SnapshotHeader*>(base);
+    uint64_t keysEnd = header->keysOffset + header->keysBytes;
+    uint32_t size;
+    bool     fits = offset >= header->keysOffset && offset < keysEnd
+                    && keysEnd - offset >= sizeof(size);
+
+    if (fits)
+    {
+        memcpy(&size, base + offset, sizeof(size));
+        fits = size <= keysEnd - offset - sizeof(size);
+    } // end if (fits)
+
+    return fits;
+} // end keyFits(uint64_t)
+
+/**---------------------- open() ----------------------------------------------
+ * Checks the header of the file in memory, and uses its layout or builds the
+ * sorted offsets. Every key is checked to fit within the keys section, which
+ * it must fill exactly, and every offset of the layout to be that of a key
+ * that fits, so that no search or iteration reads past the file.
+ * @pre base points to length bytes of the file.
+ * @post If the file is a valid snapshot, count is its number of keys, and
+ *       layout or sorted is set; otherwise, the snapshot is empty.
+ * @return true if the file is a valid snapshot; false, otherwise.
+ */
+bool TreeSnapshot::open(void)
+{
+    const SnapshotHeader *header
+        = reinterpret_cast<const SnapshotHeader*>(base);
+    bool valid = length >= sizeof(SnapshotHeader)
+                 && memcmp(header->magic, "BINTREE", 8) == 0
+                 && header->version == SnapshotHeader::VERSION
+                 && header->byteOrder == SnapshotHeader::ORDER_MARK
+                 && header->keysOffset <= length
+                 && header->keysBytes <= length - header->keysOffset
+                 && header->count <= header->keysBytes / sizeof(uint32_t);
+
+    if (valid && header->layoutOffset != 0)
+    {
+        valid = header->layoutOffset % sizeof(uint64_t) == 0
+                && header->layoutOffset <= length
+                && (length - header->layoutOffset) / sizeof(uint64_t)
+                   > header->count;
+
+        if (valid)
+        {
+            layout = reinterpret_cast<const uint64_t*>(
+                         base + header->layoutOffset);
+        } // end if (valid)
+
+        // a search may visit any entry, so each must lead to a whole key
+        for (uint64_t index = 1; valid && index <= header->count; ++index)
+        {
+            valid = keyFits(layout[index]);
+        } // end for (uint64_t index = 1)
+    } // end if (valid && header->layoutOffset != 0)
+
+    if (valid)
+    {
+        try
+        {
+            const_iterator it = begin();
+            uint64_t       keys = 0;
+
+            if (layout == NULL)
+            {
+                sorted.reserve(header->count);
+            } // end if (layout == NULL)
+
+            // iteration reads every key, so each must fit, layout or not;
+            // the last one fitting ends the walk exactly at end()
+            while (valid && it != end())
+            {
+                valid = keyFits(it.cursor - base);
+
+                if (valid)
+                {
+                    if (layout == NULL)
+                    {
+                        sorted.push_back(it.cursor - base);
+                    } // end if (layout == NULL)
+
+                    ++it;
+                    ++keys;
+                } // end if (valid)
+            } // end while (valid && it != end())
+
+            valid = valid && keys == header->count;
+        } // end try
+        catch (bad_alloc e)
+        {
+            valid = false;
+            cerr << "Could not allocate memory for offsets: "
+                 << "TreeSnapshot() failed." << endl;
+        } // end catch (bad_alloc e)
+    } // end if (valid)
+
+    if (valid)
+    {
+        count = header->count;
+    } // end if (valid)
+
+    return valid;
+} // end open()
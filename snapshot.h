@@ -0,0 +1,257 @@
+/*
+ * @file    snapshot.h
+ * @brief   This class serves read-only searches from a file written by
+ *          BinTree::save(), without loading it into a tree. The file is
+ *          mapped into memory where the system supports it, or read whole
+ *          otherwise, and searched in place. A snapshot file holds a header,
+ *          the keys in sorted order, each prefixed by its length, and,
+ *          optionally, the offsets of the keys in Eytzinger order (the layout
+ *          of a frozen BinTree), which is searched without branching. Without
+ *          that section, an array of offsets in sorted order is built when
+ *          the file is opened, and searched by bisection. Every key and
+ *          layout offset is checked when the file is opened, so a damaged
+ *          file is refused rather than read past its end.
+ * @author  Brendan Sweeney, SID 1161836
+ * @date    October 14, 2026
+ */
+
+#ifndef _SNAPSHOT_H
+#define	_SNAPSHOT_H
+
+#include <cstddef>          // for size_t
+#include <cstdint>          // fixed-width fields of the file
+#include <iterator>         // for forward_iterator_tag
+#include <string_view>      // keys within the file
+#include <vector>           // offsets, and the file if it is not mapped
+
+#include "nodedata.h"
+
+
+// the first bytes of a snapshot file; every offset is from the file's start
+struct SnapshotHeader
+{
+    char     magic[8];      // "BINTREE" and a terminating NUL
+    uint32_t version;       // Format of the file, VERSION
+    uint32_t byteOrder;     // ORDER_MARK as written, to detect a mismatch
+    uint64_t count;         // Number of keys
+    uint64_t keysOffset;    // Start of the keys, in sorted order
+    uint64_t keysBytes;     // Length of the keys section
+    uint64_t layoutOffset;  // Start of count + 1 offsets, from index 1 in
+                            // Eytzinger order; 0 if there is no layout
+
+    static const uint32_t VERSION = 1;
+    static const uint32_t ORDER_MARK = 0x01020304;
+}; // end SnapshotHeader
+
+
+class TreeSnapshot
+{
+/**---------------------- << Stream Out Operator ------------------------------
+ * Writes the contents of a snapshot to the provided ostream, in sorted order,
+ * space separated on a single line, as a BinTree holding them would.
+ * @param output  The ostream to which to write the snapshot's contents.
+ * @param source  The snapshot whose contents are to be written.
+ * @pre The ostream, output, is writable.
+ * @post The ostream, output, contains a string representing the contents of
+ *       the snapshot, in sorted order; the snapshot remains unchanged.
+ * @return A reference to the provided ostream, with the contents of the
+ *         snapshot appended to it.
+ */
+    friend ostream& operator<<(ostream& output, const TreeSnapshot& source);
+
+public:
+
+/**---------------------- const_iterator --------------------------------------
+ * A forward iterator over the keys of a snapshot, in sorted order, read
+ * from the keys section in place.
+ */
+    class const_iterator
+    {
+    public:
+        typedef forward_iterator_tag iterator_category;
+        typedef string_view          value_type;
+        typedef ptrdiff_t            difference_type;
+        typedef const string_view   *pointer;
+        typedef string_view          reference;
+
+        const_iterator() : cursor(NULL)
+        {
+        } // end constructor
+
+        string_view operator*() const;
+        const_iterator& operator++();
+        const_iterator operator++(int);
+
+        bool operator==(const const_iterator& rhs) const
+        {
+            return cursor == rhs.cursor;
+        } // end operator==
+
+        bool operator!=(const const_iterator& rhs) const
+        {
+            return cursor != rhs.cursor;
+        } // end operator!=
+
+    private:
+        friend class TreeSnapshot;
+
+        const char *cursor;     // Length prefix of the current key
+
+        explicit const_iterator(const char *position) : cursor(position)
+        {
+        } // end constructor
+    }; // end const_iterator
+
+/**---------------------- Constructor -----------------------------------------
+ * Opens a snapshot file and checks its header. The keys are not read.
+ * @param fileName  The name of a file written by BinTree::save().
+ * @pre None.
+ * @post If the file could be opened and its header describes a snapshot
+ *       that fits within it, isOpen() is true; otherwise, the snapshot is
+ *       empty.
+ */
+    explicit TreeSnapshot(const char *fileName);
+
+/**---------------------- Destructor ------------------------------------------
+ * Releases the file of a snapshot before it is released.
+ * @pre None.
+ * @post The file is unmapped, or its copy is freed.
+ */
+    ~TreeSnapshot();
+
+/**---------------------- isOpen() --------------------------------------------
+ * Determines whether a snapshot file could be opened.
+ * @pre None.
+ * @post This snapshot remains unchanged.
+ * @return true if the file was opened and is a snapshot; false, otherwise.
+ */
+    bool isOpen(void) const;
+
+/**---------------------- hasLayout() -----------------------------------------
+ * Determines whether a snapshot file holds the Eytzinger layout of its keys.
+ * @pre None.
+ * @post This snapshot remains unchanged.
+ * @return true if searches use the layout saved in the file; false if they
+ *         bisect offsets built when it was opened.
+ */
+    bool hasLayout(void) const;
+
+/**---------------------- size() ----------------------------------------------
+ * Determines the number of items in a snapshot.
+ * @pre None.
+ * @post This snapshot remains unchanged.
+ * @return The number of items in this snapshot.
+ */
+    int size(void) const;
+
+/**---------------------- contains() ------------------------------------------
+ * Determines whether an item is in a snapshot, without copying it.
+ * @param searchItem  The item to be located.
+ * @pre NodeData provides the view() method.
+ * @post This snapshot remains unchanged.
+ * @return true if searchItem matches an item in the snapshot; false,
+ *         otherwise.
+ */
+    bool contains(const NodeData& searchItem) const;
+
+/**---------------------- retrieve() ------------------------------------------
+ * Retrieves a copy of a given item from a snapshot.
+ * @param searchItem  The item to be located.
+ * @param dataItem  A container for a copy of the found item.
+ * @pre NodeData provides the view() method.
+ * @post If the retrieval was successful, dataItem is equal to the retrieved
+ *       item; this snapshot remains unchanged.
+ * @return true if searchItem matches an item in the snapshot; false if
+ *         searchItem could not be found.
+ */
+    bool retrieve(const NodeData& searchItem, NodeData& dataItem) const;
+
+/**---------------------- getDepth() ------------------------------------------
+ * Determines the depth of an item in the implicit tree that a search of a
+ * snapshot walks: the frozen tree, if the layout was saved, or else the tree
+ * of midpoints taken by bisection.
+ * @param searchItem  The item to locate.
+ * @pre NodeData provides the view() method.
+ * @post This snapshot remains unchanged.
+ * @return The depth of searchItem, where the root is at depth 1, if found;
+ *         0, otherwise.
+ */
+    int getDepth(const NodeData& searchItem) const;
+
+/**---------------------- begin() ---------------------------------------------
+ * Locates the smallest item in a snapshot.
+ * @pre None.
+ * @post This snapshot remains unchanged.
+ * @return An iterator at the smallest item; end() if this snapshot is empty.
+ */
+    const_iterator begin(void) const;
+
+/**---------------------- end() -----------------------------------------------
+ * Provides the position one past the largest item in a snapshot.
+ * @pre None.
+ * @post This snapshot remains unchanged.
+ * @return An iterator that may not be dereferenced.
+ */
+    const_iterator end(void) const;
+
+private:
+
+    const char       *base;         // Start of the file in memory; or NULL
+    size_t            length;       // Bytes of the file
+    bool              mapped;       // Whether base is a mapping of the file
+    vector<char>      contents;     // The file, if it could not be mapped
+    const uint64_t   *layout;       // Offsets in Eytzinger order; or NULL
+    vector<uint64_t>  sorted;       // Offsets in sorted order, if no layout
+    size_t            count;        // Number of keys
+
+    // a snapshot owns its mapping
+    TreeSnapshot(const TreeSnapshot&);
+    TreeSnapshot& operator=(const TreeSnapshot&);
+
+/**---------------------- keyAt() ---------------------------------------------
+ * Reads the key at an offset in the file.
+ * @param offset  The offset of the key's length prefix.
+ * @pre offset is the offset of a key of this snapshot.
+ * @post This snapshot remains unchanged.
+ * @return A view of the key's characters, within the file.
+ */
+    string_view keyAt(uint64_t offset) const;
+
+/**---------------------- locate() --------------------------------------------
+ * Finds the offset of an item in a snapshot, through the layout if it was
+ * saved, or else by bisecting the sorted offsets.
+ * @param key  The characters of the item to be located.
+ * @param level  A container for the depth at which the item was found.
+ * @pre None.
+ * @post This snapshot remains unchanged.
+ * @return The offset of the matching key; 0 if there is none.
+ */
+    uint64_t locate(string_view key, int& level) const;
+
+/**---------------------- keyFits() -------------------------------------------
+ * Determines whether a key at an offset in the file, with its length prefix,
+ * lies wholly within the keys section, so that it may be read.
+ * @param offset  The offset of the key's length prefix.
+ * @pre The header of the file has been checked to fit within it.
+ * @post This snapshot remains unchanged.
+ * @return true if the prefix and the key both end within the keys section;
+ *         false, otherwise.
+ */
+    bool keyFits(uint64_t offset) const;
+
+/**---------------------- open() ----------------------------------------------
+ * Checks the header of the file in memory, and uses its layout or builds the
+ * sorted offsets. Every key is checked to fit within the keys section, which
+ * it must fill exactly, and every offset of the layout to be that of a key
+ * that fits, so that no search or iteration reads past the file.
+ * @pre base points to length bytes of the file.
+ * @post If the file is a valid snapshot, count is its number of keys, and
+ *       layout or sorted is set; otherwise, the snapshot is empty.
+ * @return true if the file is a valid snapshot; false, otherwise.
+ */
+    bool open(void);
+
+}; // end TreeSnapshot
+
+
+#endif	/* _SNAPSHOT_H */
@@ -0,0 +1,217 @@
+/*
+ * @file    snapshottest.cpp
+ * @brief   Checks that TreeSnapshot and BinTree::load() refuse damaged
+ *          snapshot files instead of reading past them. A small tree is
+ *          saved with and without its layout, each file is damaged in one
+ *          way, and the result must fail to open and to load; the intact
+ *          files must still do both. Run by ctest, from the build directory,
+ *          where the files are written; it exits with 1 if any check fails.
+ * @author  Brendan Sweeney, SID 1161836
+ * @date    October 14, 2026
+ */
+
+#include <cstdint>          // fixed-width fields of the file
+#include <cstdio>           // for fopen, fread and fwrite
+#include <cstring>          // for memcpy
+#include <iostream>         // for cout and cerr
+#include <vector>           // the bytes of a file
+
+#include "bintree.h"
+#include "snapshot.h"
+
+using namespace std;
+
+static const char *INTACT = "snapshottest.bin";
+static const char *DAMAGED = "snapshottest-damaged.bin";
+
+/**---------------------- readFile() ------------------------------------------
+ * Reads a whole file into memory.
+ * @param fileName  The name of the file to be read.
+ * @pre None.
+ * @post None.
+ * @return The bytes of the file; empty if it could not be read.
+ */
+static vector<char> readFile(const char *fileName)
+{
+    vector<char> bytes;
+    FILE        *input = fopen(fileName, "rb");
+    char         chunk[4096];
+    size_t       got;
+
+    if (input != NULL)
+    {
+        while ((got = fread(chunk, 1, sizeof(chunk), input)) > 0)
+        {
+            bytes.insert(bytes.end(), chunk, chunk + got);
+        } // end while ((got = fread(...)) > 0)
+
+        fclose(input);
+    } // end if (input != NULL)
+
+    return bytes;
+} // end readFile()
+
+/**---------------------- writeFile() -----------------------------------------
+ * Writes bytes to a file, replacing it.
+ * @param fileName  The name of the file to be written.
+ * @param bytes  The bytes to be written.
+ * @pre None.
+ * @post The file holds bytes, if it could be written.
+ */
+static void writeFile(const char *fileName, const vector<char>& bytes)
+{
+    FILE *output = fopen(fileName, "wb");
+
+    if (output != NULL)
+    {
+        fwrite(bytes.data(), 1, bytes.size(), output);
+        fclose(output);
+    } // end if (output != NULL)
+} // end writeFile()
+
+/**---------------------- header() --------------------------------------------
+ * Provides the header at the start of the bytes of a snapshot file.
+ * @param bytes  The bytes of a snapshot file.
+ * @pre bytes holds at least a whole header.
+ * @post None.
+ * @return The header, which may be changed in place.
+ */
+static SnapshotHeader *header(vector<char>& bytes)
+{
+    return reinterpret_cast<SnapshotHeader*>(bytes.data());
+} // end header()
+
+/**---------------------- lastKey() -------------------------------------------
+ * Finds the offset of the length prefix of the last key of a snapshot file.
+ * @param bytes  The bytes of an intact snapshot file.
+ * @pre The file holds at least one key.
+ * @post None.
+ * @return The offset of the last key's length prefix.
+ */
+static uint64_t lastKey(vector<char>& bytes)
+{
+    uint64_t offset = header(bytes)->keysOffset;
+    uint64_t keysEnd = offset + header(bytes)->keysBytes;
+    uint64_t last = offset;
+    uint32_t size;
+
+    while (offset < keysEnd)
+    {
+        last = offset;
+        memcpy(&size, &bytes[offset], sizeof(size));
+        offset += sizeof(size) + size;
+    } // end while (offset < keysEnd)
+
+    return last;
+} // end lastKey()
+
+/**---------------------- check() ---------------------------------------------
+ * Opens and loads a snapshot file, and reports whether both succeeded as
+ * expected.
+ * @param name  A description of the file, for the report.
+ * @param fileName  The name of the file.
+ * @param intact  Whether the file should open and load.
+ * @pre None.
+ * @post A line is written to cout, or to cerr if the check failed.
+ * @return true if the file opened and loaded exactly when it should.
+ */
+static bool check(const char *name, const char *fileName, bool intact)
+{
+    TreeSnapshot snapshot(fileName);
+    BinTree      tree;
+    bool         opened = snapshot.isOpen();
+    bool         loaded = tree.load(fileName);
+    bool         passed = (opened == intact && loaded == intact);
+
+    if (passed && intact)
+    {
+        NodeData found;
+
+        passed = snapshot.size() == 4 && tree.size() == 4
+                 && snapshot.contains(NodeData("pear"))
+                 && !snapshot.contains(NodeData("plum"))
+                 && snapshot.retrieve(NodeData("fig"), found);
+    } // end if (passed && intact)
+
+    (passed ? cout : cerr) << (passed ? "passed: " : "FAILED: ") << name
+                           << endl;
+    return passed;
+} // end check()
+
+/**---------------------- main() ----------------------------------------------
+ * Saves a small tree, damages copies of its files, and checks each one.
+ * @pre The current directory is writable.
+ * @post The files are removed.
+ * @return 0 if every check passed; 1, otherwise.
+ */
+int main()
+{
+    BinTree      tree;
+    vector<char> bytes;
+    bool         passed = true;
+    uint64_t     value;
+    uint32_t     size;
+
+    tree.insert(NodeData("fig"));
+    tree.insert(NodeData("apple"));
+    tree.insert(NodeData("pear"));
+    tree.insert(NodeData("kiwi"));
+
+    for (int layout = 0; layout < 2; ++layout)
+    {
+        const char *kind = (layout ? " (layout)" : " (sorted)");
+        string      name;
+
+        tree.save(INTACT, layout != 0);
+        passed = check((name = string("intact file") + kind).c_str(),
+                       INTACT, true) && passed;
+
+        // a header cut short
+        bytes = readFile(INTACT);
+        bytes.resize(sizeof(SnapshotHeader) - 8);
+        writeFile(DAMAGED, bytes);
+        passed = check((name = string("truncated header") + kind).c_str(),
+                       DAMAGED, false) && passed;
+
+        // the last key claims far more bytes than the file holds
+        bytes = readFile(INTACT);
+        size = 100000000;
+        memcpy(&bytes[lastKey(bytes)], &size, sizeof(size));
+        writeFile(DAMAGED, bytes);
+        passed = check((name = string("bad key length") + kind).c_str(),
+                       DAMAGED, false) && passed;
+
+        // the keys section ends with too few bytes for a length prefix
+        bytes = readFile(INTACT);
+        bytes.insert(bytes.begin() + header(bytes)->keysOffset
+                                   + header(bytes)->keysBytes, 2, '\0');
+        header(bytes)->keysBytes += 2;
+
+        if (header(bytes)->layoutOffset != 0)
+        {
+            header(bytes)->layoutOffset += 8;   // still aligned; now shifted
+            bytes.insert(bytes.begin() + header(bytes)->layoutOffset - 6,
+                         6, '\0');
+        } // end if (header(bytes)->layoutOffset != 0)
+
+        writeFile(DAMAGED, bytes);
+        passed = check((name = string("partial length prefix") + kind)
+                       .c_str(), DAMAGED, false) && passed;
+
+        if (layout)
+        {
+            // one entry of the layout points far outside the file
+            bytes = readFile(INTACT);
+            value = uint64_t(1) << 40;
+            memcpy(&bytes[header(bytes)->layoutOffset + sizeof(value)],
+                   &value, sizeof(value));
+            writeFile(DAMAGED, bytes);
+            passed = check("bad layout offset (layout)", DAMAGED, false)
+                     && passed;
+        } // end if (layout)
+    } // end for (int layout = 0)
+
+    remove(INTACT);
+    remove(DAMAGED);
+    return passed ? 0 : 1;
+} // end main()
@@ -0,0 +1,225 @@
+/*
+ * @file    taskpool.cpp
+ * @brief   This class is a work-stealing pool of threads for fork-join work.
+ *          Each worker keeps its own queue of tasks: it runs the newest, so
+ *          the subtree it just split stays in its cache, while idle workers
+ *          steal the oldest, which are the largest pieces of work. Tasks are
+ *          spawned into a Group, and a thread waiting on a group runs queued
+ *          tasks itself rather than blocking, so forks may nest to any depth.
+ * @author  Brendan Sweeney, SID 1161836
+ * @date    October 14, 2026
+ */
+
+#include "taskpool.h"
+
+using namespace std;
+
+// the pool, if any, whose worker is the calling thread, and which worker
+static thread_local const TaskPool *workerPool = NULL;
+static thread_local int             workerIndex = 0;
+
+
+/**---------------------- Constructor -----------------------------------------
+ * Creates a pool and starts its worker threads.
+ * @param workers  The number of worker threads to start.
+ * @pre workers is greater than 0.
+ * @post workers threads are waiting for tasks.
+ */
+TaskPool::TaskPool(int workers)
+    : queued(0), stopping(false)
+{
+    for (int i = 0; i <= workers; ++i)
+    {
+        queues.push_back(new Queue);    // last one is for other threads
+    } // end for (int i = 0)
+
+    for (int i = 0; i < workers; ++i)
+    {
+        threads.push_back(thread(&TaskPool::work, this, i));
+    } // end for (int i = 0)
+} // end constructor(int)
+
+/**---------------------- Destructor ------------------------------------------
+ * Stops and joins every worker thread.
+ * @pre Every group has been waited on.
+ * @post No worker thread is running.
+ */
+TaskPool::~TaskPool()
+{
+    {
+        lock_guard<mutex> guard(sleeping);
+
+        stopping.store(true);
+    }
+
+    wake.notify_all();
+
+    for (size_t i = 0; i < threads.size(); ++i)
+    {
+        threads[i].join();
+    } // end for (size_t i = 0)
+
+    for (size_t i = 0; i < queues.size(); ++i)
+    {
+        delete queues[i];
+    } // end for (size_t i = 0)
+} // end destructor
+
+/**---------------------- shared() --------------------------------------------
+ * Finds the pool shared by the whole program, starting it on first use with
+ * one worker per hardware thread.
+ * @pre None.
+ * @post The shared pool is running.
+ * @return A reference to the shared pool.
+ */
+TaskPool& TaskPool::shared(void)
+{
+    static TaskPool pool(thread::hardware_concurrency() > 0
+                         ? static_cast<int>(thread::hardware_concurrency())
+                         : 1);
+
+    return pool;
+} // end shared()
+
+/**---------------------- workerCount() ---------------------------------------
+ * Determines the number of worker threads in this pool.
+ * @pre None.
+ * @post This pool remains unchanged.
+ * @return The number of worker threads.
+ */
+int TaskPool::workerCount(void) const
+{
+    return static_cast<int>(threads.size());
+} // end workerCount()
+
+/**---------------------- spawn() ---------------------------------------------
+ * Queues a task to be run by some thread of this pool, or by a thread that
+ * waits on group.
+ * @param group  The group the task belongs to.
+ * @param task  The work to be done; it must not throw.
+ * @pre group will be waited on before it is destroyed.
+ * @post task is queued, or has already been run.
+ */
+void TaskPool::spawn(Group& group, const function<void()>& task)
+{
+    Queue *queue = queues[queueOf()];
+    Task   entry;
+
+    entry.run = task;
+    entry.group = &group;
+    group.pending.fetch_add(1);
+
+    {
+        lock_guard<mutex> guard(queue->lock);
+
+        queue->tasks.push_back(entry);
+    }
+
+    queued.fetch_add(1);
+
+    {
+        lock_guard<mutex> guard(sleeping);  // no worker misses the signal
+    }
+
+    wake.notify_one();
+} // end spawn(Group&, function<void()>&)
+
+/**---------------------- wait() ----------------------------------------------
+ * Waits for every task of a group to finish, running queued tasks from this
+ * pool in the meantime.
+ * @param group  The group whose tasks are to be waited for.
+ * @pre None.
+ * @post Every task spawned into group has finished.
+ */
+void TaskPool::wait(Group& group)
+{
+    int self = queueOf();
+
+    while (group.pending.load(memory_order_acquire) > 0)
+    {
+        if (!runOne(self))
+        {
+            this_thread::yield();       // tasks of group are running
+        } // end if (!runOne(self))
+    } // end while (group.pending.load(memory_order_acquire) > 0)
+} // end wait(Group&)
+
+/**---------------------- queueOf() -------------------------------------------
+ * Determines which queue the calling thread pushes to and pops from.
+ * @pre None.
+ * @post This pool remains unchanged.
+ * @return The index of the worker queue of the calling thread, if it is a
+ *         worker of this pool; the index of the external queue, otherwise.
+ */
+int TaskPool::queueOf(void) const
+{
+    return (workerPool == this ? workerIndex
+                               : static_cast<int>(queues.size()) - 1);
+} // end queueOf()
+
+/**---------------------- runOne() --------------------------------------------
+ * Runs one queued task: the newest from queue self, if any, or else the
+ * oldest from another queue.
+ * @param self  The queue of the calling thread.
+ * @pre None.
+ * @post At most one task has been run and removed from its queue.
+ * @return true if a task was run; false if every queue was empty.
+ */
+bool TaskPool::runOne(int self)
+{
+    int  count = static_cast<int>(queues.size());
+    bool found = false;
+    Task entry;
+
+    // newest from our own queue, then oldest from the others
+    for (int i = 0; i < count && !found; ++i)
+    {
+        Queue *queue = queues[(self + i) % count];
+        lock_guard<mutex> guard(queue->lock);
+
+        if (!queue->tasks.empty() && i == 0)
+        {
+            entry = queue->tasks.back();
+            queue->tasks.pop_back();
+            found = true;
+        }
+        else if (!queue->tasks.empty())
+        {
+            entry = queue->tasks.front();
+            queue->tasks.pop_front();
+            found = true;
+        } // end if (!queue->tasks.empty() && i == 0)
+    } // end for (int i = 0)
+
+    if (found)
+    {
+        queued.fetch_sub(1);
+        entry.run();
+        entry.group->pending.fetch_sub(1, memory_order_release);
+    } // end if (found)
+
+    return found;
+} // end runOne(int)
+
+/**---------------------- work() ----------------------------------------------
+ * Runs tasks until the pool is stopped, sleeping while there are none.
+ * @param self  The queue of this worker.
+ * @pre None.
+ * @post The pool is stopping.
+ */
+void TaskPool::work(int self)
+{
+    workerPool = this;
+    workerIndex = self;
+
+    while (!stopping.load())
+    {
+        if (!runOne(self))
+        {
+            unique_lock<mutex> guard(sleeping);
+
+            wake.wait(guard, [this] { return stopping.load()
+                                             || queued.load() > 0; });
+        } // end if (!runOne(self))
+    } // end while (!stopping.load())
+} // end work(int)
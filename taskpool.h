@@ -0,0 +1,155 @@
+/*
+ * @file    taskpool.h
+ * @brief   This class is a work-stealing pool of threads for fork-join work.
+ *          Each worker keeps its own queue of tasks: it runs the newest, so
+ *          the subtree it just split stays in its cache, while idle workers
+ *          steal the oldest, which are the largest pieces of work. Tasks are
+ *          spawned into a Group, and a thread waiting on a group runs queued
+ *          tasks itself rather than blocking, so forks may nest to any depth.
+ * @author  Brendan Sweeney, SID 1161836
+ * @date    October 14, 2026
+ */
+
+#ifndef _TASKPOOL_H
+#define	_TASKPOOL_H
+
+#include <atomic>               // for atomic counters
+#include <condition_variable>   // idle workers sleep on one
+#include <deque>                // queues of tasks
+#include <functional>           // for function
+#include <mutex>                // for mutex
+#include <thread>               // for thread
+#include <vector>               // per-worker queues and threads
+
+
+class TaskPool
+{
+public:
+
+    // a set of spawned tasks that one thread waits on together
+    class Group
+    {
+    public:
+        Group() : pending(0)
+        {
+        } // end constructor
+
+    private:
+        friend class TaskPool;
+
+        std::atomic<int> pending;   // Tasks spawned but not yet finished
+
+        // a group is waited on where it was created
+        Group(const Group&);
+        Group& operator=(const Group&);
+    }; // end Group
+
+/**---------------------- Constructor -----------------------------------------
+ * Creates a pool and starts its worker threads.
+ * @param workers  The number of worker threads to start.
+ * @pre workers is greater than 0.
+ * @post workers threads are waiting for tasks.
+ */
+    explicit TaskPool(int workers);
+
+/**---------------------- Destructor ------------------------------------------
+ * Stops and joins every worker thread.
+ * @pre Every group has been waited on.
+ * @post No worker thread is running.
+ */
+    ~TaskPool();
+
+/**---------------------- shared() --------------------------------------------
+ * Finds the pool shared by the whole program, starting it on first use with
+ * one worker per hardware thread.
+ * @pre None.
+ * @post The shared pool is running.
+ * @return A reference to the shared pool.
+ */
+    static TaskPool& shared(void);
+
+/**---------------------- workerCount() ---------------------------------------
+ * Determines the number of worker threads in this pool.
+ * @pre None.
+ * @post This pool remains unchanged.
+ * @return The number of worker threads.
+ */
+    int workerCount(void) const;
+
+/**---------------------- spawn() ---------------------------------------------
+ * Queues a task to be run by some thread of this pool, or by a thread that
+ * waits on group.
+ * @param group  The group the task belongs to.
+ * @param task  The work to be done; it must not throw.
+ * @pre group will be waited on before it is destroyed.
+ * @post task is queued, or has already been run.
+ */
+    void spawn(Group& group, const std::function<void()>& task);
+
+/**---------------------- wait() ----------------------------------------------
+ * Waits for every task of a group to finish, running queued tasks from this
+ * pool in the meantime.
+ * @param group  The group whose tasks are to be waited for.
+ * @pre None.
+ * @post Every task spawned into group has finished.
+ */
+    void wait(Group& group);
+
+private:
+
+    struct Task
+    {
+        std::function<void()> run;  // The work to be done
+        Group                *group;    // Group notified when run returns
+    }; // end Task
+
+    // one queue per worker, alone on its cache line, plus one shared by all
+    // threads outside the pool
+    struct alignas(64) Queue
+    {
+        std::mutex       lock;      // Guards tasks
+        std::deque<Task> tasks;     // Oldest at the front
+    }; // end Queue
+
+    std::vector<Queue*>      queues;    // Worker queues, then external one
+    std::vector<std::thread> threads;   // The workers
+    std::atomic<int>         queued;    // Tasks in all queues
+    std::atomic<bool>        stopping;  // Whether workers should exit
+    std::mutex               sleeping;  // Guards wake
+    std::condition_variable  wake;      // Signalled when work is queued
+
+    // pools own threads and are not copied
+    TaskPool(const TaskPool&);
+    TaskPool& operator=(const TaskPool&);
+
+/**---------------------- queueOf() -------------------------------------------
+ * Determines which queue the calling thread pushes to and pops from.
+ * @pre None.
+ * @post This pool remains unchanged.
+ * @return The index of the worker queue of the calling thread, if it is a
+ *         worker of this pool; the index of the external queue, otherwise.
+ */
+    int queueOf(void) const;
+
+/**---------------------- runOne() --------------------------------------------
+ * Runs one queued task: the newest from queue self, if any, or else the
+ * oldest from another queue.
+ * @param self  The queue of the calling thread.
+ * @pre None.
+ * @post At most one task has been run and removed from its queue.
+ * @return true if a task was run; false if every queue was empty.
+ */
+    bool runOne(int self);
+
+/**---------------------- work() ----------------------------------------------
+ * Runs tasks until the pool is stopped, sleeping while there are none.
+ * @param self  The queue of this worker.
+ * @pre None.
+ * @post The pool is stopping.
+ */
+    void work(int self);
+
+}; // end TaskPool
+
+
+#endif	/* _TASKPOOL_H */
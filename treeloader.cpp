@@ -0,0 +1,346 @@
+/*
+ * @file    treeloader.cpp
+ * @brief   This class reads whitespace separated tokens from a file into
+ *          BinTree objects, one record at a time, where each record ends with
+ *          the token "$$". The file is read in large chunks into a buffer
+ *          owned by the loader, whitespace is found sixteen characters at a
+ *          time with SSE2 where the compiler targets it, and each token is
+ *          handed to the tree as a view into that buffer, so no string is
+ *          built for it before its node is. The tokens of a record may be
+ *          echoed to an ostream as they are read.
+ * @author  Brendan Sweeney, SID 1161836
+ * @date    October 14, 2026
+ */
+
+#include <cstring>          // for memmove
+#include <iostream>         // for cerr
+#include <new>              // for bad_alloc
+
+#if defined(__GNUC__) && defined(__SSE2__)
+#include <emmintrin.h>      // 8-bit integer vector compares
+#endif
+
+#include "treeloader.h"
+
+using namespace std;
+
+/**---------------------- isSpace() -------------------------------------------
+ * Determines whether a character is whitespace in the "C" locale, as
+ * operator>> on a string decides. The characters '\t' through '\r' are
+ * contiguous, so one unsigned comparison finds all of them.
+ * @param c  The character to test.
+ * @pre None.
+ * @post None.
+ * @return true if c is ' ', '\t', '\n', '\v', '\f', or '\r'; false, otherwise.
+ */
+static inline bool isSpace(char c)
+{
+    return c == ' ' || static_cast<unsigned char>(c - '\t') <= '\r' - '\t';
+} // end isSpace()
+
+#if defined(__GNUC__) && defined(__SSE2__)
+/**---------------------- spaceMask() -----------------------------------------
+ * Finds the whitespace among sixteen characters at once, with the comparison
+ * of isSpace() done in every byte of a vector.
+ * @param text  The first of the characters to test.
+ * @pre text points to at least 16 readable characters.
+ * @post None.
+ * @return A mask whose bit i is set if text[i] is whitespace.
+ */
+static inline unsigned spaceMask(const char *text)
+{
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text));
+    __m128i shifted = _mm_sub_epi8(chunk, _mm_set1_epi8('\t'));
+    __m128i control = _mm_cmpeq_epi8(
+                          _mm_min_epu8(shifted, _mm_set1_epi8('\r' - '\t')),
+                          shifted);
+    __m128i blank = _mm_cmpeq_epi8(chunk, _mm_set1_epi8(' '));
+
+    return static_cast<unsigned>(
+               _mm_movemask_epi8(_mm_or_si128(control, blank)));
+} // end spaceMask()
+#endif
+
+/**---------------------- skipSpace() -----------------------------------------
+ * Finds the first character of a range that is not whitespace.
+ * @param text  The characters to search.
+ * @param length  The number of characters in text.
+ * @pre text points to at least length readable characters.
+ * @post None.
+ * @return The index of the first non-whitespace character; length if there
+ *         is none.
+ */
+static size_t skipSpace(const char *text, size_t length)
+{
+    size_t   index = 0;
+    unsigned found = 0;             // mask of the chunk where the scan ended
+
+#if defined(__GNUC__) && defined(__SSE2__)
+    while (found == 0 && index + 16 <= length)
+    {
+        found = ~spaceMask(text + index) & 0xFFFF;
+
+        if (found == 0)
+        {
+            index += 16;
+        } // end if (found == 0)
+    } // end while (found == 0 && index + 16 <= length)
+
+    if (found != 0)
+    {
+        index += __builtin_ctz(found);
+    } // end if (found != 0)
+#endif
+
+    while (found == 0 && index < length && isSpace(text[index]))
+    {
+        ++index;
+    } // end while (found == 0 && index < length)
+
+    return index;
+} // end skipSpace()
+
+/**---------------------- findSpace() -----------------------------------------
+ * Finds the first whitespace character of a range.
+ * @param text  The characters to search.
+ * @param length  The number of characters in text.
+ * @pre text points to at least length readable characters.
+ * @post None.
+ * @return The index of the first whitespace character; length if there is
+ *         none.
+ */
+static size_t findSpace(const char *text, size_t length)
+{
+    size_t   index = 0;
+    unsigned found = 0;             // mask of the chunk where the scan ended
+
+#if defined(__GNUC__) && defined(__SSE2__)
+    while (found == 0 && index + 16 <= length)
+    {
+        found = spaceMask(text + index);
+
+        if (found == 0)
+        {
+            index += 16;
+        } // end if (found == 0)
+    } // end while (found == 0 && index + 16 <= length)
+
+    if (found != 0)
+    {
+        index += __builtin_ctz(found);
+    } // end if (found != 0)
+#endif
+
+    while (found == 0 && index < length && !isSpace(text[index]))
+    {
+        ++index;
+    } // end while (found == 0 && index < length)
+
+    return index;
+} // end findSpace()
+
+
+/**---------------------- Constructor -----------------------------------------
+ * Opens a file from which to load trees. Nothing is read until the first
+ * record is loaded.
+ * @param fileName  The name of the file to be read.
+ * @param chunkSize  The number of bytes to read from the file at a time.
+ * @pre chunkSize is greater than 0.
+ * @post If the file could be opened, the loader is positioned at its start;
+ *       otherwise, isOpen() is false and the loader is at its end.
+ */
+TreeLoader::TreeLoader(const char *fileName, size_t chunkSize)
+    : input(fopen(fileName, "rb")), buffer(chunkSize), begin(0), end(0),
+      exhausted(input == NULL)
+{
+    if (input != NULL)
+    {
+        // chunks are read straight into buffer, not through a stdio buffer
+        setvbuf(input, NULL, _IONBF, 0);
+    } // end if (input != NULL)
+} // end constructor(const char*, size_t)
+
+/**---------------------- Destructor ------------------------------------------
+ * Closes the file before the loader is released.
+ * @pre None.
+ * @post The file is closed.
+ */
+TreeLoader::~TreeLoader()
+{
+    if (input != NULL)
+    {
+        fclose(input);
+    } // end if (input != NULL)
+} // end destructor
+
+/**---------------------- isOpen() --------------------------------------------
+ * Determines whether the file of a loader could be opened.
+ * @pre None.
+ * @post This loader remains unchanged.
+ * @return true if the file was opened; false, otherwise.
+ */
+bool TreeLoader::isOpen(void) const
+{
+    return input != NULL;
+} // end isOpen()
+
+/**---------------------- atEnd() ---------------------------------------------
+ * Determines whether every character of the file has been read. Like eof()
+ * on an ifstream, this is not known until a read reaches the end, so the
+ * whitespace after the last record is still unread until one more record is
+ * loaded, which is then empty.
+ * @pre None.
+ * @post This loader remains unchanged.
+ * @return true if the whole file has been read, or it could not be opened;
+ *         false, otherwise.
+ */
+bool TreeLoader::atEnd(void) const
+{
+    return begin == end && exhausted;
+} // end atEnd()
+
+/**---------------------- nextToken() -----------------------------------------
+ * Reads the next whitespace separated token from the file. Whitespace is any
+ * character for which isspace() is true in the "C" locale.
+ * @param token  A container for a view of the token.
+ * @pre None.
+ * @post If a token was read, token views its characters, which remain valid
+ *       until this loader is next read from.
+ * @return true if a token was read; false if the end of the file was reached
+ *         first.
+ */
+bool TreeLoader::nextToken(string_view& token)
+{
+    bool   found = false;
+    size_t length;
+
+    begin += skipSpace(buffer.data() + begin, end - begin);
+
+    while (begin == end && refill())
+    {
+        begin += skipSpace(buffer.data() + begin, end - begin);
+    } // end while (begin == end && refill())
+
+    if (begin < end)
+    {
+        length = findSpace(buffer.data() + begin, end - begin);
+
+        // a token reaching the end of the buffer may go on in the next chunk
+        while (begin + length == end && refill())
+        {
+            length += findSpace(buffer.data() + begin + length,
+                                end - begin - length);
+        } // end while (begin + length == end && refill())
+
+        token = string_view(buffer.data() + begin, length);
+        begin += length;
+        found = true;
+    } // end if (begin < end)
+
+    return found;
+} // end nextToken(string_view&)
+
+/**---------------------- loadRecord() ----------------------------------------
+ * Reads tokens into a tree until the token "$$" or the end of the file. In
+ * INSERT mode, each token is inserted as read and duplicates are dropped; in
+ * BUILD mode, the contents of the tree are replaced by the distinct tokens of
+ * the record. If echo is not NULL, each token read is written to it followed
+ * by a space, including the "$$" ending the record; a record ended by the end
+ * of the file instead ends with a lone space, as if its "$$" were empty.
+ * @param tree  The tree to load the record into.
+ * @param mode  Whether to insert each token or build the tree from them all.
+ * @param echo  The ostream to which to echo tokens; NULL for none.
+ * @pre There is sufficient memory for a NodeData for each token.
+ * @post The tree holds every distinct token of the record, and the loader is
+ *       positioned after it; echo, if not NULL, holds the tokens read.
+ * @return The number of items added to the tree.
+ */
+int TreeLoader::loadRecord(BinTree& tree, Mode mode, ostream *echo)
+{
+    int               added = 0;
+    bool              more;
+    string_view       token;
+    vector<NodeData*> record;       // tokens collected in BUILD mode
+
+    try
+    {
+        while ((more = nextToken(token)) && token != "$$")
+        {
+            if (echo != NULL)
+            {
+                echo->write(token.data(), token.size());
+                echo->put(' ');
+            } // end if (echo != NULL)
+
+            if (mode == BUILD)
+            {
+                record.push_back(NULL);
+                record.back() = new NodeData(token);
+            } // end if (mode == BUILD)
+            else if (tree.insert(NodeData(token)))
+            {
+                ++added;
+            } // end else if (tree.insert(NodeData(token)))
+        } // end while ((more = nextToken(token)) && token != "$$")
+
+        if (echo != NULL)
+        {
+            if (more)
+            {
+                echo->write(token.data(), token.size());
+            } // end if (more)
+
+            echo->put(' ');
+        } // end if (echo != NULL)
+    } // end try
+    catch (bad_alloc e)
+    {
+        if (!record.empty() && record.back() == NULL)
+        {
+            record.pop_back();
+        } // end if (!record.empty() && record.back() == NULL)
+
+        cerr << "Could not allocate memory for record: "
+             << "loadRecord() failed." << endl;
+    } // end catch (bad_alloc e)
+
+    if (mode == BUILD)
+    {
+        added = tree.build(record.data(), static_cast<int>(record.size()));
+    } // end if (mode == BUILD)
+
+    return added;
+} // end loadRecord(BinTree&, Mode, ostream*)
+
+/**---------------------- refill() --------------------------------------------
+ * Reads the next chunk of the file into the buffer. The unread characters are
+ * first moved to the front of the buffer, which is doubled if they fill it,
+ * so a token spanning chunks stays contiguous.
+ * @pre None.
+ * @post The unread characters begin at the front of the buffer, followed by
+ *       any characters just read.
+ * @return true if any characters were read; false at the end of the file.
+ */
+bool TreeLoader::refill(void)
+{
+    size_t count = 0;
+
+    if (!exhausted)
+    {
+        memmove(buffer.data(), buffer.data() + begin, end - begin);
+        end -= begin;
+        begin = 0;
+
+        if (end == buffer.size())
+        {
+            buffer.resize(2 * buffer.size());
+        } // end if (end == buffer.size())
+
+        // fread() fills the request unless the file ends or fails
+        count = fread(buffer.data() + end, 1, buffer.size() - end, input);
+        end += count;
+        exhausted = (end < buffer.size());
+    } // end if (!exhausted)
+
+    return count > 0;
+} // end refill()
@@ -0,0 +1,138 @@
+/*
+ * @file    treeloader.h
+ * @brief   This class reads whitespace separated tokens from a file into
+ *          BinTree objects, one record at a time, where each record ends with
+ *          the token "$$". The file is read in large chunks into a buffer
+ *          owned by the loader, whitespace is found sixteen characters at a
+ *          time with SSE2 where the compiler targets it, and each token is
+ *          handed to the tree as a view into that buffer, so no string is
+ *          built for it before its node is. The tokens of a record may be
+ *          echoed to an ostream as they are read.
+ * @author  Brendan Sweeney, SID 1161836
+ * @date    October 14, 2026
+ */
+
+#ifndef _TREELOADER_H
+#define	_TREELOADER_H
+
+#include <cstddef>          // for size_t
+#include <cstdio>           // for FILE
+#include <string_view>      // tokens within the buffer
+#include <vector>           // the buffer
+
+#include "bintree.h"
+
+
+class TreeLoader
+{
+public:
+
+/**---------------------- Mode ------------------------------------------------
+ * How the tokens of a record are put into a tree. INSERT inserts each token as
+ * it is read, so the shape of a PLAIN tree follows the order of the record,
+ * as it would if the record were typed in. BUILD collects the tokens of the
+ * record and passes them to build(), which replaces the contents of the tree
+ * with a perfectly balanced tree of the distinct tokens.
+ */
+    enum Mode
+    {
+        INSERT,             // insert() each token in the order read
+        BUILD               // build() the tree from the whole record
+    }; // end Mode
+
+    static const size_t CHUNK_SIZE = 1 << 20;   // Bytes read at a time
+
+/**---------------------- Constructor -----------------------------------------
+ * Opens a file from which to load trees. Nothing is read until the first
+ * record is loaded.
+ * @param fileName  The name of the file to be read.
+ * @param chunkSize  The number of bytes to read from the file at a time.
+ * @pre chunkSize is greater than 0.
+ * @post If the file could be opened, the loader is positioned at its start;
+ *       otherwise, isOpen() is false and the loader is at its end.
+ */
+    explicit TreeLoader(const char *fileName, size_t chunkSize = CHUNK_SIZE);
+
+/**---------------------- Destructor ------------------------------------------
+ * Closes the file before the loader is released.
+ * @pre None.
+ * @post The file is closed.
+ */
+    ~TreeLoader();
+
+/**---------------------- isOpen() --------------------------------------------
+ * Determines whether the file of a loader could be opened.
+ * @pre None.
+ * @post This loader remains unchanged.
+ * @return true if the file was opened; false, otherwise.
+ */
+    bool isOpen(void) const;
+
+/**---------------------- atEnd() ---------------------------------------------
+ * Determines whether every character of the file has been read. Like eof()
+ * on an ifstream, this is not known until a read reaches the end, so the
+ * whitespace after the last record is still unread until one more record is
+ * loaded, which is then empty.
+ * @pre None.
+ * @post This loader remains unchanged.
+ * @return true if the whole file has been read, or it could not be opened;
+ *         false, otherwise.
+ */
+    bool atEnd(void) const;
+
+/**---------------------- nextToken() -----------------------------------------
+ * Reads the next whitespace separated token from the file. Whitespace is any
+ * character for which isspace() is true in the "C" locale.
+ * @param token  A container for a view of the token.
+ * @pre None.
+ * @post If a token was read, token views its characters, which remain valid
+ *       until this loader is next read from.
+ * @return true if a token was read; false if the end of the file was reached
+ *         first.
+ */
+    bool nextToken(string_view& token);
+
+/**---------------------- loadRecord() ----------------------------------------
+ * Reads tokens into a tree until the token "$$" or the end of the file. In
+ * INSERT mode, each token is inserted as read and duplicates are dropped; in
+ * BUILD mode, the contents of the tree are replaced by the distinct tokens of
+ * the record. If echo is not NULL, each token read is written to it followed
+ * by a space, including the "$$" ending the record; a record ended by the end
+ * of the file instead ends with a lone space, as if its "$$" were empty.
+ * @param tree  The tree to load the record into.
+ * @param mode  Whether to insert each token or build the tree from them all.
+ * @param echo  The ostream to which to echo tokens; NULL for none.
+ * @pre There is sufficient memory for a NodeData for each token.
+ * @post The tree holds every distinct token of the record, and the loader is
+ *       positioned after it; echo, if not NULL, holds the tokens read.
+ * @return The number of items added to the tree.
+ */
+    int loadRecord(BinTree& tree, Mode mode = INSERT, ostream *echo = NULL);
+
+private:
+
+    FILE         *input;        // The file being read; NULL if not opened
+    vector<char>  buffer;       // Characters read from the file
+    size_t        begin;        // Index in buffer of the first unread char
+    size_t        end;          // Index in buffer after the last char read
+    bool          exhausted;    // Whether a read has reached end of file
+
+/**---------------------- refill() --------------------------------------------
+ * Reads the next chunk of the file into the buffer. The unread characters are
+ * first moved to the front of the buffer, which is doubled if they fill it,
+ * so a token spanning chunks stays contiguous.
+ * @pre None.
+ * @post The unread characters begin at the front of the buffer, followed by
+ *       any characters just read.
+ * @return true if any characters were read; false at the end of the file.
+ */
+    bool refill(void);
+
+    // a loader owns its file
+    TreeLoader(const TreeLoader&);
+    TreeLoader& operator=(const TreeLoader&);
+
+}; // end TreeLoader
+
+
+#endif	/* _TREELOADER_H */